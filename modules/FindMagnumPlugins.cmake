@@ -140,6 +140,8 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
     elseif(_component STREQUAL StanfordSceneConverter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
+    elseif(_component STREQUAL StlImporter)
+        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
     elseif(_component STREQUAL TinyGltfImporter)
         # TODO remove when the deprecated plugin is gone
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
@@ -171,6 +173,10 @@ set(_MAGNUMPLUGINS_PLUGIN_COMPONENTS
     WebPImporter)
 # Nothing is enabled by default right now
 set(_MAGNUMPLUGINS_IMPLICITLY_ENABLED_COMPONENTS )
+# Plugins that link to Threads, needed for static builds
+set(_MAGNUMPLUGINS_THREADED_COMPONENTS
+    BasisImporter KtxImageConverter KtxImporter MeshOptimizerSceneConverter
+    StanfordSceneConverter StlImporter)
 
 # Inter-component dependencies
 set(_MAGNUMPLUGINS_HarfBuzzFont_DEPENDENCIES FreeTypeFont)
@@ -415,8 +421,9 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
                     INTERFACE_LINK_LIBRARIES ${JPEG_LIBRARIES})
             endif()
 
-        # KtxImageConverter has no dependencies
-        # KtxImporter has no dependencies
+        # KtxImageConverter has an optional Zstd dependency and KtxImporter
+        # optional Zstd and zlib dependencies, which are handled below once
+        # their configure.h is found
 
         # MeshOptimizerSceneConverter plugin dependencies
         elseif(_component STREQUAL MeshOptimizerSceneConverter)
@@ -508,6 +515,43 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             if(NOT _magnumPlugins${_component}_BUILD_STATIC EQUAL -1)
                 set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                     INTERFACE_SOURCES ${_MAGNUMPLUGINS_${_COMPONENT}_INCLUDE_DIR}/importStaticPlugin.cpp)
+
+                # KtxImporter optionally depends on Zstd and zlib, which a
+                # static build has to link to as well
+                if(_component STREQUAL KtxImporter)
+                    string(FIND "${_magnumPlugins${_component}Configure}" "#define MAGNUM_KTXIMPORTER_WITH_ZSTD" _magnumPlugins${_component}_WITH_ZSTD)
+                    if(NOT _magnumPlugins${_component}_WITH_ZSTD EQUAL -1)
+                        find_package(Zstd REQUIRED)
+                        set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                            INTERFACE_LINK_LIBRARIES Zstd::Zstd)
+                    endif()
+                    string(FIND "${_magnumPlugins${_component}Configure}" "#define MAGNUM_KTXIMPORTER_WITH_ZLIB" _magnumPlugins${_component}_WITH_ZLIB)
+                    if(NOT _magnumPlugins${_component}_WITH_ZLIB EQUAL -1)
+                        find_package(ZLIB REQUIRED)
+                        set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                            INTERFACE_LINK_LIBRARIES ZLIB::ZLIB)
+                    endif()
+                endif()
+
+                # KtxImageConverter optionally depends on Zstd as well
+                if(_component STREQUAL KtxImageConverter)
+                    string(FIND "${_magnumPlugins${_component}Configure}" "#define MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD" _magnumPlugins${_component}_WITH_ZSTD)
+                    if(NOT _magnumPlugins${_component}_WITH_ZSTD EQUAL -1)
+                        find_package(Zstd REQUIRED)
+                        set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                            INTERFACE_LINK_LIBRARIES Zstd::Zstd)
+                    endif()
+                endif()
+
+                # Plugins that process data on multiple threads link to
+                # Threads, which a static build has to link to as well. Not on
+                # Emscripten, where threading is enabled by compiler flags.
+                if(NOT CORRADE_TARGET_EMSCRIPTEN AND _component IN_LIST _MAGNUMPLUGINS_THREADED_COMPONENTS)
+                    set(THREADS_PREFER_PTHREAD_FLAG TRUE)
+                    find_package(Threads REQUIRED)
+                    set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                        INTERFACE_LINK_LIBRARIES Threads::Threads)
+                endif()
             endif()
         endif()
 
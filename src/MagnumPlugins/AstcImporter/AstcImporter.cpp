@@ -73,9 +73,12 @@ struct AstcImporter::State {
        a 3D format. */
     bool is3D;
     ImageFlags3D flags;
-    /* Needed because the data might be longer */
-    std::size_t dataSize;
+    /* Either the whole file if it was taken over, or just the block data if
+       it had to be copied */
     Containers::Array<char> data;
+    /* Block data without the header and any extra bytes at the end, points
+       into the above */
+    Containers::ArrayView<const char> blockData;
 };
 
 AstcImporter::AstcImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin) : AbstractImporter{manager, plugin} {}
@@ -199,17 +202,17 @@ void AstcImporter::doOpenData(Containers::Array<char>&& data, const DataFlags da
     /* Mark the image as 2D array if it's 3D but has a 2D format */
     if(_state->is3D && header.blockSize.z() == 1)
         _state->flags |= ImageFlag3D::Array;
-    _state->dataSize = dataSize;
 
-    /* Take over the existing array or copy the data if we can't. For
-       simplicity we copy it including the tiny header so we don't need to have
-       different handling based on whether the data was taken over or copied
-       later. */
+    /* Take over the existing array or copy the data if we can't. When
+       copying, only the block data are copied, without the header and any
+       trailing bytes. */
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
         _state->data = std::move(data);
+        _state->blockData = _state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + dataSize);
     } else {
-        _state->data = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, _state->data);
+        _state->data = Containers::Array<char>{NoInit, dataSize};
+        Utility::copy(data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + dataSize), _state->data);
+        _state->blockData = _state->data;
     }
 }
 
@@ -218,8 +221,13 @@ UnsignedInt AstcImporter::doImage2DCount() const {
 }
 
 Containers::Optional<ImageData2D> AstcImporter::doImage2D(UnsignedInt, UnsignedInt) {
-    Containers::Array<char> data{NoInit, _state->dataSize};
-    Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
+    /* The data never need any processing, so they can always be referenced
+       if desired */
+    if(configuration().value<bool>("referenceData"))
+        return ImageData2D{_state->format, _state->size.xy(), DataFlags{}, _state->blockData, ImageFlag2D(UnsignedShort(_state->flags))};
+
+    Containers::Array<char> data{NoInit, _state->blockData.size()};
+    Utility::copy(_state->blockData, data);
     return ImageData2D{_state->format, _state->size.xy(), std::move(data), ImageFlag2D(UnsignedShort(_state->flags))};
 }
 
@@ -228,8 +236,11 @@ UnsignedInt AstcImporter::doImage3DCount() const {
 }
 
 Containers::Optional<ImageData3D> AstcImporter::doImage3D(UnsignedInt, UnsignedInt) {
-    Containers::Array<char> data{NoInit, _state->dataSize};
-    Utility::copy(_state->data.slice(sizeof(AstcHeader), sizeof(AstcHeader) + _state->dataSize), data);
+    if(configuration().value<bool>("referenceData"))
+        return ImageData3D{_state->format, _state->size, DataFlags{}, _state->blockData, _state->flags};
+
+    Containers::Array<char> data{NoInit, _state->blockData.size()};
+    Utility::copy(_state->blockData, data);
     return ImageData3D{_state->format, _state->size, std::move(data), _state->flags};
 }
 
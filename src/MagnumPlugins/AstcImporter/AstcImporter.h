@@ -126,6 +126,20 @@ option enforces use of a 3D ASTC format), but other tools might.
     @cb{.ini} assumeYUpZBackward @ce @ref Trade-AstcImporter-configuration "configuration option"
     to assume the OpenGL coordinate system and silence the warning.
 
+@subsection Trade-AstcImporter-behavior-reference Referencing the file data
+
+As the block data are never processed in any way, the importer can avoid
+copying them on import. If the @cb{.ini} referenceData @ce
+@ref Trade-AstcImporter-configuration "configuration option" is enabled,
+@ref image2D() and @ref image3D() return a view on the data instead of a copy,
+with empty @ref ImageData::dataFlags(). That's the case for both 2D and 3D
+block formats as well as 2D array images. If the file was opened with
+@ref openFile() or @ref openData(), the view points to data owned by the
+importer and is valid until the file is closed. With @ref openMemory() the
+view points directly into the passed memory, which then has to stay in scope
+for as long as the image is used. That allows the data to be passed to a GPU
+upload without any intermediate copy.
+
 @section Trade-AstcImporter-configuration Plugin-specific configuration
 
 It's possible to tune various import options through @ref configuration(). See
@@ -37,6 +37,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/Test/referenceData.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -65,6 +67,7 @@ struct AstcImporterTest: TestSuite::Tester {
     void fileTooLong3D();
 
     void openMemory();
+    void referenceData();
     void openTwice();
     void importTwice();
 
@@ -155,6 +158,18 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    bool is3D;
+    bool memory;
+} ReferenceDataData[]{
+    {"2D", "8x8.astc", false, true},
+    {"3D", "3x3x3.astc", true, true},
+    {"2D array", "12x12-array-incomplete-blocks.astc", true, true},
+    {"3D, openData()", "3x3x3.astc", true, false},
+};
+
 AstcImporterTest::AstcImporterTest() {
     addTests({&AstcImporterTest::empty2D,
               &AstcImporterTest::empty3D,
@@ -183,6 +198,9 @@ AstcImporterTest::AstcImporterTest() {
     addInstancedTests({&AstcImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
+    addInstancedTests({&AstcImporterTest::referenceData},
+        Containers::arraySize(ReferenceDataData));
+
     addTests({&AstcImporterTest::openTwice,
               &AstcImporterTest::importTwice});
 
@@ -530,6 +548,57 @@ void AstcImporterTest::openMemory() {
     CORRADE_COMPARE(image->data()[1], '\x84');
 }
 
+void AstcImporterTest::referenceData() {
+    auto&& data = ReferenceDataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(ASTCIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
+    /* Suppress the orientation warning */
+    importer->configuration().setValue("assumeYUpZBackward", true);
+    if(data.memory)
+        CORRADE_VERIFY(importer->openMemory(*memory));
+    else
+        CORRADE_VERIFY(importer->openData(*memory));
+
+    /* Import a copy first to compare against */
+    Containers::Array<char> copy;
+    Containers::ArrayView<const char> view;
+    if(data.is3D) {
+        Containers::Optional<ImageData3D> image = importer->image3D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+        copy = image->release();
+
+        importer->configuration().setValue("referenceData", true);
+        image = importer->image3D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(image->isCompressed());
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        view = image->data();
+    } else {
+        Containers::Optional<ImageData2D> image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+        copy = image->release();
+
+        importer->configuration().setValue("referenceData", true);
+        image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(image->isCompressed());
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        view = image->data();
+    }
+    CORRADE_COMPARE_AS(view, copy,
+        TestSuite::Compare::Container);
+
+    /* With openMemory() the view points directly into the passed memory,
+       with openData() into a copy owned by the importer */
+    CORRADE_COMPARE(isViewOn(view, *memory), data.memory);
+}
+
 void AstcImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AstcImporter");
 
@@ -32,10 +32,12 @@
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Containers/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Format.h>
 #include <Corrade/Utility/Path.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/ImageView.h>
@@ -53,7 +55,16 @@ using namespace Containers::Literals;
 
 namespace {
 
-template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> convertLevelsToData(Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Utility::ConfigurationGroup& configuration, ImageConverterFlags flags, BasisImageConverter::Format fileFormat) {
+UnsignedInt threadCount(const Utility::ConfigurationGroup& configuration) {
+    UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+    if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if(threadCount == 0) threadCount = 1;
+    return threadCount;
+}
+
+/* Fills compressor parameters except for the job pool. Prints a message and
+   returns false if the input isn't valid. */
+template<UnsignedInt dimensions> bool fillParameters(basisu::basis_compressor_params& params, const Containers::StringView prefix, Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Utility::ConfigurationGroup& configuration, ImageConverterFlags flags, BasisImageConverter::Format fileFormat) {
     /* Check input */
     const PixelFormat pixelFormat = imageLevels.front().format();
     bool isSrgb;
@@ -71,17 +82,15 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
             isSrgb = true;
             break;
         default:
-            Error{} << "Trade::BasisImageConverter::convertToData(): unsupported format" << pixelFormat;
-            return {};
+            Error{} << prefix << "unsupported format" << pixelFormat;
+            return false;
     }
 
-    basisu::basis_compressor_params params;
-
     Math::Vector<dimensions, Int> mipMask{1};
     if(dimensions == 2) {
         if(ImageFlag2D(UnsignedShort(imageLevels[0].flags())) & ImageFlag2D::Array) {
-            Error{} << "Trade::BasisImageConverter::convertToData(): 1D array images are not supported by Basis Universal";
-            return {};
+            Error{} << prefix << "1D array images are not supported by Basis Universal";
+            return false;
         }
 
         params.m_tex_type = basist::basis_texture_type::cBASISTexType2D;
@@ -100,7 +109,7 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
            marked as a 2D array. */
         } else {
             if(!(flags & ImageFlag3D::Array)) {
-                Warning{} << "Trade::BasisImageConverter::convertToData(): exporting 3D image as a 2D array image";
+                Warning{} << prefix << "exporting 3D image as a 2D array image";
             }
 
             params.m_tex_type = basist::basis_texture_type::cBASISTexType2DArray;
@@ -113,9 +122,9 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     const UnsignedInt numMipmaps = Math::min<UnsignedInt>(imageLevels.size(), Math::log2((baseSize*mipMask).max()) + 1);
 
     if(imageLevels.size() > numMipmaps) {
-        Error{} << "Trade::BasisImageConverter::convertToData(): there can be only" << numMipmaps <<
+        Error{} << prefix << "there can be only" << numMipmaps <<
             "levels with base image size" << baseSize << "but got" << imageLevels.size();
-        return {};
+        return false;
     }
 
     if(fileFormat == BasisImageConverter::Format::Ktx)
@@ -154,14 +163,14 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     const auto swizzle = configuration.value<Containers::StringView>("swizzle");
     if(swizzle) {
         if(swizzle.size() != 4) {
-            Error{} << "Trade::BasisImageConverter::convertToData(): invalid swizzle length, expected 4 but got" << swizzle.size();
-            return {};
+            Error{} << prefix << "invalid swizzle length, expected 4 but got" << swizzle.size();
+            return false;
         }
 
         /** @todo clean up once StringView has findAnyNotOf() or some such */
         if(std::string{swizzle}.find_first_not_of("rgba") != std::string::npos) {
-            Error{} << "Trade::BasisImageConverter::convertToData(): invalid characters in swizzle" << swizzle;
-            return {};
+            Error{} << prefix << "invalid characters in swizzle" << swizzle;
+            return false;
         }
 
         for(std::size_t i = 0; i != 4; ++i) {
@@ -180,12 +189,8 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     PARAM_CONFIG(resample_height, int);
     PARAM_CONFIG(resample_factor, float);
 
-    UnsignedInt threadCount = configuration.value<Int>("threads");
-    if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
-    const bool multithreading = threadCount > 1;
+    const bool multithreading = threadCount(configuration) > 1;
     params.m_multithreading = multithreading;
-    basisu::job_pool jpool{threadCount};
-    params.m_pJob_pool = &jpool;
 
     PARAM_CONFIG(disable_hierarchical_endpoint_codebooks, bool);
 
@@ -200,7 +205,7 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     PARAM_CONFIG(mip_smallest_dimension, int);
 
     if(params.m_mip_gen && numMipmaps > 1) {
-        Warning{} << "Trade::BasisImageConverter::convertToData(): found user-supplied mip levels, ignoring mip_gen config value";
+        Warning{} << prefix << "found user-supplied mip levels, ignoring mip_gen config value";
         params.m_mip_gen = false;
     }
 
@@ -273,9 +278,8 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
         const auto mipSize = Math::max(baseSize >> level, 1)*mipMask + baseSize*(Math::Vector<dimensions, Int>{1} - mipMask);
         const auto& image = imageLevels[level];
         if(image.size() != mipSize) {
-            Error{} << "Trade::BasisImageConverter::convertToData(): expected "
-                "size" << mipSize << "for level" << level << "but got" << image.size();
-            return {};
+            Error{} << prefix << "expected size" << mipSize << "for level" << level << "but got" << image.size();
+            return false;
         }
 
         /* Always get a 3D view to generalize indexing for 2D and 3D images */
@@ -339,39 +343,34 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
         }
     }
 
-    basisu::basis_compressor basis;
-    basis.init(params);
+    return true;
+}
 
-    const basisu::basis_compressor::error_code errorCode = basis.process();
-    if(errorCode != basisu::basis_compressor::error_code::cECSuccess) switch(errorCode) {
+/* Returns nullptr on success */
+const char* compressorErrorMessage(const basisu::basis_compressor::error_code errorCode) {
+    switch(errorCode) {
+        case basisu::basis_compressor::error_code::cECSuccess:
+            return nullptr;
         case basisu::basis_compressor::error_code::cECFailedReadingSourceImages:
             /* Emitted e.g. when source image is 0-size */
-            Error{} << "Trade::BasisImageConverter::convertToData(): source image is invalid";
-            return {};
+            return "source image is invalid";
         case basisu::basis_compressor::error_code::cECFailedValidating:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): type constraint validation failed";
-            return {};
+            return "type constraint validation failed";
         case basisu::basis_compressor::error_code::cECFailedEncodeUASTC:
-            Error{} << "Trade::BasisImageConverter::convertToData(): UASTC encoding failed";
-            return {};
+            return "UASTC encoding failed";
         case basisu::basis_compressor::error_code::cECFailedFrontEnd:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): frontend processing failed";
-            return {};
+            return "frontend processing failed";
         case basisu::basis_compressor::error_code::cECFailedBackend:
-            Error{} << "Trade::BasisImageConverter::convertToData(): encoding failed";
-            return {};
+            return "encoding failed";
         case basisu::basis_compressor::error_code::cECFailedCreateBasisFile:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::convertToData(): assembling basis file data or transcoding failed";
-            return {};
+            return "assembling basis file data or transcoding failed";
         case basisu::basis_compressor::error_code::cECFailedUASTCRDOPostProcess:
-            Error{} << "Trade::BasisImageConverter::convertToData(): UASTC RDO postprocessing failed";
-            return {};
+            return "UASTC RDO postprocessing failed";
         case basisu::basis_compressor::error_code::cECFailedCreateKTX2File:
-            Error{} << "Trade::BasisImageConverter::convertToData(): assembling KTX2 file failed";
-            return {};
+            return "assembling KTX2 file failed";
 
         /* LCOV_EXCL_START */
         case basisu::basis_compressor::error_code::cECFailedFontendExtract:
@@ -382,6 +381,23 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
             CORRADE_INTERNAL_ASSERT_UNREACHABLE();
         /* LCOV_EXCL_STOP */
     }
+}
+
+struct Compressed {
+    basisu::basis_compressor::error_code errorCode;
+    Containers::Array<char> data;
+    bool srgbPatchedAway;
+};
+
+/* Gets called from worker threads in convertBatchToData(), so it doesn't
+   print anything on its own */
+Compressed compress(const basisu::basis_compressor_params& params) {
+    basisu::basis_compressor basis;
+    basis.init(params);
+
+    const basisu::basis_compressor::error_code errorCode = basis.process();
+    if(errorCode != basisu::basis_compressor::error_code::cECSuccess)
+        return {errorCode, {}, false};
 
     const basisu::uint8_vec& out = params.m_create_ktx2_file ? basis.get_output_ktx2_file() : basis.get_output_basis_file();
 
@@ -391,38 +407,72 @@ template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> c
     /* UASTC output in a Basis container has the sRGB flag set always, patch it
        away if the data is not sRGB. Doesn't happen with ETC1S and doesn't
        happen with the KTX container either. */
+    bool srgbPatchedAway = false;
     if(!params.m_create_ktx2_file) {
         auto& header = *reinterpret_cast<basist::basis_file_header*>(fileData.data());
         if(!params.m_perceptual && (header.m_flags & basist::basis_header_flags::cBASISHeaderFlagSRGB)) {
-            if(flags & ImageConverterFlag::Verbose) Debug{} <<
-                "Trade::BasisImageConverter::convertToData(): patching away an incorrect sRGB flag in the output Basis file";
             header.m_flags = header.m_flags & ~basist::basis_header_flags::cBASISHeaderFlagSRGB;
             header.m_header_crc16 = basist::crc16(&header.m_data_size, sizeof(basist::basis_file_header) - offsetof(basist::basis_file_header, m_data_size), 0);
+            srgbPatchedAway = true;
         }
     }
 
+    return {errorCode, std::move(fileData), srgbPatchedAway};
+}
+
+/* Prints messages for the compress() result, returns the data on success */
+Containers::Optional<Containers::Array<char>> compressedData(Compressed&& compressed, const Containers::StringView prefix, const ImageConverterFlags flags) {
+    if(const char* const message = compressorErrorMessage(compressed.errorCode)) {
+        Error{} << prefix << message;
+        return {};
+    }
+
+    if(compressed.srgbPatchedAway && (flags & ImageConverterFlag::Verbose))
+        Debug{} << prefix << "patching away an incorrect sRGB flag in the output Basis file";
+
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(std::move(fileData));
+    return Containers::optional(std::move(compressed.data));
 }
 
 }
 
+struct BasisImageConverter::State {
+    /* Returns a job pool with given thread count. It's kept across
+       conversions so the threads don't need to be created again for every
+       image, and is recreated only if the thread count changes. */
+    basisu::job_pool& jobPool(UnsignedInt threadCount) {
+        if(!_jobPool || _jobPoolThreadCount != threadCount) {
+            /* Join the previous threads first */
+            _jobPool = nullptr;
+            _jobPool.emplace(threadCount);
+            _jobPoolThreadCount = threadCount;
+        }
+        return *_jobPool;
+    }
+
+    private:
+        Containers::Pointer<basisu::job_pool> _jobPool;
+        UnsignedInt _jobPoolThreadCount = 0;
+};
+
 void BasisImageConverter::initialize() {
     basisu::basisu_encoder_init();
 }
 
-BasisImageConverter::BasisImageConverter(Format format): _format{format} {
+BasisImageConverter::BasisImageConverter(Format format): _format{format}, _state{InPlaceInit} {
     /* Passing an invalid Format enum is user error, we'll assert on that in
        the convertToData() function */
 }
 
-BasisImageConverter::BasisImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin} {
+BasisImageConverter::BasisImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImageConverter{manager, plugin}, _state{InPlaceInit} {
     if(plugin == "BasisKtxImageConverter"_s)
         _format = Format::Ktx;
     else
         _format = {}; /* Overridable by openFile() */
 }
 
+BasisImageConverter::~BasisImageConverter() = default;
+
 ImageConverterFeatures BasisImageConverter::doFeatures() const {
     return ImageConverterFeature::Convert2DToData|
            ImageConverterFeature::Convert3DToData|
@@ -441,12 +491,82 @@ Containers::String BasisImageConverter::doMimeType() const {
     return {};
 }
 
+template<UnsignedInt dimensions> Containers::Optional<Containers::Array<char>> BasisImageConverter::convertLevelsToData(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels) {
+    constexpr Containers::StringView prefix = "Trade::BasisImageConverter::convertToData():"_s;
+
+    basisu::basis_compressor_params params;
+    if(!fillParameters(params, prefix, imageLevels, configuration(), flags(), _format))
+        return {};
+
+    params.m_pJob_pool = &_state->jobPool(threadCount(configuration()));
+    return compressedData(compress(params), prefix, flags());
+}
+
 Containers::Optional<Containers::Array<char>> BasisImageConverter::doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) {
-    return convertLevelsToData(imageLevels, configuration(), flags(), _format);
+    return convertLevelsToData(imageLevels);
 }
 
 Containers::Optional<Containers::Array<char>> BasisImageConverter::doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) {
-    return convertLevelsToData(imageLevels, configuration(), flags(), _format);
+    return convertLevelsToData(imageLevels);
+}
+
+template<UnsignedInt dimensions> Containers::Array<Containers::Optional<Containers::Array<char>>> BasisImageConverter::convertBatchToDataInternal(const Containers::ArrayView<const BasicImageView<dimensions>> images) {
+    Containers::Array<Containers::Optional<Containers::Array<char>>> out{images.size()};
+
+    /* The images are processed in chunks of twice the thread count, which
+       gives the pool enough work to balance images of different sizes while
+       keeping only a bounded number of copies of the input in basisu images
+       at a time, independently of the batch size */
+    const UnsignedInt threads = threadCount(configuration());
+    const std::size_t chunkSize = 2*threads;
+    basisu::job_pool& jobPool = _state->jobPool(threads);
+    Containers::Array<Containers::String> prefixes{chunkSize};
+    Containers::Array<Compressed> compressed{chunkSize};
+    Containers::Array<bool> valid{NoInit, chunkSize};
+    for(std::size_t chunkOffset = 0; chunkOffset < images.size(); chunkOffset += chunkSize) {
+        const std::size_t count = Math::min(chunkSize, images.size() - chunkOffset);
+
+        /* Fill the parameters on the calling thread, so the messages get
+           printed to the place the user redirected them to. Each image is
+           compressed single-threaded, the parallelism is across the images
+           instead. */
+        Containers::Array<basisu::basis_compressor_params> params{count};
+        for(std::size_t i = 0; i != count; ++i) {
+            const std::size_t id = chunkOffset + i;
+            prefixes[i] = Utility::format("Trade::BasisImageConverter::convertBatchToData(): image {}:", id);
+            valid[i] = fillParameters(params[i], prefixes[i], images.slice(id, id + 1), configuration(), flags(), _format);
+            params[i].m_multithreading = false;
+            params[i].m_rdo_uastc_multithreading = false;
+        }
+
+        /* The compressors wait for all jobs in their job pool to finish,
+           which would deadlock if they shared the pool they're running on.
+           Give each one a pool without any extra threads instead, which runs
+           the jobs on the thread that waits for them. */
+        for(std::size_t i = 0; i != count; ++i) {
+            if(!valid[i]) continue;
+            jobPool.add_job([&params, &compressed, i]() {
+                basisu::job_pool singleThreadedJobPool{1};
+                params[i].m_pJob_pool = &singleThreadedJobPool;
+                compressed[i] = compress(params[i]);
+                params[i].m_pJob_pool = nullptr;
+            });
+        }
+        jobPool.wait_for_all();
+
+        for(std::size_t i = 0; i != count; ++i)
+            if(valid[i]) out[chunkOffset + i] = compressedData(std::move(compressed[i]), prefixes[i], flags());
+    }
+
+    return out;
+}
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> BasisImageConverter::doConvertBatchToData(const Containers::ArrayView<const ImageView2D> images) {
+    return convertBatchToDataInternal(images);
+}
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> BasisImageConverter::doConvertBatchToData(const Containers::ArrayView<const ImageView3D> images) {
+    return convertBatchToDataInternal(images);
 }
 
 template<UnsignedInt dimensions> bool BasisImageConverter::convertLevelsToFile(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels, const Containers::StringView filename) {
@@ -32,6 +32,9 @@
  * @m_since_{plugins,2019,10}
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "MagnumPlugins/BasisImageConverter/configure.h"
@@ -199,6 +202,41 @@ find_package(Threads REQUIRED)
 target_link_libraries(your-application PRIVATE Threads::Threads)
 @endcode
 
+@subsection Trade-BasisImageConverter-behavior-batch Batch conversion
+
+With the @cb{.ini} threads @ce @ref Trade-BasisImageConverter-configuration "configuration option"
+set to something else than `1`, the worker threads are created on the first
+conversion and kept alive for subsequent conversions done with the same
+converter instance and the same thread count, instead of being spawned and
+joined for every image. A single image however benefits from the threads only
+in some stages of the compression, and for small images the overhead can
+outweigh the gains.
+
+When converting many independent images, such as all textures of a scene,
+@ref convertBatchToData() is a better option --- it compresses each image on
+a single thread and distributes the images over the thread pool, producing
+the same output as calling @ref convertToData() with each image separately
+and @cb{.ini} threads @ce set to `1`. With more threads,
+@ref convertToData() compresses UASTC images with
+@cb{.ini} rdo_uastc @ce enabled in independent parts, so its output differs
+in that case. Each image is taken as a single level, mip levels can be
+generated with the @cb{.ini} mip_gen @ce option. The images are prepared for
+compression in chunks of twice the thread count, so the memory use doesn't
+grow with the batch size. Errors are reported for each image with its index,
+and a failure of one image doesn't affect conversion of the others. As the function isn't a part of the
+@ref AbstractImageConverter interface, with a plugin manager you need to
+@cpp static_cast @ce the instance to @ref BasisImageConverter to call it:
+
+@code{.cpp}
+PluginManager::Manager<Trade::AbstractImageConverter> manager;
+Containers::Pointer<Trade::AbstractImageConverter> converter =
+    manager.loadAndInstantiate("BasisImageConverter");
+converter->configuration().setValue("threads", 0);
+
+Containers::Array<Containers::Optional<Containers::Array<char>>> data =
+    static_cast<Trade::BasisImageConverter&>(*converter).convertBatchToData(images);
+@endcode
+
 @subsection Trade-BasisImageConverter-behavior-multithreading Thread safety
 
 While the encoder library *should* behave in a way that doesn't modify any
@@ -259,11 +297,45 @@ class MAGNUM_BASISIMAGECONVERTER_EXPORT BasisImageConverter: public AbstractImag
         /** @brief Plugin manager constructor */
         explicit BasisImageConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin);
 
+        ~BasisImageConverter();
+
+        /**
+         * @brief Convert multiple independent 2D images to data
+         * @m_since_latest_{plugins}
+         *
+         * Produces the same output as calling @ref convertToData() with each
+         * image separately and @cb{.ini} threads @ce set to @cpp 1 @ce, but
+         * compresses the images in parallel, each on a single thread, with
+         * the thread count given by the
+         * @cb{.ini} threads @ce @ref Trade-BasisImageConverter-configuration "configuration option".
+         * Images that fail to convert have a @relativeref{Corrade,Containers::NullOpt}
+         * on their position in the returned array. See
+         * @ref Trade-BasisImageConverter-behavior-batch for more information.
+         */
+        Containers::Array<Containers::Optional<Containers::Array<char>>> convertBatchToData(Containers::ArrayView<const ImageView2D> images) {
+            return doConvertBatchToData(images);
+        }
+
+        /**
+         * @brief Convert multiple independent 3D images to data
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref convertBatchToData(Containers::ArrayView<const ImageView2D>),
+         * but for 2D array images and cube maps.
+         */
+        Containers::Array<Containers::Optional<Containers::Array<char>>> convertBatchToData(Containers::ArrayView<const ImageView3D> images) {
+            return doConvertBatchToData(images);
+        }
+
     private:
+        struct State;
+
         MAGNUM_BASISIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::String doExtension() const override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::String doMimeType() const override;
 
+        template<UnsignedInt dimensions> MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> convertLevelsToData(const Containers::ArrayView<const BasicImageView<dimensions>> imageLevels);
+
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView2D> imageLevels) override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(Containers::ArrayView<const ImageView3D> imageLevels) override;
 
@@ -272,7 +344,15 @@ class MAGNUM_BASISIMAGECONVERTER_EXPORT BasisImageConverter: public AbstractImag
         MAGNUM_BASISIMAGECONVERTER_LOCAL bool doConvertToFile(const Containers::ArrayView<const ImageView2D> imageLevels, const Containers::StringView filename) override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL bool doConvertToFile(const Containers::ArrayView<const ImageView3D> imageLevels, const Containers::StringView filename) override;
 
+        template<UnsignedInt dimensions> MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Array<Containers::Optional<Containers::Array<char>>> convertBatchToDataInternal(const Containers::ArrayView<const BasicImageView<dimensions>> images);
+
+        /* Virtual so the batch conversion can be called on instances created
+           by a plugin manager without having to link to the plugin */
+        MAGNUM_BASISIMAGECONVERTER_LOCAL virtual Containers::Array<Containers::Optional<Containers::Array<char>>> doConvertBatchToData(Containers::ArrayView<const ImageView2D> images);
+        MAGNUM_BASISIMAGECONVERTER_LOCAL virtual Containers::Array<Containers::Optional<Containers::Array<char>>> doConvertBatchToData(Containers::ArrayView<const ImageView3D> images);
+
         Format _format;
+        Containers::Pointer<State> _state;
 };
 
 }}
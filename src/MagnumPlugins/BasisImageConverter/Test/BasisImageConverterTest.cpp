@@ -50,6 +50,8 @@
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/TextureData.h>
 
+#include "MagnumPlugins/BasisImageConverter/BasisImageConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -87,6 +89,13 @@ struct BasisImageConverterTest: TestSuite::Tester {
     void convertToFile3D();
 
     void threads();
+    void threadsReuse();
+
+    void convertBatch();
+    void convertBatch3D();
+    void convertBatchUastcRdo();
+    void convertBatchInvalidImage();
+
     void ktx();
     void swizzle();
 
@@ -322,6 +331,15 @@ BasisImageConverterTest::BasisImageConverterTest() {
     addInstancedTests({&BasisImageConverterTest::threads},
         Containers::arraySize(ThreadsData));
 
+    addTests({&BasisImageConverterTest::threadsReuse});
+
+    addInstancedTests({&BasisImageConverterTest::convertBatch,
+                       &BasisImageConverterTest::convertBatch3D,
+                       &BasisImageConverterTest::convertBatchUastcRdo},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&BasisImageConverterTest::convertBatchInvalidImage});
+
     addInstancedTests({&BasisImageConverterTest::ktx},
         Containers::arraySize(FlippedData));
 
@@ -1322,6 +1340,170 @@ void BasisImageConverterTest::threads() {
         (DebugTools::CompareImageToFile{_manager, 97.25f, 7.914f}));
 }
 
+void BasisImageConverterTest::threadsReuse() {
+    Color4ub pixels[16*16];
+    for(std::size_t i = 0; i != Containers::arraySize(pixels); ++i)
+        pixels[i] = Color4ub{UnsignedByte(i), UnsignedByte(i*3), UnsignedByte(255 - i), 255};
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {16, 16}, pixels};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    Containers::Optional<Containers::Array<char>> expected = converter->convertToData(image);
+    CORRADE_VERIFY(expected);
+
+    /* Converting repeatedly with the pool kept across the calls, and then
+       with a different thread count which recreates it, should give the same
+       output as without threads */
+    converter->configuration().setValue("threads", 2);
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Containers::Array<char>> compressedData = converter->convertToData(image);
+        CORRADE_VERIFY(compressedData);
+        CORRADE_COMPARE_AS(*compressedData, *expected,
+            TestSuite::Compare::Container);
+    }
+
+    converter->configuration().setValue("threads", 3);
+    Containers::Optional<Containers::Array<char>> compressedData = converter->convertToData(image);
+    CORRADE_VERIFY(compressedData);
+    CORRADE_COMPARE_AS(*compressedData, *expected,
+        TestSuite::Compare::Container);
+}
+
+void BasisImageConverterTest::convertBatch() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Images of different sizes and contents, one with mip levels generated
+       by the encoder */
+    Color4ub pixels[3][16*16];
+    for(std::size_t image = 0; image != 3; ++image)
+        for(std::size_t i = 0; i != 16*16; ++i)
+            pixels[image][i] = Color4ub{UnsignedByte(i*(image + 1)), UnsignedByte(i*3), UnsignedByte(255 - i), UnsignedByte(255 - image*64)};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[0]},
+        {PixelFormat::RGBA8Unorm, {8, 4}, pixels[1]},
+        {PixelFormat::RGBA8Unorm, {16, 8}, pixels[2]},
+    };
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("mip_gen", true);
+
+    /* Expected output is the same as converting each image separately */
+    Containers::Optional<Containers::Array<char>> expected[3];
+    for(std::size_t i = 0; i != 3; ++i) {
+        expected[i] = converter->convertToData(images[i]);
+        CORRADE_VERIFY(expected[i]);
+    }
+
+    if(data.threads) converter->configuration().setValue("threads", data.threads);
+    Containers::Array<Containers::Optional<Containers::Array<char>>> compressedData = static_cast<BasisImageConverter&>(*converter).convertBatchToData(images);
+    CORRADE_COMPARE(compressedData.size(), 3);
+    for(std::size_t i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(compressedData[i]);
+        CORRADE_COMPARE_AS(*compressedData[i], *expected[i],
+            TestSuite::Compare::Container);
+    }
+}
+
+void BasisImageConverterTest::convertBatch3D() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Color4ub pixels[2][8*8*6];
+    for(std::size_t image = 0; image != 2; ++image)
+        for(std::size_t i = 0; i != 8*8*6; ++i)
+            pixels[image][i] = Color4ub{UnsignedByte(i*(image + 1)), UnsignedByte(i*3), UnsignedByte(255 - i), 255};
+    const ImageView3D images[]{
+        {PixelFormat::RGBA8Unorm, {8, 8, 3}, pixels[0], ImageFlag3D::Array},
+        {PixelFormat::RGBA8Unorm, {8, 8, 6}, pixels[1], ImageFlag3D::CubeMap},
+    };
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+
+    Containers::Optional<Containers::Array<char>> expected[2];
+    for(std::size_t i = 0; i != 2; ++i) {
+        expected[i] = converter->convertToData(images[i]);
+        CORRADE_VERIFY(expected[i]);
+    }
+
+    if(data.threads) converter->configuration().setValue("threads", data.threads);
+    Containers::Array<Containers::Optional<Containers::Array<char>>> compressedData = static_cast<BasisImageConverter&>(*converter).convertBatchToData(images);
+    CORRADE_COMPARE(compressedData.size(), 2);
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(compressedData[i]);
+        CORRADE_COMPARE_AS(*compressedData[i], *expected[i],
+            TestSuite::Compare::Container);
+    }
+}
+
+void BasisImageConverterTest::convertBatchUastcRdo() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* More images than fits into a single chunk with two threads */
+    Color4ub pixels[5][16*16];
+    for(std::size_t image = 0; image != 5; ++image)
+        for(std::size_t i = 0; i != 16*16; ++i)
+            pixels[image][i] = Color4ub{UnsignedByte(i*(image + 1)), UnsignedByte(i*3), UnsignedByte(255 - i), UnsignedByte(255 - image*32)};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[0]},
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[1]},
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[2]},
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[3]},
+        {PixelFormat::RGBA8Unorm, {16, 16}, pixels[4]},
+    };
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("uastc", true);
+    converter->configuration().setValue("rdo_uastc", true);
+
+    /* Multithreaded RDO processes the image in independent parts, so the
+       output is the same only as a single-threaded conversion */
+    Containers::Optional<Containers::Array<char>> expected[5];
+    for(std::size_t i = 0; i != 5; ++i) {
+        expected[i] = converter->convertToData(images[i]);
+        CORRADE_VERIFY(expected[i]);
+    }
+
+    if(data.threads) converter->configuration().setValue("threads", data.threads);
+    Containers::Array<Containers::Optional<Containers::Array<char>>> compressedData = static_cast<BasisImageConverter&>(*converter).convertBatchToData(images);
+    CORRADE_COMPARE(compressedData.size(), 5);
+    for(std::size_t i = 0; i != 5; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(compressedData[i]);
+        CORRADE_COMPARE_AS(*compressedData[i], *expected[i],
+            TestSuite::Compare::Container);
+    }
+}
+
+void BasisImageConverterTest::convertBatchInvalidImage() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("threads", 2);
+
+    const char bytes[16*4]{};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {4, 4}, bytes},
+        {PixelFormat::RG32F, {2, 2}, bytes},
+        {PixelFormat::RGBA8Unorm, {4, 4}, bytes},
+    };
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Containers::Array<char>>> compressedData;
+    {
+        Error redirectError{&out};
+        compressedData = static_cast<BasisImageConverter&>(*converter).convertBatchToData(images);
+    }
+    CORRADE_COMPARE(compressedData.size(), 3);
+    /* The failure doesn't affect the other images */
+    CORRADE_VERIFY(compressedData[0]);
+    CORRADE_VERIFY(!compressedData[1]);
+    CORRADE_VERIFY(compressedData[2]);
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImageConverter::convertBatchToData(): image 1: unsupported format PixelFormat::RG32F\n");
+}
+
 void BasisImageConverterTest::ktx() {
     auto&& data = FlippedData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
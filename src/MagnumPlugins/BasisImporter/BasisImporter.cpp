@@ -27,11 +27,18 @@
 
 #include "BasisImporter.h"
 
+#include <atomic>
+#include <thread>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/ConfigurationValue.h>
 #include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Format.h>
+#include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
@@ -105,6 +112,26 @@ constexpr const char* FormatNames[]{
 /* Last element has to be on the same index as last enum value */
 static_assert(Containers::arraySize(FormatNames) - 1 == Int(BasisImporter::TargetFormat::EacRG), "bad string format mapping");
 
+/* Size and output buffer parameters of a single transcoded level */
+struct LevelLayout {
+    Vector2ui size;
+    UnsignedInt rowStride;
+    UnsignedInt outputRowsInPixels;
+    UnsignedInt outputSizeInBlocksOrPixels;
+    /* Size of a single layer or face in bytes */
+    UnsignedInt sliceSize;
+    bool isIFrame;
+};
+
+/* Transcoders keep scratch buffers and the previous video frame in a state
+   object, transcoding on multiple threads at once needs one for each thread */
+struct TranscoderState {
+    basist::basisu_transcoder_state basis;
+    #if BASISD_SUPPORT_KTX2
+    basist::ktx2_transcoder_state ktx2;
+    #endif
+};
+
 }
 
 }}
@@ -167,6 +194,21 @@ struct BasisImporter::State {
     bool noTranscodeFormatWarningPrinted = false;
     UnsignedInt lastTranscodedImageId = ~0u;
 
+    /* Levels transcoded ahead of time with multithreading enabled, for given
+       image and target format. Empty if not transcoded yet, already imported
+       or if the transcoding failed. */
+    UnsignedInt transcodedImageId = ~0u;
+    TargetFormat transcodedFormat;
+    Containers::Array<Containers::Array<char>> transcodedLevels;
+
+    /* SHA-1 of the input data together with the transcoder version,
+       calculated on first access to the transcoded image cache */
+    Containers::String cacheKey;
+    /* Total size of all files in the cache directory. Calculated on the first
+       cache write with a size limit set and then updated with each write, so
+       the directory isn't listed again for every transcoded level. */
+    Containers::Optional<std::size_t> cacheSize;
+
     explicit State(): codebook(basist::g_global_selector_cb_size,
         basist::g_global_selector_cb) {}
 };
@@ -214,6 +256,10 @@ void BasisImporter::doClose() {
     _state->ktx2Transcoder = Containers::NullOpt;
     #endif
     _state->in = nullptr;
+    _state->transcodedImageId = ~0u;
+    _state->transcodedLevels = nullptr;
+    _state->cacheKey = {};
+    _state->cacheSize = Containers::NullOpt;
 }
 
 void BasisImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) {
@@ -511,55 +557,71 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
         return Containers::NullOpt;
     }
 
-    UnsignedInt origWidth, origHeight, totalBlocks, numFaces;
-    bool isIFrame;
-    #if BASISD_SUPPORT_KTX2
-    if(_state->ktx2Transcoder) {
-        basist::ktx2_image_level_info levelInfo;
-        /* Header validation etc. is already done in doOpenData() and id is
-           bounds-checked against doImage2DCount() by AbstractImporter, so by
-           looking at the code there's nothing else that could fail and wasn't
-           already caught before. That means we also can't craft any file to
-           cover an error path, so turning this into an assert. When this blows
-           up for someome, we'd most probably need to harden doOpenData() to
-           catch that, not turning this into a graceful error.
-
-           For independent images and videos we use the correct layer. For
-           images as slices, they're all the same size, (checked in
-           doOpenData()) and isIFrame is not used, so any layer or face works. */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(_state->ktx2Transcoder->get_image_level_info(levelInfo, level, id, 0));
-
-        origWidth = levelInfo.m_orig_width;
-        origHeight = levelInfo.m_orig_height;
-        totalBlocks = levelInfo.m_total_blocks;
-        /* m_iframe_flag is always false for UASTC video:
-           https://github.com/BinomialLLC/basis_universal/issues/259
-           However, it's safe to assume the first frame is always an I-frame. */
-        isIFrame = levelInfo.m_iframe_flag || id == 0;
-
-        numFaces = _state->ktx2Transcoder->get_faces();
-    } else
-    #endif
-    {
-        /* See comment right above */
-        basist::basisu_image_level_info levelInfo;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(_state->basisTranscoder->get_image_level_info(_state->in.data(), _state->in.size(), levelInfo, id, level));
-
-        origWidth = levelInfo.m_orig_width;
-        origHeight = levelInfo.m_orig_height;
-        totalBlocks = levelInfo.m_total_blocks;
-        isIFrame = levelInfo.m_iframe_flag;
+    /* For KTX2 files the cube map flag is set only if the face count is not
+       1, and the face count can only be 1 or 6 */
+    const UnsignedInt numFaces = _state->imageFlags & ImageFlag3D::CubeMap ? 6 : 1;
+    const UnsignedInt numSlices = _state->numSlices;
+
+    auto levelLayout = [&](const UnsignedInt levelId) {
+        LevelLayout layout;
+        UnsignedInt totalBlocks;
+        #if BASISD_SUPPORT_KTX2
+        if(_state->ktx2Transcoder) {
+            basist::ktx2_image_level_info levelInfo;
+            /* Header validation etc. is already done in doOpenData() and id is
+               bounds-checked against doImage2DCount() by AbstractImporter, so
+               by looking at the code there's nothing else that could fail and
+               wasn't already caught before. That means we also can't craft
+               any file to cover an error path, so turning this into an
+               assert. When this blows up for someome, we'd most probably need
+               to harden doOpenData() to catch that, not turning this into a
+               graceful error.
+
+               For independent images and videos we use the correct layer.
+               For images as slices, they're all the same size, (checked in
+               doOpenData()) and isIFrame is not used, so any layer or face
+               works. */
+            CORRADE_INTERNAL_ASSERT_OUTPUT(_state->ktx2Transcoder->get_image_level_info(levelInfo, levelId, id, 0));
+
+            layout.size = {levelInfo.m_orig_width, levelInfo.m_orig_height};
+            totalBlocks = levelInfo.m_total_blocks;
+            /* m_iframe_flag is always false for UASTC video:
+               https://github.com/BinomialLLC/basis_universal/issues/259
+               However, it's safe to assume the first frame is always an
+               I-frame. */
+            layout.isIFrame = levelInfo.m_iframe_flag || id == 0;
+        } else
+        #endif
+        {
+            /* See comment right above */
+            basist::basisu_image_level_info levelInfo;
+            CORRADE_INTERNAL_ASSERT_OUTPUT(_state->basisTranscoder->get_image_level_info(_state->in.data(), _state->in.size(), levelInfo, id, levelId));
+
+            layout.size = {levelInfo.m_orig_width, levelInfo.m_orig_height};
+            totalBlocks = levelInfo.m_total_blocks;
+            layout.isIFrame = levelInfo.m_iframe_flag;
+        }
 
-        numFaces = _state->imageFlags & ImageFlag3D::CubeMap ? 6 : 1;
-    }
+        if(isUncompressed) {
+            layout.rowStride = layout.size.x();
+            layout.outputRowsInPixels = layout.size.y();
+            layout.outputSizeInBlocksOrPixels = layout.size.x()*layout.size.y();
+        } else {
+            layout.rowStride = 0; /* left up to Basis to calculate */
+            layout.outputRowsInPixels = 0; /* not used for compressed data */
+            layout.outputSizeInBlocksOrPixels = totalBlocks;
+        }
+        layout.sliceSize = basis_get_bytes_per_block_or_pixel(format)*layout.outputSizeInBlocksOrPixels;
+        return layout;
+    };
 
-    const UnsignedInt numLayers = _state->numSlices/numFaces;
+    const LevelLayout layout = levelLayout(level);
 
     /* basisu doesn't allow seeking to arbitrary video frames. If this isn't an
        I-frame, only allow transcoding the frame following the last P-frame. */
     if(_state->isVideo) {
         const UnsignedInt expectedImageId = _state->lastTranscodedImageId + 1;
-        if(!isIFrame && id != expectedImageId) {
+        if(!layout.isIFrame && id != expectedImageId) {
             Error{} << prefix << "video frames must be transcoded sequentially, expected frame"
                 << expectedImageId << (expectedImageId == 0 ? "but got" : "or 0 but got") << id;
             return Containers::NullOpt;
@@ -567,61 +629,195 @@ template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> Bas
         _state->lastTranscodedImageId = id;
     }
 
-    /* No flags used by transcode_image_level() by default */
-    const std::uint32_t flags = 0;
-    if(!_state->isYFlipped) {
+    const Vector3ui size{layout.size, numSlices};
+    const ImageFlags<dimensions> imageFlags = ImageFlag<dimensions>(UnsignedShort(_state->imageFlags));
+
+    /* Video P-frames are transcoded relative to the previous frame, which is
+       remembered only in the transcoders' internal state, so videos are
+       always transcoded on a single thread */
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    /* Without pthreads there's no way to spawn threads */
+    threadCount = 1;
+    #else
+    if(!threadCount) threadCount = std::thread::hardware_concurrency();
+    if(!threadCount || _state->isVideo) threadCount = 1;
+    #endif
+
+    /* Transcoded images are cached on disk under a name derived from the
+       file contents, transcoder version, image, level and target format. The
+       version is there because a different transcoder may produce different
+       output for the same input. Videos aren't cached, as a P-frame can be
+       transcoded only right after the previous frame. */
+    const Containers::StringView cacheDirectory = configuration().value<Containers::StringView>("cacheDirectory");
+    const bool useCache = cacheDirectory && !_state->isVideo;
+    if(useCache && _state->cacheKey.isEmpty()) {
+        Utility::Sha1 sha1;
+        sha1 << _state->in;
+        _state->cacheKey = Utility::format("{}-{}", sha1.digest().hexString(), BASISD_LIB_VERSION);
     }
+    auto cacheFilename = [&](const UnsignedInt levelId) {
+        return Utility::Path::join(cacheDirectory, Utility::format("{}-{}-{}-{}.bin", _state->cacheKey, id, levelId, FormatNames[UnsignedInt(targetFormat)]));
+    };
+    auto writeCache = [&](const UnsignedInt levelId, const Containers::ArrayView<const char> data) {
+        const Containers::String filename = cacheFilename(levelId);
+        if(!Utility::Path::make(cacheDirectory)) {
+            Warning{} << prefix << "cannot create cache directory" << cacheDirectory;
+            return;
+        }
 
-    const Vector3ui size{origWidth, origHeight, _state->numSlices};
-    UnsignedInt rowStride, outputRowsInPixels, outputSizeInBlocksOrPixels;
-    if(isUncompressed) {
-        rowStride = size.x();
-        outputRowsInPixels = size.y();
-        outputSizeInBlocksOrPixels = size.x()*size.y();
-    } else {
-        rowStride = 0; /* left up to Basis to calculate */
-        outputRowsInPixels = 0; /* not used for compressed data */
-        outputSizeInBlocksOrPixels = totalBlocks;
+        /* Don't write anything if the directory would go over the limit. The
+           directory is listed only once per opened file, further writes then
+           just update the total. Other processes writing into the same
+           directory in the meantime thus aren't accounted for. */
+        const std::size_t cacheSizeLimit = configuration().value<std::size_t>("cacheSizeLimit");
+        if(cacheSizeLimit && !_state->cacheSize) {
+            _state->cacheSize = 0;
+            if(const Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(cacheDirectory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot)) {
+                for(const Containers::String& file: *files)
+                    if(const Containers::Optional<std::size_t> size = Utility::Path::size(Utility::Path::join(cacheDirectory, file)))
+                        *_state->cacheSize += *size;
+            }
+        }
+        /* A file with an unexpected size gets replaced, so its size no longer
+           counts */
+        std::size_t replacedSize = 0;
+        if(_state->cacheSize && Utility::Path::exists(filename))
+            if(const Containers::Optional<std::size_t> size = Utility::Path::size(filename))
+                replacedSize = Math::min(*size, *_state->cacheSize);
+        if(cacheSizeLimit && *_state->cacheSize - replacedSize + data.size() > cacheSizeLimit) {
+            if(flags() & ImporterFlag::Verbose)
+                Debug{} << prefix << "cache size limit reached, not writing" << filename;
+            return;
+        }
+
+        /* Write to a temporary file first so another process never sees a
+           partially written file */
+        const Containers::String temporaryFilename = filename + ".tmp"_s;
+        if(!Utility::Path::write(temporaryFilename, data) ||
+           !Utility::Path::move(temporaryFilename, filename))
+            Warning{} << prefix << "cannot write cache file" << filename;
+        else if(_state->cacheSize)
+            *_state->cacheSize = *_state->cacheSize - replacedSize + data.size();
+    };
+
+    /* Take the level from the cache if it's there and has the expected
+       size, otherwise it's transcoded again and the cache file replaced */
+    Containers::Array<char> dest;
+    if(useCache) {
+        const Containers::String filename = cacheFilename(level);
+        if(Utility::Path::exists(filename)) {
+            Containers::Optional<Containers::Array<char>> cached = Utility::Path::read(filename);
+            if(cached && cached->size() == std::size_t(layout.sliceSize)*numSlices) {
+                if(flags() & ImporterFlag::Verbose)
+                    Debug{} << prefix << "using cached" << filename;
+                dest = *std::move(cached);
+            }
+        }
     }
 
-    const UnsignedInt sliceSize = basis_get_bytes_per_block_or_pixel(format)*outputSizeInBlocksOrPixels;
-    const UnsignedInt dataSize = sliceSize*size.z();
-    Containers::Array<char> dest{DefaultInit, dataSize};
-
-    /* There's no function for transcoding the entire level, so loop over all
-       layers and faces and transcode each one. This matches the image layout
-       imported by KtxImporter, ie. all faces +X through -Z for the first
-       layer, then all faces of the second layer, etc.
-
-       If the user is requesting id > 0, there can't be any layers or faces,
-       this is already asserted in doOpenData(). This allows us to calculate
-       the layer (KTX2) or image id to transcode with a simple addition. */
-    for(UnsignedInt l = 0; l != numLayers; ++l) {
-        for(UnsignedInt f = 0; f != numFaces; ++f) {
-            const UnsignedInt offset = (l*numFaces + f)*sliceSize;
-            #if BASISD_SUPPORT_KTX2
-            if(_state->ktx2Transcoder) {
-                const UnsignedInt currentLayer = id + l;
-                if(!_state->ktx2Transcoder->transcode_image_level(level, currentLayer, f, dest.data() + offset, outputSizeInBlocksOrPixels, format, flags, rowStride, outputRowsInPixels)) {
-                    Error{} << prefix << "transcoding failed";
-                    return Containers::NullOpt;
-                }
-            } else
-            #endif
-            {
-                const UnsignedInt currentId = id + (l*numFaces + f);
-                if(!_state->basisTranscoder->transcode_image_level(_state->in.data(), _state->in.size(), currentId, level, dest.data() + offset, outputSizeInBlocksOrPixels, format, flags, rowStride, nullptr, outputRowsInPixels)) {
-                    Error{} << prefix << "transcoding failed";
-                    return Containers::NullOpt;
+    if(!dest.isEmpty()) {
+        /* Nothing else to do */
+
+    /* If the level was transcoded ahead of time by a previous call, take it
+       from there. It's moved out, so importing it again transcodes it again. */
+    } else if(threadCount != 1 && _state->transcodedImageId == id && _state->transcodedFormat == targetFormat && !_state->transcodedLevels[level].isEmpty()) {
+        dest = std::move(_state->transcodedLevels[level]);
+
+    /* Otherwise, with multithreading disabled only the requested level gets
+       transcoded. With multithreading enabled all levels of the image are
+       transcoded at once, as the remaining levels are usually imported right
+       after, and the levels that weren't requested are kept for the next
+       calls. That's done only the first time given image is imported with
+       given format -- if the level was already moved out or its transcoding
+       failed, only the requested level is transcoded again. */
+    } else {
+        const bool transcodeAll = threadCount != 1 && (_state->transcodedImageId != id || _state->transcodedFormat != targetFormat);
+        const UnsignedInt firstLevel = transcodeAll ? 0 : level;
+        const UnsignedInt numLevels = transcodeAll ? _state->numLevels[id] : 1;
+        Containers::Array<LevelLayout> pendingLayouts{NoInit, numLevels};
+        Containers::Array<Containers::Array<char>> pendingData{numLevels};
+        for(UnsignedInt i = 0; i != numLevels; ++i) {
+            pendingLayouts[i] = firstLevel + i == level ? layout : levelLayout(firstLevel + i);
+            pendingData[i] = Containers::Array<char>{DefaultInit, pendingLayouts[i].sliceSize*numSlices};
+        }
+
+        /* There's no function for transcoding the entire level, so each
+           layer and face of each level is a separate job. The output layout
+           matches the image layout imported by KtxImporter, ie. all faces +X
+           through -Z for the first layer, then all faces of the second layer,
+           etc.
+
+           If the user is requesting id > 0, there can't be any layers or
+           faces, this is already asserted in doOpenData(). This allows us to
+           calculate the layer (KTX2) or image id to transcode with a simple
+           addition. */
+        const std::size_t jobCount = std::size_t(numLevels)*numSlices;
+        Containers::Array<bool> succeeded{NoInit, jobCount};
+        std::atomic<std::size_t> next{0};
+        /* Gets called from worker threads, so it doesn't print anything on
+           its own. The calling thread passes nullptr to use the transcoders'
+           internal state, the worker threads each have their own. */
+        auto transcodePending = [&](TranscoderState* const transcoderState) {
+            for(;;) {
+                const std::size_t i = next++;
+                if(i >= jobCount) break;
+                const UnsignedInt pending = i/numSlices;
+                const UnsignedInt slice = i%numSlices;
+                const LevelLayout& pendingLayout = pendingLayouts[pending];
+                char* const out = pendingData[pending].data() + slice*pendingLayout.sliceSize;
+                /* No flags used by transcode_image_level() by default */
+                const std::uint32_t flags = 0;
+                #if BASISD_SUPPORT_KTX2
+                if(_state->ktx2Transcoder) {
+                    const UnsignedInt currentLayer = id + slice/numFaces;
+                    succeeded[i] = _state->ktx2Transcoder->transcode_image_level(firstLevel + pending, currentLayer, slice%numFaces, out, pendingLayout.outputSizeInBlocksOrPixels, format, flags, pendingLayout.rowStride, pendingLayout.outputRowsInPixels, -1, -1, transcoderState ? &transcoderState->ktx2 : nullptr);
+                } else
+                #endif
+                {
+                    const UnsignedInt currentId = id + slice;
+                    succeeded[i] = _state->basisTranscoder->transcode_image_level(_state->in.data(), _state->in.size(), currentId, firstLevel + pending, out, pendingLayout.outputSizeInBlocksOrPixels, format, flags, pendingLayout.rowStride, transcoderState ? &transcoderState->basis : nullptr, pendingLayout.outputRowsInPixels);
                 }
             }
+        };
+        Containers::Array<std::thread> threads{ValueInit, Math::min(std::size_t(threadCount), jobCount) - 1};
+        for(std::thread& thread: threads) thread = std::thread{[&]() {
+            TranscoderState transcoderState;
+            transcodePending(&transcoderState);
+        }};
+        transcodePending(nullptr);
+        for(std::thread& thread: threads)
+            thread.join();
+
+        /* Discard levels that failed to transcode, they'll fail again once
+           they're requested */
+        for(std::size_t i = 0; i != jobCount; ++i)
+            if(!succeeded[i]) pendingData[i/numSlices] = nullptr;
+
+        if(useCache) for(UnsignedInt i = 0; i != numLevels; ++i)
+            if(!pendingData[i].isEmpty()) writeCache(firstLevel + i, pendingData[i]);
+
+        /* Keep the other levels even if the requested one failed, so
+           importing them doesn't need to transcode everything again */
+        const UnsignedInt requested = level - firstLevel;
+        dest = std::move(pendingData[requested]);
+        if(transcodeAll) {
+            _state->transcodedImageId = id;
+            _state->transcodedFormat = targetFormat;
+            _state->transcodedLevels = std::move(pendingData);
+        }
+
+        /* Print an error only for the requested level */
+        if(dest.isEmpty()) {
+            Error{} << prefix << "transcoding failed";
+            return Containers::NullOpt;
         }
     }
 
     if(isUncompressed)
-        return Trade::ImageData<dimensions>{pixelFormat(targetFormat, _state->isSrgb), Math::Vector<dimensions, Int>::pad(Vector3i{size}), std::move(dest), ImageFlag<dimensions>(UnsignedShort(_state->imageFlags))};
+        return Trade::ImageData<dimensions>{pixelFormat(targetFormat, _state->isSrgb), Math::Vector<dimensions, Int>::pad(Vector3i{size}), std::move(dest), imageFlags};
     else
-        return Trade::ImageData<dimensions>{compressedPixelFormat(targetFormat, _state->isSrgb), Math::Vector<dimensions, Int>::pad(Vector3i{size}), std::move(dest), ImageFlag<dimensions>(UnsignedShort(_state->imageFlags))};
+        return Trade::ImageData<dimensions>{compressedPixelFormat(targetFormat, _state->isSrgb), Math::Vector<dimensions, Int>::pad(Vector3i{size}), std::move(dest), imageFlags};
 }
 
 UnsignedInt BasisImporter::doImage2DCount() const {
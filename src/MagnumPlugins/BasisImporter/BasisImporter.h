@@ -177,6 +177,48 @@ halve correctly in the z-dimension for 3D images. If a 3D image with mip levels
 is detected, it gets imported as a layered 2D image instead, along with a
 warning being printed.
 
+@subsection Trade-BasisImporter-behavior-threads Multithreaded transcoding
+
+By default, each @ref image2D() / @ref image3D() call transcodes just the
+requested level, one layer or face after another, on the calling thread. With
+the @cb{.ini} threads @ce @ref Trade-BasisImporter-configuration "configuration option"
+set to a value other than @cpp 1 @ce, the first access to any level of an
+image transcodes all layers and faces of all its levels in parallel, each
+thread with its own transcoder state. The levels that weren't requested are
+kept in memory and subsequent calls for the same image and target format
+return them without transcoding again. Each level is kept only until it's
+imported, importing it again or importing a level that failed to transcode
+transcodes just that level, the remaining levels stay kept. The kept levels are
+discarded when another image or the same image with a different target format
+is transcoded, or when the file is closed.
+
+Because Basis Universal video frames depend on the previous frame, videos are
+always transcoded on a single thread. The same is done for all images on
+@ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" unless the plugin is built with
+pthreads enabled.
+
+@subsection Trade-BasisImporter-behavior-cache Transcoded image cache
+
+If the @cb{.ini} cacheDirectory @ce
+@ref Trade-BasisImporter-configuration "configuration option" is set, each
+transcoded level is written into a file in given directory, named after a
+SHA-1 hash of the file contents, Basis Universal transcoder version, image ID,
+level and target format. When the same level of the same file is imported with
+the same target format again, even in a different application run, it's read
+from the cache instead of being transcoded. Files written by a different
+transcoder version are not used. A cache file that has an unexpected size is ignored and
+overwritten. The hash is calculated on the first import after the file is
+opened. With @ref ImporterFlag::Verbose enabled, the importer prints which
+levels got loaded from the cache.
+
+The @cb{.ini} cacheSizeLimit @ce option limits the total size of all files in
+the directory. When writing a new level would exceed the limit, the level
+isn't cached. The directory size is calculated only on the first write after
+the file is opened and then updated with each written level, files written
+by other processes in the meantime aren't taken into account. The importer never removes any files, it's up to the
+application to clean up the directory. Video frames are never cached, because
+frames after the first can be transcoded only right after the previous frame.
+
 @subsection Trade-BasisImporter-behavior-cube Cube maps
 
 Cube map faces are imported in the order +X, -X, +Y, -Y, +Z, -Z as seen from a
@@ -26,15 +26,22 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/FileToString.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/Path.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
@@ -93,6 +100,15 @@ struct BasisImporterTest: TestSuite::Tester {
     void videoVerbose();
 
     void openMemory();
+    void threads();
+    void threadsMultipleImages();
+    void threadsDifferentFormat();
+
+    void cache();
+    void cacheThreads();
+    void cacheInvalidSize();
+    void cacheSizeLimit();
+    void cacheVideo();
     void openSameTwice();
     void openDifferent();
     void importMultipleFormats();
@@ -274,6 +290,20 @@ const struct {
     {"KTX2 UASTC", "rgba-video-uastc.ktx2"}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"Basis array", "rgba-array-mips.basis", 2},
+    {"KTX2 array", "rgba-array-mips.ktx2", 2},
+    {"Basis cube map array", "rgba-cubemap-array.basis", 2},
+    {"KTX2 cube map array", "rgba-cubemap-array.ktx2", 2},
+    /* More threads than layers and levels */
+    {"Basis 3D, 32 threads", "rgba-3d-mips.basis", 32},
+    {"KTX2 3D, all threads", "rgba-3d-mips.ktx2", 0},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -290,6 +320,42 @@ const struct {
     }},
 };
 
+/* Returns a cache directory with no files in it */
+Containers::String emptyCacheDirectory() {
+    const Containers::String directory = Utility::Path::join(BASISIMPORTER_TEST_OUTPUT_DIR, "cache");
+    if(Utility::Path::exists(directory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(directory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_INTERNAL_ASSERT(files);
+        for(const Containers::String& file: *files)
+            CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::remove(Utility::Path::join(directory, file)));
+    }
+    return directory;
+}
+
+Containers::String sha1(const Containers::ArrayView<const char> data) {
+    Utility::Sha1 sha1;
+    sha1 << data;
+    return sha1.digest().hexString();
+}
+
+/* Returns the cache key of given file data, which is a SHA-1 of the data
+   followed by the transcoder version. The test doesn't know the version, so
+   it's taken from a file of the same data already present in the cache
+   directory. Returns an empty string if there's no such file. */
+Containers::String cacheKey(const Containers::StringView directory, const Containers::ArrayView<const char> data) {
+    const Containers::String hash = sha1(data);
+    Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(directory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+    CORRADE_INTERNAL_ASSERT(files);
+    for(const Containers::String& file: *files) {
+        if(!file.hasPrefix(hash)) continue;
+        /* <sha1>-<version>-<image>-<level>-<format>.bin */
+        const Containers::Array<Containers::StringView> parts = file.split('-');
+        CORRADE_INTERNAL_ASSERT(parts.size() == 5);
+        return Utility::format("{}-{}", hash, parts[1]);
+    }
+    return {};
+}
+
 BasisImporterTest::BasisImporterTest() {
     addTests({&BasisImporterTest::empty});
 
@@ -348,6 +414,18 @@ BasisImporterTest::BasisImporterTest() {
     addInstancedTests({&BasisImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
+    addInstancedTests({&BasisImporterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&BasisImporterTest::threadsMultipleImages,
+              &BasisImporterTest::threadsDifferentFormat,
+
+              &BasisImporterTest::cache,
+              &BasisImporterTest::cacheThreads,
+              &BasisImporterTest::cacheInvalidSize,
+              &BasisImporterTest::cacheSizeLimit,
+              &BasisImporterTest::cacheVideo});
+
     addTests({&BasisImporterTest::openSameTwice,
               &BasisImporterTest::openDifferent,
               &BasisImporterTest::importMultipleFormats});
@@ -1289,6 +1367,262 @@ void BasisImporterTest::openMemory() {
         (DebugTools::CompareImageToFile{_manager, 94.0f, 8.039f}));
 }
 
+void BasisImporterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Import everything on a single thread first to compare against */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_COMPARE(importer->configuration().value("threads"), "1");
+    {
+        /* The 3D files warn, the KTX2 files have no proper orientation */
+        Warning redirectWarning{nullptr};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, data.filename)));
+    }
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+    const UnsignedInt levelCount = importer->image3DLevelCount(0);
+
+    Containers::Array<Containers::Optional<ImageData3D>> expected{levelCount};
+    for(UnsignedInt i = 0; i != levelCount; ++i) {
+        CORRADE_ITERATION(i);
+        expected[i] = importer->image3D(0, i);
+        CORRADE_VERIFY(expected[i]);
+    }
+
+    /* Import in reverse order, so the first call transcodes all levels and
+       the remaining are taken from what was transcoded ahead of time. The
+       cube map array has just one level, but it's still transcoded one face
+       per thread. */
+    importer->configuration().setValue("threads", data.threads);
+    for(UnsignedInt i = levelCount; i != 0; --i) {
+        CORRADE_ITERATION(i - 1);
+        Containers::Optional<ImageData3D> image = importer->image3D(0, i - 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->format(), expected[i - 1]->format());
+        CORRADE_COMPARE(image->size(), expected[i - 1]->size());
+        CORRADE_COMPARE(image->flags(), expected[i - 1]->flags());
+        CORRADE_COMPARE_AS(image->data(), expected[i - 1]->data(),
+            TestSuite::Compare::Container);
+    }
+
+    /* Importing a level again transcodes it again */
+    Containers::Optional<ImageData3D> image = importer->image3D(0, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(image->data(), expected[0]->data(),
+        TestSuite::Compare::Container);
+}
+
+void BasisImporterTest::threadsMultipleImages() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR,
+        "rgba-2images-mips.basis")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    Containers::Optional<ImageData2D> image0l1 = importer->image2D(0, 1);
+    Containers::Optional<ImageData2D> image1l1 = importer->image2D(1, 1);
+    CORRADE_VERIFY(image0l1);
+    CORRADE_VERIFY(image1l1);
+
+    importer->configuration().setValue("threads", 2);
+
+    /* Switching between images discards the levels transcoded ahead of time
+       for the other image */
+    Containers::Optional<ImageData2D> threaded0l0 = importer->image2D(0, 0);
+    Containers::Optional<ImageData2D> threaded1l1 = importer->image2D(1, 1);
+    Containers::Optional<ImageData2D> threaded0l1 = importer->image2D(0, 1);
+    CORRADE_VERIFY(threaded0l0);
+    CORRADE_VERIFY(threaded1l1);
+    CORRADE_VERIFY(threaded0l1);
+    CORRADE_COMPARE(threaded0l0->size(), (Vector2i{63, 27}));
+    CORRADE_COMPARE(threaded1l1->size(), (Vector2i{6, 15}));
+    CORRADE_COMPARE(threaded0l1->size(), (Vector2i{31, 13}));
+    CORRADE_COMPARE_AS(threaded1l1->data(), image1l1->data(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(threaded0l1->data(), image0l1->data(),
+        TestSuite::Compare::Container);
+}
+
+void BasisImporterTest::threadsDifferentFormat() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis")));
+
+    importer->configuration().setValue("format", "RGBA8");
+    Containers::Optional<ImageData3D> image = importer->image3D(0, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!image->isCompressed());
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Srgb);
+
+    /* The second level was transcoded ahead of time to RGBA8, which shouldn't
+       get used for a different format */
+    importer->configuration().setValue("format", "Etc2RGBA");
+    image = importer->image3D(0, 1);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Etc2RGBA8Srgb);
+    CORRADE_COMPARE(image->size(), (Vector3i{31, 13, 3}));
+    /* 8x4x3 blocks, 16 bytes each */
+    CORRADE_COMPARE(image->data().size(), 8*4*3*16);
+}
+
+void BasisImporterTest::cache() {
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis"));
+    CORRADE_VERIFY(memory);
+    const Containers::String directory = emptyCacheDirectory();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_COMPARE(importer->configuration().value("cacheDirectory"), "");
+    CORRADE_COMPARE(importer->configuration().value("cacheSizeLimit"), "0");
+    importer->configuration().setValue("cacheDirectory", directory);
+    importer->setFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openData(*memory));
+
+    /* Only the imported level gets cached */
+    Containers::Optional<ImageData3D> image = importer->image3D(0, 1);
+    CORRADE_VERIFY(image);
+    const Containers::String key = cacheKey(directory, *memory);
+    CORRADE_VERIFY(!key.isEmpty());
+    const Containers::String filename = Utility::Path::join(directory, key + "-0-1-RGBA8.bin"_s);
+    CORRADE_VERIFY(Utility::Path::exists(filename));
+    CORRADE_VERIFY(!Utility::Path::exists(Utility::Path::join(directory, key + "-0-0-RGBA8.bin"_s)));
+    CORRADE_COMPARE_AS(filename, (Containers::StringView{image->data().data(), image->data().size()}),
+        TestSuite::Compare::FileToString);
+
+    /* Replace the file contents to verify it's read from there */
+    Containers::Array<char> cached{NoInit, image->data().size()};
+    for(std::size_t i = 0; i != cached.size(); ++i)
+        cached[i] = char(i*7);
+    CORRADE_VERIFY(Utility::Path::write(filename, cached));
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        image = importer->image3D(0, 1);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Srgb);
+    CORRADE_COMPARE(image->size(), (Vector3i{31, 13, 3}));
+    CORRADE_COMPARE_AS(image->data(), cached,
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::BasisImporter::image3D(): using cached {}\n", filename));
+
+    /* A different format isn't taken from the cache */
+    importer->configuration().setValue("format", "Etc2RGBA");
+    image = importer->image3D(0, 1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Etc2RGBA8Srgb);
+    CORRADE_VERIFY(Utility::Path::exists(Utility::Path::join(directory, key + "-0-1-Etc2RGBA.bin"_s)));
+
+    /* A new importer instance uses the cache as well */
+    Containers::Pointer<AbstractImporter> importer2 = _manager.instantiate("BasisImporterRGBA8");
+    importer2->configuration().setValue("cacheDirectory", directory);
+    CORRADE_VERIFY(importer2->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis")));
+    image = importer2->image3D(0, 1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(image->data(), cached,
+        TestSuite::Compare::Container);
+}
+
+void BasisImporterTest::cacheThreads() {
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis"));
+    CORRADE_VERIFY(memory);
+    const Containers::String directory = emptyCacheDirectory();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    importer->configuration().setValue("cacheDirectory", directory);
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openData(*memory));
+
+    /* All levels transcoded ahead of time get cached */
+    CORRADE_VERIFY(importer->image3D(0, 0));
+    const Containers::String key = cacheKey(directory, *memory);
+    CORRADE_VERIFY(!key.isEmpty());
+    CORRADE_VERIFY(Utility::Path::exists(Utility::Path::join(directory, key + "-0-0-RGBA8.bin"_s)));
+    CORRADE_VERIFY(Utility::Path::exists(Utility::Path::join(directory, key + "-0-1-RGBA8.bin"_s)));
+    CORRADE_VERIFY(Utility::Path::exists(Utility::Path::join(directory, key + "-0-2-RGBA8.bin"_s)));
+
+    /* Importing a level that was already moved out transcodes just that
+       level again, not all of them. The remaining levels are still kept from
+       the first import. */
+    for(const Containers::StringView level: {"-0-0-RGBA8.bin"_s, "-0-1-RGBA8.bin"_s, "-0-2-RGBA8.bin"_s})
+        CORRADE_VERIFY(Utility::Path::remove(Utility::Path::join(directory, key + level)));
+    CORRADE_VERIFY(importer->image3D(0, 0));
+    CORRADE_VERIFY(Utility::Path::exists(Utility::Path::join(directory, key + "-0-0-RGBA8.bin"_s)));
+    CORRADE_VERIFY(!Utility::Path::exists(Utility::Path::join(directory, key + "-0-1-RGBA8.bin"_s)));
+    CORRADE_VERIFY(!Utility::Path::exists(Utility::Path::join(directory, key + "-0-2-RGBA8.bin"_s)));
+    CORRADE_VERIFY(importer->image3D(0, 1));
+    CORRADE_VERIFY(!Utility::Path::exists(Utility::Path::join(directory, key + "-0-1-RGBA8.bin"_s)));
+}
+
+void BasisImporterTest::cacheInvalidSize() {
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis"));
+    CORRADE_VERIFY(memory);
+    const Containers::String directory = emptyCacheDirectory();
+
+    /* Import the level once to know the cache file name, then make the file
+       invalid */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    importer->configuration().setValue("cacheDirectory", directory);
+    CORRADE_VERIFY(importer->openData(*memory));
+    CORRADE_VERIFY(importer->image3D(0, 2));
+    const Containers::String key = cacheKey(directory, *memory);
+    CORRADE_VERIFY(!key.isEmpty());
+    const Containers::String filename = Utility::Path::join(directory, key + "-0-2-RGBA8.bin"_s);
+    CORRADE_VERIFY(Utility::Path::write(filename, Containers::arrayView("abc", 3)));
+
+    /* The file gets ignored and replaced */
+    Containers::Optional<ImageData3D> image = importer->image3D(0, 2);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector3i{15, 6, 3}));
+    CORRADE_COMPARE(image->data().size(), 15*6*3*4);
+    CORRADE_COMPARE_AS(filename, (Containers::StringView{image->data().data(), image->data().size()}),
+        TestSuite::Compare::FileToString);
+}
+
+void BasisImporterTest::cacheSizeLimit() {
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-array-mips.basis"));
+    CORRADE_VERIFY(memory);
+    const Containers::String directory = emptyCacheDirectory();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    importer->configuration().setValue("cacheDirectory", directory);
+    /* Level 2 is 15*6*3*4 = 1080 bytes, level 1 31*13*3*4 = 4836 bytes */
+    importer->configuration().setValue("cacheSizeLimit", 2000);
+    importer->setFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openData(*memory));
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->image3D(0, 2));
+        CORRADE_VERIFY(importer->image3D(0, 1));
+    }
+    const Containers::String key = cacheKey(directory, *memory);
+    CORRADE_VERIFY(!key.isEmpty());
+    const Containers::String filename1 = Utility::Path::join(directory, key + "-0-1-RGBA8.bin"_s);
+    const Containers::String filename2 = Utility::Path::join(directory, key + "-0-2-RGBA8.bin"_s);
+    CORRADE_VERIFY(Utility::Path::exists(filename2));
+    CORRADE_VERIFY(!Utility::Path::exists(filename1));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::BasisImporter::image3D(): cache size limit reached, not writing {}\n", filename1));
+}
+
+void BasisImporterTest::cacheVideo() {
+    const Containers::String directory = emptyCacheDirectory();
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    importer->configuration().setValue("cacheDirectory", directory);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgba-video.basis")));
+    CORRADE_VERIFY(importer->image2D(0));
+    CORRADE_VERIFY(importer->image2D(1));
+
+    /* Nothing got written */
+    if(Utility::Path::exists(directory)) {
+        Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(directory, Utility::Path::ListFlag::SkipDirectories|Utility::Path::ListFlag::SkipDotAndDotDot);
+        CORRADE_VERIFY(files);
+        CORRADE_COMPARE(files->size(), 0);
+    }
+}
+
 void BasisImporterTest::openSameTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterEtc2RGBA");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(BASISIMPORTER_TEST_DIR, "rgb.basis")));
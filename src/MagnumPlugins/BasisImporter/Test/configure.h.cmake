@@ -29,3 +29,4 @@
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define KTXIMPORTER_TEST_DIR "${KTXIMPORTER_TEST_DIR}"
 #define BASISIMPORTER_TEST_DIR "${BASISIMPORTER_TEST_DIR}"
+#define BASISIMPORTER_TEST_OUTPUT_DIR "${BASISIMPORTER_TEST_OUTPUT_DIR}"
@@ -33,13 +33,15 @@
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Path.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Math/Vector4.h>
-#include <Magnum/Math/Swizzle.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/copySwizzlePixels.h"
+
 #ifdef MAGNUM_BUILD_DEPRECATED
 #include <Magnum/Trade/TextureData.h>
 #endif
@@ -48,6 +50,11 @@ namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
 
+/* Same condition as for Utility::Path::mapRead() */
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define MAGNUM_DDSIMPORTER_CAN_MAP_FILES
+#endif
+
 namespace {
 
 /* Flags to indicate which members of a DdsHeader contain valid data. Spec says
@@ -226,7 +233,14 @@ constexpr struct {
 }
 
 struct DdsImporter::File {
-    Containers::Array<char> in;
+    /* File data. Either owned, referencing the memory passed to openMemory()
+       or, with the mapFile option, a memory-mapped file. The in view points
+       to whichever is used. */
+    Containers::Array<char> data;
+    #ifdef MAGNUM_DDSIMPORTER_CAN_MAP_FILES
+    Containers::Array<const char, Utility::Path::MapDeleter> mappedData;
+    #endif
+    Containers::ArrayView<const char> in;
 
     /* Size of one top-level slice. As it's used as an input for level size
        calculation, it doesn't take sliceCount into account. */
@@ -241,6 +255,9 @@ struct DdsImporter::File {
     std::size_t dataOffset; /* 128 or 148 for a DXT10 file */
     std::size_t sliceSize; /* Size of one slice including all mip levels */
 
+    /* Whether to flip along Y and Z on import */
+    BitVector2 yzFlip{NoInit};
+
     bool compressed;
     union Properties {
         /* Yeah fuck off C++, this is unhelpful, this is not the point where I
@@ -250,7 +267,6 @@ struct DdsImporter::File {
         struct {
             PixelFormat format;
             bool needsSwizzle;
-            BitVector2 yzFlip{NoInit};
             UnsignedInt pixelSize;
         } uncompressed;
 
@@ -258,6 +274,9 @@ struct DdsImporter::File {
             CompressedPixelFormat format;
             Vector3i blockSize{NoInit};
             UnsignedInt blockDataSize;
+            /* Flips first N pixel rows of a block, null if flipping isn't
+               possible for given format */
+            void(*flipBlockRows)(char*, UnsignedInt);
         } compressed;
     } properties;
 };
@@ -298,6 +317,121 @@ Containers::Triple<std::size_t, std::size_t, Vector3i> levelOffsetSize(Vector3i
     return {offset, dataSize, size};
 }
 
+/* BC1 to BC5 blocks store each row of 4x4 pixels in separate bits, so they can
+   be flipped along Y losslessly by reordering the rows. The rowCount is 4
+   except for images smaller than a block, where only the rows that are
+   actually used get flipped. */
+
+/* BC1 color block, two 16-bit endpoints followed by 2-bit indices, one byte
+   per row. Used also for the color part of BC2 and BC3. */
+void flipBc1BlockRows(char* const block, const UnsignedInt rowCount) {
+    for(UnsignedInt i = 0; i != rowCount/2; ++i) {
+        const char tmp = block[4 + i];
+        block[4 + i] = block[4 + rowCount - i - 1];
+        block[4 + rowCount - i - 1] = tmp;
+    }
+}
+
+/* BC4 block, two 8-bit endpoints followed by 48 bits of 3-bit indices, 12 bits
+   per row. Used also for the alpha part of BC3 and both channels of BC5. */
+void flipBc4BlockRows(char* const block, const UnsignedInt rowCount) {
+    UnsignedLong indices = 0;
+    for(UnsignedInt i = 0; i != 6; ++i)
+        indices |= UnsignedLong(UnsignedByte(block[2 + i])) << 8*i;
+
+    UnsignedLong flipped = indices;
+    for(UnsignedInt i = 0; i != rowCount; ++i) {
+        const UnsignedInt to = 12*(rowCount - i - 1);
+        flipped &= ~(0xfffull << to);
+        flipped |= ((indices >> 12*i) & 0xfff) << to;
+    }
+
+    for(UnsignedInt i = 0; i != 6; ++i)
+        block[2 + i] = char(flipped >> 8*i);
+}
+
+void flipBc1Block(char* const block, const UnsignedInt rowCount) {
+    flipBc1BlockRows(block, rowCount);
+}
+
+/* BC2 is 4-bit explicit alpha, two bytes per row, followed by a BC1 block */
+void flipBc2Block(char* const block, const UnsignedInt rowCount) {
+    for(UnsignedInt i = 0; i != rowCount/2; ++i) {
+        for(UnsignedInt j = 0; j != 2; ++j) {
+            const char tmp = block[2*i + j];
+            block[2*i + j] = block[2*(rowCount - i - 1) + j];
+            block[2*(rowCount - i - 1) + j] = tmp;
+        }
+    }
+    flipBc1BlockRows(block + 8, rowCount);
+}
+
+void flipBc3Block(char* const block, const UnsignedInt rowCount) {
+    flipBc4BlockRows(block, rowCount);
+    flipBc1BlockRows(block + 8, rowCount);
+}
+
+void flipBc4Block(char* const block, const UnsignedInt rowCount) {
+    flipBc4BlockRows(block, rowCount);
+}
+
+void flipBc5Block(char* const block, const UnsignedInt rowCount) {
+    flipBc4BlockRows(block, rowCount);
+    flipBc4BlockRows(block + 8, rowCount);
+}
+
+/* BC6H and BC7 have mode-dependent bit layouts and asymmetric partition
+   tables, so flipping them would mean reencoding the data. The same goes for
+   ETC, EAC, ASTC and PVRTC formats. */
+void(*blockRowFlipperFor(const CompressedPixelFormat format))(char*, UnsignedInt) {
+    switch(format) {
+        case CompressedPixelFormat::Bc1RGBUnorm:
+        case CompressedPixelFormat::Bc1RGBSrgb:
+        case CompressedPixelFormat::Bc1RGBAUnorm:
+        case CompressedPixelFormat::Bc1RGBASrgb:
+            return flipBc1Block;
+        case CompressedPixelFormat::Bc2RGBAUnorm:
+        case CompressedPixelFormat::Bc2RGBASrgb:
+            return flipBc2Block;
+        case CompressedPixelFormat::Bc3RGBAUnorm:
+        case CompressedPixelFormat::Bc3RGBASrgb:
+            return flipBc3Block;
+        case CompressedPixelFormat::Bc4RUnorm:
+        case CompressedPixelFormat::Bc4RSnorm:
+            return flipBc4Block;
+        case CompressedPixelFormat::Bc5RGUnorm:
+        case CompressedPixelFormat::Bc5RGSnorm:
+            return flipBc5Block;
+        default:
+            return nullptr;
+    }
+}
+
+}
+
+void DdsImporter::doOpenFile(const Containers::StringView filename) {
+    /* Read the file into memory the usual way if mapping isn't requested or
+       isn't possible */
+    #ifdef MAGNUM_DDSIMPORTER_CAN_MAP_FILES
+    if(!configuration().value<bool>("mapFile"))
+    #endif
+    {
+        AbstractImporter::doOpenFile(filename);
+        return;
+    }
+
+    #ifdef MAGNUM_DDSIMPORTER_CAN_MAP_FILES
+    Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapped = Utility::Path::mapRead(filename);
+    if(!mapped) {
+        Error{} << "Trade::DdsImporter::openFile(): cannot map file" << filename;
+        return;
+    }
+
+    Containers::Pointer<File> f{new File};
+    f->mappedData = *std::move(mapped);
+    f->in = f->mappedData;
+    openInternal("Trade::DdsImporter::openFile():", std::move(f));
+    #endif
 }
 
 void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
@@ -305,22 +439,27 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
 
     /* Take over the existing array or copy the data if we can't */
     if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        f->in = std::move(data);
+        f->data = std::move(data);
     } else {
-        f->in = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, f->in);
+        f->data = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, f->data);
     }
+    f->in = f->data;
+
+    openInternal("Trade::DdsImporter::openData():", std::move(f));
+}
 
+void DdsImporter::openInternal(const char* const prefix, Containers::Pointer<File>&& f) {
     /* Read in DDS header */
     if(f->in.size() < sizeof(DdsHeader)) {
-        Error{} << "Trade::DdsImporter::openData(): file too short, expected at least" << sizeof(DdsHeader) << "bytes but got" << f->in.size();
+        Error{} << prefix << "file too short, expected at least" << sizeof(DdsHeader) << "bytes but got" << f->in.size();
         return;
     }
     const DdsHeader& header = *reinterpret_cast<const DdsHeader*>(f->in.data());
 
     /* Verify file signature */
     if(Containers::StringView{header.signature, 4} != "DDS "_s) {
-        Error() << "Trade::DdsImporter::openData(): invalid file signature" << Containers::StringView{header.signature, 4};
+        Error() << prefix << "invalid file signature" << Containers::StringView{header.signature, 4};
         return;
     }
 
@@ -362,7 +501,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                 -- what do they represent? */
             case Utility::Endianness::fourCC('D', 'X', '1', '0'): {
                 if(f->in.size() < sizeof(DdsHeader) + sizeof(DdsHeaderDxt10)) {
-                    Error{} << "Trade::DdsImporter::openData(): DXT10 file too short, expected at least" << sizeof(DdsHeader) + sizeof(DdsHeaderDxt10) << "bytes but got" << f->in.size();
+                    Error{} << prefix << "DXT10 file too short, expected at least" << sizeof(DdsHeader) + sizeof(DdsHeaderDxt10) << "bytes but got" << f->in.size();
                     return;
                 }
 
@@ -371,7 +510,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                 const DdsHeaderDxt10& headerDxt10 = *reinterpret_cast<const DdsHeaderDxt10*>(f->in.data() + sizeof(DdsHeader));
 
                 if(headerDxt10.dxgiFormat >= Containers::arraySize(DxgiFormatMapping)) {
-                    Error{} << "Trade::DdsImporter::openData(): unknown DXGI format ID" << headerDxt10.dxgiFormat;
+                    Error{} << prefix << "unknown DXGI format ID" << headerDxt10.dxgiFormat;
                     return;
                 }
 
@@ -380,10 +519,10 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                     f->dimensions = 3;
                     f->sliceCount = 1;
                     if(headerDxt10.miscFlag & DdsMiscFlag::TextureCube) {
-                        Error{} << "Trade::DdsImporter::openData(): cube map flag set for a DXT10 3D texture";
+                        Error{} << prefix << "cube map flag set for a DXT10 3D texture";
                         return;
                     } else if(headerDxt10.arraySize != 1) {
-                        Error{} << "Trade::DdsImporter::openData(): invalid array size" << headerDxt10.arraySize << "for a DXT10 3D texture";
+                        Error{} << prefix << "invalid array size" << headerDxt10.arraySize << "for a DXT10 3D texture";
                         return;
                     }
                 } else if(headerDxt10.resourceDimension == DdsDimension::Texture2D) {
@@ -405,7 +544,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                     }
                 } else if(headerDxt10.resourceDimension == DdsDimension::Texture1D) {
                     if(headerDxt10.miscFlag & DdsMiscFlag::TextureCube) {
-                        Error{} << "Trade::DdsImporter::openData(): cube map flag set for a DXT10 1D texture";
+                        Error{} << prefix << "cube map flag set for a DXT10 1D texture";
                         return;
                     } else if(headerDxt10.arraySize != 1) {
                         f->dimensions = 2;
@@ -416,7 +555,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                         f->sliceCount = 1;
                     }
                 } else {
-                    Error{} << "Trade::DdsImporter::openData(): invalid DXT10 resource dimension" << UnsignedInt(headerDxt10.resourceDimension);
+                    Error{} << prefix << "invalid DXT10 resource dimension" << UnsignedInt(headerDxt10.resourceDimension);
                     return;
                 }
 
@@ -429,17 +568,17 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                     f->compressed = true;
                     f->properties.compressed.format = CompressedPixelFormat(mapped.compressedFormat);
                 } else if(mapped.name) {
-                    Error{} << "Trade::DdsImporter::openData(): unsupported format DXGI_FORMAT_" << Debug::nospace << mapped.name;
+                    Error{} << prefix << "unsupported format DXGI_FORMAT_" << Debug::nospace << mapped.name;
                     return;
                 } else {
-                    Error{} << "Trade::DdsImporter::openData(): unknown DXGI format ID" << headerDxt10.dxgiFormat;
+                    Error{} << prefix << "unknown DXGI format ID" << headerDxt10.dxgiFormat;
                     return;
                 }
             } break;
             case Utility::Endianness::fourCC('D', 'X', 'T', '2'):
             case Utility::Endianness::fourCC('D', 'X', 'T', '4'):
             default:
-                Error() << "Trade::DdsImporter::openData(): unknown compression" << Containers::StringView{header.ddspf.fourCCChars, 4};
+                Error() << prefix << "unknown compression" << Containers::StringView{header.ddspf.fourCCChars, 4};
                 return;
         }
 
@@ -505,7 +644,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
        was encountered. */
     } else {
         Error err;
-        err << "Trade::DdsImporter::openData(): unknown" << header.ddspf.rgbBitCount << "bits per pixel format with";
+        err << prefix << "unknown" << header.ddspf.rgbBitCount << "bits per pixel format with";
         if(header.ddspf.flags == DdsPixelFormatFlag::RGBA)
             err << "a RGBA";
         else if(header.ddspf.flags == DdsPixelFormatFlag::RGB)
@@ -537,7 +676,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
             f->dimensions = 3;
             f->sliceCount = 1;
             if(header.caps2 & DdsCap2::CubeMap) {
-                Error{} << "Trade::DdsImporter::openData(): cube map flag set for a 3D texture";
+                Error{} << prefix << "cube map flag set for a 3D texture";
                 return;
             }
         } else if(header.caps2 & DdsCap2::CubeMap) {
@@ -551,7 +690,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
                 f->imageFlags |= ImageFlag3D::CubeMap;
             } else {
                 f->imageFlags |= ImageFlag3D::Array;
-                Warning{} << "Trade::DdsImporter::openData(): the image is an incomplete cubemap, importing faces as" << f->sliceCount << "array layers";
+                Warning{} << prefix << "the image is an incomplete cubemap, importing faces as" << f->sliceCount << "array layers";
             }
         } else {
             f->dimensions = 2;
@@ -561,13 +700,13 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
 
     /* Height should be > 1 only for 2D textures */
     if(f->topLevelSliceSize.y() != 1 && (f->dimensions == 1 || (f->dimensions == 2 && f->imageFlags & ImageFlag3D::Array))) {
-        Error{} << "Trade::DdsImporter::openData(): height is" << header.height << "but the texture is 1D";
+        Error{} << prefix << "height is" << header.height << "but the texture is 1D";
         return;
     }
 
     /* Depth should be > 1 only for 3D textures */
     if(f->topLevelSliceSize.z() != 1 && (f->dimensions != 3 || (f->dimensions == 3 && (f->imageFlags & (ImageFlag3D::Array|ImageFlag3D::CubeMap))))) {
-        Error{} << "Trade::DdsImporter::openData(): depth is" << header.depth << "but the texture isn't 3D";
+        Error{} << prefix << "depth is" << header.depth << "but the texture isn't 3D";
         return;
     }
 
@@ -578,6 +717,7 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     if(f->compressed) {
         f->properties.compressed.blockSize = compressedPixelFormatBlockSize(f->properties.compressed.format);
         f->properties.compressed.blockDataSize = compressedPixelFormatBlockDataSize(f->properties.compressed.format);
+        f->properties.compressed.flipBlockRows = blockRowFlipperFor(f->properties.compressed.format);
         f->sliceSize = levelOffsetSize(f->topLevelSliceSize, f->properties.compressed.blockSize, f->properties.compressed.blockDataSize, f->levelCount).first();
     } else {
         f->properties.uncompressed.pixelSize = pixelFormatSize(f->properties.uncompressed.format);
@@ -587,10 +727,10 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     /* Check bounds */
     const std::size_t expectedSize = f->dataOffset + f->sliceSize*f->sliceCount;
     if(expectedSize > f->in.size()) {
-        Error() << "Trade::DdsImporter::openData(): file too short, expected" << expectedSize << "bytes for" << f->sliceCount << "slices with" << f->levelCount << "levels and" << f->sliceSize << "bytes each but got" << f->in.size();
+        Error() << prefix << "file too short, expected" << expectedSize << "bytes for" << f->sliceCount << "slices with" << f->levelCount << "levels and" << f->sliceSize << "bytes each but got" << f->in.size();
         return;
     } else if(expectedSize < f->in.size()) {
-        Warning{} << "Trade::DdsImporter::openData(): ignoring" << f->in.size() - expectedSize << "extra bytes at the end of file";
+        Warning{} << prefix << "ignoring" << f->in.size() - expectedSize << "extra bytes at the end of file";
     }
 
     /* Decide about data flipping. Unlike KTX or Basis, the file format doesn't
@@ -598,39 +738,53 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
        externally-provided hint. */
     if(configuration().value<bool>("assumeYUpZBackward")) {
         /* No flipping if Y up / Z backward is assumed */
-        f->properties.uncompressed.yzFlip = BitVector2{0x0};
+        f->yzFlip = BitVector2{0x0};
     } else {
-        /* Can't flip compressed blocks at the moment, so print a warning at
-           least */
-        if(f->compressed) {
-            Warning{} << "Trade::DdsImporter::openData(): block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.";
+        f->yzFlip = BitVector2{0x0};
+        /* Z gets flipped only for a 3D texture */
+        if(f->dimensions == 3 && !(f->imageFlags & (ImageFlag3D::Array|ImageFlag3D::CubeMap)))
+            f->yzFlip.set(1, true);
+        /* Y gets flipped only if it's not a 1D (array) texture */
+        if(f->dimensions == 3 || (f->dimensions == 2 && !(f->imageFlags & ImageFlag3D::Array)))
+            f->yzFlip.set(0, true);
+
+        /* Compressed blocks can be flipped along Y only if the format allows
+           reordering rows in a block and if all levels are either whole
+           blocks high or smaller than a block. Otherwise the flipped rows
+           would be split between two blocks. Flipping along Z is just
+           reordering the blocks, but it's either both or nothing to avoid
+           a partially flipped image. If not possible, print a warning at
+           least. */
+        if(f->compressed && f->yzFlip.any()) {
+            bool flippable = !!f->properties.compressed.flipBlockRows;
+            const Int blockHeight = f->properties.compressed.blockSize.y();
+            for(UnsignedInt i = 0; flippable && f->yzFlip[0] && i != f->levelCount; ++i) {
+                const Int height = Math::max(f->topLevelSliceSize.y() >> i, 1);
+                if(height > blockHeight && height % blockHeight)
+                    flippable = false;
+            }
 
-        /* For uncompressed data decide about the flip orientations */
-        } else {
-            f->properties.uncompressed.yzFlip = BitVector2{0x0};
-            /* Z gets flipped only for a 3D texture */
-            if(f->dimensions == 3 && !(f->imageFlags & (ImageFlag3D::Array|ImageFlag3D::CubeMap)))
-                f->properties.uncompressed.yzFlip.set(1, true);
-            /* Y gets flipped only if it's not a 1D (array) texture */
-            if(f->dimensions == 3 || (f->dimensions == 2 && !(f->imageFlags & ImageFlag3D::Array)))
-                f->properties.uncompressed.yzFlip.set(0, true);
+            if(!flippable) {
+                Warning{} << prefix << "block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.";
+                f->yzFlip = BitVector2{0x0};
+            }
         }
     }
 
     if(flags() & ImporterFlag::Verbose) {
-        if(f->properties.uncompressed.yzFlip.any()) {
+        if(f->yzFlip.any()) {
             const Containers::StringView axes[3]{
-                f->properties.uncompressed.yzFlip[0] ? "y"_s : ""_s,
-                f->properties.uncompressed.yzFlip[1] ? "z"_s : ""_s
+                f->yzFlip[0] ? "y"_s : ""_s,
+                f->yzFlip[1] ? "z"_s : ""_s
             };
-            Debug{} << "Trade::DdsImporter::openData(): image will be flipped along" << " and "_s.joinWithoutEmptyParts(axes);
+            Debug{} << prefix << "image will be flipped along" << " and "_s.joinWithoutEmptyParts(axes);
         }
 
         if(!f->compressed && f->properties.uncompressed.needsSwizzle) {
             if(f->properties.uncompressed.format == PixelFormat::RGB8Unorm)
-                Debug{} << "Trade::DdsImporter::openData(): format requires conversion from BGR to RGB";
+                Debug{} << prefix << "format requires conversion from BGR to RGB";
             else if(f->properties.uncompressed.format == PixelFormat::RGBA8Unorm)
-                Debug{} << "Trade::DdsImporter::openData(): format requires conversion from BGRA to RGBA";
+                Debug{} << prefix << "format requires conversion from BGRA to RGBA";
             else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
         }
     }
@@ -639,72 +793,123 @@ void DdsImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     _f = std::move(f);
 }
 
-namespace {
-
-void swizzlePixels(const PixelFormat format, const Containers::ArrayView<char> data) {
-    if(format == PixelFormat::RGB8Unorm) {
-        for(Vector3ub& pixel: Containers::arrayCast<Vector3ub>(data))
-            pixel = Math::gather<'b', 'g', 'r'>(pixel);
-    } else if(format == PixelFormat::RGBA8Unorm) {
-        for(Vector4ub& pixel: Containers::arrayCast<Vector4ub>(data))
-            pixel = Math::gather<'b', 'g', 'r', 'a'>(pixel);
-    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-}
-
-void flipPixels(const BitVector2 yzFlip, const UnsignedInt pixelSize, const Vector3i& size, const Containers::ArrayView<char> data) {
-    const Containers::StridedArrayView4D<char> view{data, {
-        std::size_t(size.z()),
-        std::size_t(size.y()),
-        std::size_t(size.x()),
-        pixelSize
-    }};
-    if(yzFlip[0]) Utility::flipInPlace<1>(view);
-    if(yzFlip[1]) Utility::flipInPlace<0>(view);
-}
-
-}
-
-template<UnsignedInt dimensions> ImageData<dimensions> DdsImporter::doImage(UnsignedInt, const UnsignedInt level) {
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> DdsImporter::doImage(UnsignedInt, const UnsignedInt level) {
     /* Calculate input offset, data size and image slice size */
     const Containers::Triple<std::size_t, std::size_t, Vector3i> offsetSize = _f->compressed ?
         levelOffsetSize(_f->topLevelSliceSize, _f->properties.compressed.blockSize, _f->properties.compressed.blockDataSize, level) :
         levelOffsetSize(_f->topLevelSliceSize, _f->properties.uncompressed.pixelSize, level);
 
-    /* Image size is slice size combined with slice count */
+    /* Decide which layers to import. Images that aren't arrays or cube maps
+       have just one slice, for those the range is ignored. */
+    UnsignedInt layerOffset = 0;
+    UnsignedInt layerCount = _f->sliceCount;
+    ImageFlags3D imageFlags = _f->imageFlags;
+    if(imageFlags & (ImageFlag3D::Array|ImageFlag3D::CubeMap)) {
+        layerOffset = configuration().value<UnsignedInt>("layerOffset");
+        layerCount = configuration().value<UnsignedInt>("layerCount");
+        if(!layerCount)
+            layerCount = _f->sliceCount - Math::min(layerOffset, _f->sliceCount);
+        /* Written this way to not overflow for large offsets */
+        if(!layerCount || layerOffset >= _f->sliceCount || layerCount > _f->sliceCount - layerOffset) {
+            constexpr const char* prefixes[3]{"Trade::DdsImporter::image1D():", "Trade::DdsImporter::image2D():", "Trade::DdsImporter::image3D():"};
+            Error{} << prefixes[dimensions - 1] << "layer range" << layerOffset << "to" << UnsignedLong(layerOffset) + layerCount << "out of bounds for" << _f->sliceCount << "layers";
+            return {};
+        }
+
+        /* Cube map faces that don't form whole cubes are just an array */
+        if((imageFlags & ImageFlag3D::CubeMap) && (layerOffset % 6 || layerCount % 6))
+            imageFlags = (imageFlags & ~ImageFlag3D::CubeMap)|ImageFlag3D::Array;
+    }
+    const ImageFlags<dimensions> flags = ImageFlag<dimensions>(UnsignedShort(imageFlags));
+
+    /* Image size is slice size combined with layer count */
     Vector3i imageSize = offsetSize.third();
     if(_f->sliceCount != 1) {
         CORRADE_INTERNAL_ASSERT(imageSize[dimensions - 1] == 1);
-        imageSize[dimensions - 1] = _f->sliceCount;
+        imageSize[dimensions - 1] = layerCount;
     }
 
-    /* Allocate image data */
-    Containers::Array<char> data{NoInit, offsetSize.second()*_f->sliceCount};
+    /* Adjust pixel storage if row size is not four byte aligned */
+    PixelStorage storage;
+    if(!_f->compressed && imageSize.x()*_f->properties.uncompressed.pixelSize % 4 != 0)
+        storage.setAlignment(1);
 
-    /* Copy all slices */
-    for(std::size_t i = 0; i != _f->sliceCount; ++i) {
-        const std::size_t inputOffset = _f->dataOffset + i*_f->sliceSize + offsetSize.first();
-        const std::size_t outputOffset = i*offsetSize.second();
-        Utility::copy(_f->in.slice(inputOffset, inputOffset + offsetSize.second()),
-            data.slice(outputOffset, outputOffset + offsetSize.second()));
+    /* Each slice contains all levels, so the imported layers are contiguous
+       in the file only if there's just one level or just one layer is
+       imported. If they also don't need any flipping or swizzling, they can
+       be referenced directly. */
+    const std::size_t firstInputOffset = _f->dataOffset + layerOffset*_f->sliceSize + offsetSize.first();
+    if(configuration().value<bool>("referenceData") &&
+       _f->yzFlip.none() &&
+       (_f->compressed || !_f->properties.uncompressed.needsSwizzle) &&
+       (layerCount == 1 || _f->sliceSize == offsetSize.second()))
+    {
+        const Containers::ArrayView<const char> imageData = _f->in.slice(firstInputOffset, firstInputOffset + offsetSize.second()*layerCount);
+        if(_f->compressed)
+            return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), DataFlags{}, imageData, flags};
+        return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), DataFlags{}, imageData, flags};
     }
 
-    /* Compressed image */
-    if(_f->compressed)
-        return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), std::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+    /* Allocate image data */
+    Containers::Array<char> data{NoInit, offsetSize.second()*layerCount};
+
+    /* Compressed image. Copy all layers, reordering the blocks if the image
+       should be flipped, and then flip the rows inside each block. */
+    if(_f->compressed) {
+        const Vector3i& blockSize = _f->properties.compressed.blockSize;
+        const Vector3i blockCount = (offsetSize.third() + blockSize - Vector3i{1})/blockSize;
+        const UnsignedInt blockDataSize = _f->properties.compressed.blockDataSize;
+        for(std::size_t i = 0; i != layerCount; ++i) {
+            const std::size_t inputOffset = firstInputOffset + i*_f->sliceSize;
+            const std::size_t outputOffset = i*offsetSize.second();
+            Containers::StridedArrayView4D<const char> src{_f->in.slice(inputOffset, inputOffset + offsetSize.second()), {
+                std::size_t(blockCount.z()),
+                std::size_t(blockCount.y()),
+                std::size_t(blockCount.x()),
+                blockDataSize
+            }};
+            const Containers::StridedArrayView4D<char> dst{data.slice(outputOffset, outputOffset + offsetSize.second()), src.size()};
+            if(_f->yzFlip[0]) src = src.flipped<1>();
+            if(_f->yzFlip[1]) src = src.flipped<0>();
+
+            /* Without flipped dimensions this becomes a single memcpy */
+            Utility::copy(src, dst);
+        }
+
+        if(_f->yzFlip[0]) {
+            const UnsignedInt rowCount = Math::min(offsetSize.third().y(), blockSize.y());
+            for(std::size_t i = 0; i < data.size(); i += blockDataSize)
+                _f->properties.compressed.flipBlockRows(data.data() + i, rowCount);
+        }
 
-    /* Uncompressed. Swizzle and flip if needed. */
-    if(_f->properties.uncompressed.needsSwizzle)
-        swizzlePixels(_f->properties.uncompressed.format, data);
-    flipPixels(_f->properties.uncompressed.yzFlip, _f->properties.uncompressed.pixelSize, imageSize, data);
+        return ImageData<dimensions>{_f->properties.compressed.format, Math::Vector<dimensions, Int>::pad(imageSize), std::move(data), flags};
+    }
 
-    /* Adjust pixel storage if row size is not four byte aligned */
-    PixelStorage storage;
-    if((imageSize.x()*_f->properties.uncompressed.pixelSize % 4 != 0))
-        storage.setAlignment(1);
+    /* Uncompressed. Copy all layers, swizzling and flipping them if needed in
+       a single pass. Z is flipped only for 3D images, which have just one
+       slice, so flipping each slice separately is the same as flipping the
+       whole image. */
+    const Vector3i sliceSize = offsetSize.third();
+    for(std::size_t i = 0; i != layerCount; ++i) {
+        const std::size_t inputOffset = firstInputOffset + i*_f->sliceSize;
+        const std::size_t outputOffset = i*offsetSize.second();
+        Containers::StridedArrayView4D<const char> src{_f->in.slice(inputOffset, inputOffset + offsetSize.second()), {
+            std::size_t(sliceSize.z()),
+            std::size_t(sliceSize.y()),
+            std::size_t(sliceSize.x()),
+            _f->properties.uncompressed.pixelSize
+        }};
+        const Containers::StridedArrayView4D<char> dst{data.slice(outputOffset, outputOffset + offsetSize.second()), src.size()};
+        if(_f->yzFlip[0]) src = src.flipped<1>();
+        if(_f->yzFlip[1]) src = src.flipped<0>();
+
+        /* Only 8-bit formats get swizzled, the data aren't endian-swapped */
+        Implementation::copySwizzlePixels(src, dst, 1, _f->properties.uncompressed.needsSwizzle);
+    }
 
     /** @todo expose DdsAlphaMode::Premultiplied through ImageFlags once it has
         such flag */
-    return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), std::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+    return ImageData<dimensions>{storage, _f->properties.uncompressed.format, Math::Vector<dimensions, Int>::pad(imageSize), std::move(data), flags};
 }
 
 UnsignedInt DdsImporter::doImage1DCount() const {
@@ -101,13 +101,17 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
     any orientation metadata, and so it's assumed to follow the Vulkan/D3D
     coordinate system with Y down and (for 3D textures) Z forward. Uncompressed
     images will be flipped on import to Y up and (for 3D textures) Z backward.
-    Because flipping block-compressed data is nontrivial, compressed images
-    will not be flipped on import, instead a message will be printed to
+    BC1, BC2, BC3, BC4 and BC5 compressed images are flipped as well, by
+    reordering the blocks and pixel rows inside them, but only if each level
+    is either a multiple of 4 pixels high or smaller than 4 pixels, as
+    otherwise the flipped rows would be split between two blocks. Other
+    compressed formats, such as BC6H or BC7, can't be flipped without
+    reencoding the data. For those a message will be printed to
     @relativeref{Magnum,Warning} and the data will be passed through unchanged.
     Set the @cb{.ini} assumeYUpZBackward @ce
     @ref Trade-DdsImporter-configuration "configuration option" to assume the
-    OpenGL coordinate system, perform no flipping of uncompressed data and
-    silence the warning for compressed data.
+    OpenGL coordinate system, perform no flipping and silence the warning for
+    compressed data that can't be flipped.
 
 The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled.
@@ -145,6 +149,31 @@ Incomplete cube maps, which are possible in legacy DDS files without the DXT10
 header, are imported as a 2D array image, but information about which faces it
 contains isn't preserved.
 
+@subsection Trade-DdsImporter-behavior-layers Importing a subset of layers
+
+For large array images it's possible to import just a range of layers using
+the @cb{.ini} layerOffset @ce and @cb{.ini} layerCount @ce
+@ref Trade-DdsImporter-configuration "configuration options". They're read on
+every @ref image1D() / @ref image2D() / @ref image3D() call, so it's possible
+to import a large array in batches. For cube maps and cube map arrays the
+options operate on individual faces; if the range doesn't consist of whole
+cube maps, the image is imported with @ref ImageFlag3D::Array instead of
+@ref ImageFlag3D::CubeMap. A range that's out of bounds results in an error.
+
+Together with the @cb{.ini} mapFile @ce option, which makes @ref openFile()
+memory-map the file instead of reading it, only the imported layers are
+loaded from the file. If the @cb{.ini} referenceData @ce option is enabled as
+well, the image is returned as a view into the mapped file instead of a copy,
+with empty @ref ImageData::dataFlags(). As DDS stores every layer together
+with its whole mip chain, a level is contiguous only if the file has a single
+mip level or if just one layer is imported. Legacy BGR(A) formats, which get
+swizzled to RGB(A) on import, and images that get flipped to Y up as
+described above are always copied. The option works also without
+@cb{.ini} mapFile @ce, in which case the view points to a copy of the file
+owned by the importer, or directly into the memory passed to
+@ref openMemory(), which then has to stay in scope for as long as the image
+is used.
+
 @subsection Trade-DdsImporter-behavior-format Legacy DDS format support
 
 The following formats are supported for legacy DDS files without the DXT10
@@ -242,9 +271,13 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
         MAGNUM_DDSIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DDSIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DDSIMPORTER_LOCAL void doClose() override;
+        MAGNUM_DDSIMPORTER_LOCAL void doOpenFile(Containers::StringView filename) override;
         MAGNUM_DDSIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
-        template<UnsignedInt dimensions> MAGNUM_DDSIMPORTER_LOCAL ImageData<dimensions> doImage(UnsignedInt id, UnsignedInt level);
+        struct File;
+        MAGNUM_DDSIMPORTER_LOCAL void openInternal(const char* prefix, Containers::Pointer<File>&& f);
+
+        template<UnsignedInt dimensions> MAGNUM_DDSIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(UnsignedInt id, UnsignedInt level);
 
         MAGNUM_DDSIMPORTER_LOCAL UnsignedInt doImage1DCount() const override;
         MAGNUM_DDSIMPORTER_LOCAL UnsignedInt doImage1DLevelCount(UnsignedInt id) override;
@@ -263,7 +296,6 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
         MAGNUM_DDSIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
         #endif
 
-        struct File;
         Containers::Pointer<File> _f;
 };
 
@@ -31,6 +31,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -44,6 +45,8 @@
 #include <Magnum/Trade/TextureData.h>
 #endif
 
+#include "MagnumPlugins/Implementation/Test/referenceData.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -66,6 +69,7 @@ struct DdsImporterTest: TestSuite::Tester {
     void dxt3IncompleteBlocks();
     void bc4();
     void bc7Dxt10();
+    void compressedFlipWarning();
 
     /* 1D can't be represented in legacy DDS */
     void rg1DDxt10();
@@ -79,6 +83,7 @@ struct DdsImporterTest: TestSuite::Tester {
     void rCubeArrayDxt10();
     void rgba3D();
     /* 3D DXT10 tested in rgba3D() */
+    void dxt13D();
     void dxt1CubeMips();
     void bc7CubeMipsDxt10();
 
@@ -92,6 +97,16 @@ struct DdsImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
 
+    void mapFile();
+    void mapFileNotFound();
+    void mapFileMessagePrefix();
+
+    void layerRange();
+    void layerRangeOutOfBounds();
+    void layerRangeNotLayered();
+
+    void referenceData();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
@@ -398,11 +413,33 @@ const struct {
 
 const struct {
     const char* name;
+    ImporterFlags flags;
+    Containers::Optional<bool> assumeYUp;
+    bool flipped;
+    const char* message;
+} CompressedFlipData[]{
+    {"", {}, {}, true,
+        ""},
+    {"verbose", ImporterFlag::Verbose, {}, true,
+        "Trade::DdsImporter::openData(): image will be flipped along y\n"},
+    {"verbose, assume Y up", ImporterFlag::Verbose, true, false,
+        ""}
+};
+
+const struct {
+    const char* name;
+    const char* filename;
     Containers::Optional<bool> assumeYUp;
     const char* message;
 } CompressedFlipWarningData[]{
-    {"", {}, "Trade::DdsImporter::openData(): block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.\n"},
-    {"assume Y up", true, ""}
+    {"BC7", "dxt10-bc7.dds", {},
+        "Trade::DdsImporter::openData(): block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.\n"},
+    {"BC7, assume Y up", "dxt10-bc7.dds", true,
+        ""},
+    {"height not whole blocks", "dxt3-incomplete-blocks.dds", {},
+        "Trade::DdsImporter::openData(): block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.\n"},
+    {"mip height not whole blocks", "dxt1-cube-mips.dds", {},
+        "Trade::DdsImporter::openData(): block-compressed image is assumed to be encoded with Y down and Z forward, imported data will have wrong orientation. Enable assumeYUpZBackward to suppress this warning.\n"}
 };
 
 const struct {
@@ -438,6 +475,51 @@ constexpr struct {
     {"dxt10-astc8x5unorm.dds", PixelFormat{}, CompressedPixelFormat::Astc8x5RGBAUnorm}
 };
 
+const struct {
+    const char* name;
+    const char* filename;
+    UnsignedInt level;
+    UnsignedInt layerOffset, layerCount;
+    Int expectedLayerCount;
+    ImageFlags3D expectedFlags;
+} LayerRangeData[]{
+    {"array, one layer", "dxt10-rgba8unorm-array.dds", 0, 1, 1,
+        1, ImageFlag3D::Array},
+    {"array, from an offset to the end", "dxt10-rgba8unorm-array.dds", 0, 1, 0,
+        2, ImageFlag3D::Array},
+    {"cube map, all faces", "rgba8unorm-cube.dds", 0, 0, 6,
+        6, ImageFlag3D::CubeMap},
+    {"cube map, some faces", "rgba8unorm-cube.dds", 0, 2, 3,
+        3, ImageFlag3D::Array},
+    {"compressed cube map, second level, some faces", "dxt1-cube-mips.dds", 1, 4, 2,
+        2, ImageFlag3D::Array},
+    {"cube map array, second cube", "dxt10-r8snorm-cube-array.dds", 0, 6, 6,
+        6, ImageFlag3D::CubeMap|ImageFlag3D::Array},
+};
+
+const struct {
+    const char* name;
+    const char* filename;
+    bool assumeYUp;
+    UnsignedInt level;
+    UnsignedInt layerOffset, layerCount;
+    bool referenced;
+} ReferenceDataData[]{
+    {"array, single level", "dxt10-rgba8unorm-array.dds", true, 0, 0, 0,
+        true},
+    {"array, flipped", "dxt10-rgba8unorm-array.dds", false, 0, 0, 0,
+        false},
+    {"3D", "rgba8unorm-3d-yup-zbackward.dds", true, 0, 0, 0,
+        true},
+    {"3D, swizzled", "bgra8unorm-3d.dds", true, 0, 0, 0,
+        false},
+    /* This one can't be flipped, so the orientation doesn't matter */
+    {"compressed cube map, second level, one face", "dxt1-cube-mips.dds", false, 1, 3, 1,
+        true},
+    {"compressed cube map, second level, all faces", "dxt1-cube-mips.dds", false, 1, 0, 0,
+        false},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -472,24 +554,29 @@ DdsImporterTest::DdsImporterTest() {
               &DdsImporterTest::rgbMipsDxt10});
 
     addInstancedTests({&DdsImporterTest::dxt3},
-        Containers::arraySize(CompressedFlipWarningData));
+        Containers::arraySize(CompressedFlipData));
 
     addTests({&DdsImporterTest::dxt3IncompleteBlocks,
               &DdsImporterTest::bc4,
-              &DdsImporterTest::bc7Dxt10,
+              &DdsImporterTest::bc7Dxt10});
 
-              &DdsImporterTest::rg1DDxt10,
+    addInstancedTests({&DdsImporterTest::compressedFlipWarning},
+        Containers::arraySize(CompressedFlipWarningData));
+
+    addTests({&DdsImporterTest::rg1DDxt10,
               &DdsImporterTest::rg1DArrayMipsDxt10,
               &DdsImporterTest::rgbaArrayDxt10,
               &DdsImporterTest::rgbaCube,
               &DdsImporterTest::rCubeDxt10,
-              &DdsImporterTest::rCubeArrayDxt10,
-              &DdsImporterTest::dxt1CubeMips,
-              &DdsImporterTest::bc7CubeMipsDxt10});
+              &DdsImporterTest::rCubeArrayDxt10});
 
     addInstancedTests({&DdsImporterTest::rgba3D},
         Containers::arraySize(SwizzleFlipRgba3DData));
 
+    addTests({&DdsImporterTest::dxt13D,
+              &DdsImporterTest::dxt1CubeMips,
+              &DdsImporterTest::bc7CubeMipsDxt10});
+
     addTests({&DdsImporterTest::extraDataAtTheEnd,
               &DdsImporterTest::incompleteCubeMap});
 
@@ -503,7 +590,20 @@ DdsImporterTest::DdsImporterTest() {
         Containers::arraySize(OpenMemoryData));
 
     addTests({&DdsImporterTest::openTwice,
-              &DdsImporterTest::importTwice});
+              &DdsImporterTest::importTwice,
+
+              &DdsImporterTest::mapFile,
+              &DdsImporterTest::mapFileNotFound,
+              &DdsImporterTest::mapFileMessagePrefix});
+
+    addInstancedTests({&DdsImporterTest::layerRange},
+        Containers::arraySize(LayerRangeData));
+
+    addTests({&DdsImporterTest::layerRangeOutOfBounds,
+              &DdsImporterTest::layerRangeNotLayered});
+
+    addInstancedTests({&DdsImporterTest::referenceData},
+        Containers::arraySize(ReferenceDataData));
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -725,16 +825,18 @@ void DdsImporterTest::rgbMipsDxt10() {
 }
 
 void DdsImporterTest::dxt3() {
-    auto&& data = CompressedFlipWarningData[testCaseInstanceId()];
+    auto&& data = CompressedFlipData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
 
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->setFlags(data.flags);
     if(data.assumeYUp)
         importer->configuration().setValue("assumeYUpZBackward", *data.assumeYUp);
     else
         CORRADE_COMPARE(importer->configuration().value("assumeYUpZBackward"), "false");
     std::ostringstream out;
     {
+        Debug redirectOutput{&out};
         Warning redirectWarning{&out};
         CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt3.dds")));
     }
@@ -750,7 +852,24 @@ void DdsImporterTest::dxt3() {
     CORRADE_COMPARE(image->flags(), ImageFlags2D{});
     CORRADE_COMPARE(image->size(), (Vector2i{64, 32}));
     CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc2RGBAUnorm);
-    /* Verify just a small prefix and suffix to be sure the data got copied */
+
+    /* Verify just a small prefix and suffix to be sure the data got copied.
+       When flipped, the first block is the first block of the last block row
+       in the file, with both the alpha and color rows in reverse order, and
+       vice versa. */
+    if(data.flipped) {
+        CORRADE_COMPARE_AS(image->data().prefix(16), Containers::array({
+            '\x88', '\x88', '\x88', '\x88', '\x88', '\x88', '\x88', '\x88',
+            '\x65', '\xc6', '\x66', '\xc6', '\xaa', '\x55', '\xaa', '\xaa'
+        }), TestSuite::Compare::Container);
+        /** @todo suffix() once it takes N last bytes */
+        CORRADE_COMPARE_AS(image->data().exceptPrefix(image->data().size() - 16), Containers::array({
+            '\xdd', '\xdd', '\xdd', '\xdd', '\xdd', '\xdd', '\xdd', '\xdd',
+            '\x19', '\x34', '\x38', '\x2c', '\xaa', '\xaa', '\xaa', '\xaa'
+        }), TestSuite::Compare::Container);
+        return;
+    }
+
     CORRADE_COMPARE_AS(image->data().prefix(16), Containers::array({
         '\x22', '\x22', '\x22', '\x22', '\x22', '\x22', '\x22', '\x22',
         '\xc6', '\xd1', '\x86', '\xc1', '\xaa', '\xff', '\xaa', '\xff'
@@ -802,8 +921,11 @@ void DdsImporterTest::bc4() {
     CORRADE_COMPARE(image->flags(), ImageFlags2D{});
     CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
     CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc4RUnorm);
+    /* The file has 08 10 24 08 10 24, i.e. 12-bit rows 008 241 008 241. The
+       image is just two pixels high, so only the first two rows get swapped,
+       leaving the unused rest as-is. */
     CORRADE_COMPARE_AS(image->data(), Containers::array({
-        '\xde', '\xca', '\x08', '\x10', '\x24', '\x08', '\x10', '\x24'
+        '\xde', '\xca', '\x41', '\x82', '\x00', '\x08', '\x10', '\x24'
     }), TestSuite::Compare::Container);
 }
 
@@ -833,6 +955,24 @@ void DdsImporterTest::bc7Dxt10() {
     }), TestSuite::Compare::Container);
 }
 
+void DdsImporterTest::compressedFlipWarning() {
+    auto&& data = CompressedFlipWarningData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Data import for these is tested in bc7Dxt10(), dxt3IncompleteBlocks()
+       and dxt1CubeMips(), here just verifying the warning gets printed */
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    if(data.assumeYUp)
+        importer->configuration().setValue("assumeYUpZBackward", *data.assumeYUp);
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename)));
+    }
+    CORRADE_COMPARE(out.str(), data.message);
+}
+
 void DdsImporterTest::rg1DDxt10() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-rg16f-1d.dds")));
@@ -1204,6 +1344,37 @@ void DdsImporterTest::incompleteCubeMap() {
     #endif
 }
 
+void DdsImporterTest::dxt13D() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt1-3d.dds")));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openData(): image will be flipped along y and z\n");
+    CORRADE_COMPARE(importer->image1DCount(), 0);
+    CORRADE_COMPARE(importer->image2DCount(), 0);
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+    CORRADE_COMPARE(importer->image3DLevelCount(0), 1);
+
+    Containers::Optional<ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->flags(), ImageFlags3D{});
+    CORRADE_COMPARE(image->size(), (Vector3i{4, 8, 2}));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    /* The file has two slices of two block rows, with the block bytes
+       numbered 0x00 to 0x37 in order. Both the blocks and the index rows in
+       them are expected in reverse order, endpoints stay the same. */
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
+        '\x30', '\x31', '\x32', '\x33', '\x37', '\x36', '\x35', '\x34',
+        '\x20', '\x21', '\x22', '\x23', '\x27', '\x26', '\x25', '\x24',
+        '\x10', '\x11', '\x12', '\x13', '\x17', '\x16', '\x15', '\x14',
+        '\x00', '\x01', '\x02', '\x03', '\x07', '\x06', '\x05', '\x04'
+    }), TestSuite::Compare::Container);
+}
+
 void DdsImporterTest::dxt1CubeMips() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt1-cube-mips.dds")));
@@ -1405,8 +1576,9 @@ void DdsImporterTest::openMemory() {
     CORRADE_COMPARE(image->flags(), ImageFlags2D{});
     CORRADE_COMPARE(image->size(), Vector2i(3, 2));
     CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    /* Two-pixel-high image, so the first two index rows are swapped */
     CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
-        '\xee', '\xcf', '\x76', '\xdd', '\x51', '\x04', '\x51', '\x04'
+        '\xee', '\xcf', '\x76', '\xdd', '\x04', '\x51', '\x51', '\x04'
     }), TestSuite::Compare::Container);
 }
 
@@ -1435,6 +1607,176 @@ void DdsImporterTest::importTwice() {
     }
 }
 
+void DdsImporterTest::mapFile() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("File mapping is not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("mapFile", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-rgba8unorm-array.dds")));
+    CORRADE_COMPARE(importer->image3DCount(), 1);
+
+    /* Compared to rgbaArrayDxt10() the data should be the same */
+    Containers::Optional<ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlag3D::Array);
+    CORRADE_COMPARE(image->size(), (Vector3i{5, 5, 3}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->data().prefix(8), Containers::array({
+        /* First two pixels of the bottom row of the first slice */
+        '\xc7', '\xcc', '\x2f', '\x7f', '\xcb', '\x5d', '\x31', '\x9d'
+    }), TestSuite::Compare::Container);
+    /** @todo suffix() once it takes N last bytes */
+    CORRADE_COMPARE_AS(image->data().exceptPrefix(image->data().size() - 8), Containers::array({
+        /* Last two pixels of the top row of the last slice */
+        '\x3d', '\x7c', '\xbe', '\x9d', '\xc4', '\x39', '\x39', '\x2c'
+    }), TestSuite::Compare::Container);
+
+    /* Closing should unmap the file and not crash */
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+    #endif
+}
+
+void DdsImporterTest::mapFileNotFound() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("File mapping is not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("mapFile", true);
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->openFile("nonexistent.dds"));
+    }
+    /* There's an error from Path::mapRead() before */
+    CORRADE_COMPARE_AS(out.str(),
+        "\nTrade::DdsImporter::openFile(): cannot map file nonexistent.dds\n",
+        TestSuite::Compare::StringHasSuffix);
+    #endif
+}
+
+void DdsImporterTest::mapFileMessagePrefix() {
+    #if !defined(CORRADE_TARGET_UNIX) && (!defined(CORRADE_TARGET_WINDOWS) || defined(CORRADE_TARGET_WINDOWS_RT))
+    CORRADE_SKIP("File mapping is not available on this platform.");
+    #else
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("mapFile", true);
+
+    /* Messages printed while parsing a mapped file should mention the
+       function that was actually called, compared to incompleteCubeMap() */
+    std::ostringstream out;
+    {
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "rgba8unorm-cube-incomplete.dds")));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openFile(): the image is an incomplete cubemap, importing faces as 5 array layers\n");
+    #endif
+}
+
+void DdsImporterTest::layerRange() {
+    auto&& data = LayerRangeData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Import the whole image first to compare against */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename)));
+    Containers::Optional<ImageData3D> all = importer->image3D(0, data.level);
+    CORRADE_VERIFY(all);
+
+    importer->configuration().setValue("layerOffset", data.layerOffset);
+    importer->configuration().setValue("layerCount", data.layerCount);
+    Containers::Optional<ImageData3D> image = importer->image3D(0, data.level);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), data.expectedFlags);
+    CORRADE_COMPARE(image->size(), (Vector3i{all->size().xy(), data.expectedLayerCount}));
+    CORRADE_COMPARE(image->isCompressed(), all->isCompressed());
+    CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    const std::size_t layerSize = all->data().size()/all->size().z();
+    CORRADE_COMPARE_AS(image->data(),
+        all->data().slice(data.layerOffset*layerSize, (data.layerOffset + data.expectedLayerCount)*layerSize),
+        TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::layerRangeOutOfBounds() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-rgba8unorm-array.dds")));
+    importer->configuration().setValue("layerOffset", 2);
+    importer->configuration().setValue("layerCount", 2);
+    CORRADE_VERIFY(!importer->image3D(0));
+    importer->configuration().setValue("layerOffset", 3);
+    importer->configuration().setValue("layerCount", 0);
+    CORRADE_VERIFY(!importer->image3D(0));
+
+    /* The end of the range would overflow to 0 */
+    importer->configuration().setValue("layerOffset", 0xffffffffu);
+    importer->configuration().setValue("layerCount", 1);
+    CORRADE_VERIFY(!importer->image3D(0));
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "dxt10-rg16f-1d-array-mips.dds")));
+    importer->configuration().setValue("layerOffset", 0);
+    importer->configuration().setValue("layerCount", 17);
+    CORRADE_VERIFY(!importer->image2D(0));
+
+    CORRADE_COMPARE(out.str(),
+        "Trade::DdsImporter::image3D(): layer range 2 to 4 out of bounds for 3 layers\n"
+        "Trade::DdsImporter::image3D(): layer range 3 to 3 out of bounds for 3 layers\n"
+        "Trade::DdsImporter::image3D(): layer range 4294967295 to 4294967296 out of bounds for 3 layers\n"
+        "Trade::DdsImporter::image2D(): layer range 0 to 17 out of bounds for 2 layers\n");
+}
+
+void DdsImporterTest::layerRangeNotLayered() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    /* Would be out of bounds for a layered image */
+    importer->configuration().setValue("layerOffset", 5);
+    importer->configuration().setValue("layerCount", 3);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(DDSIMPORTER_TEST_DIR, "rgba8unorm-3d.dds")));
+
+    Containers::Optional<ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->flags(), ImageFlags3D{});
+    CORRADE_COMPARE(image->size(), (Vector3i{3, 2, 3}));
+}
+
+void DdsImporterTest::referenceData() {
+    auto&& data = ReferenceDataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(DDSIMPORTER_TEST_DIR, data.filename));
+    CORRADE_VERIFY(memory);
+
+    /* Import a copy first to compare against */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("assumeYUpZBackward", data.assumeYUp);
+    importer->configuration().setValue("layerOffset", data.layerOffset);
+    importer->configuration().setValue("layerCount", data.layerCount);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    Containers::Optional<ImageData3D> copy = importer->image3D(0, data.level);
+    CORRADE_VERIFY(copy);
+    CORRADE_COMPARE(copy->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    importer->configuration().setValue("referenceData", true);
+    Containers::Optional<ImageData3D> image = importer->image3D(0, data.level);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), copy->size());
+    CORRADE_COMPARE(image->flags(), copy->flags());
+    CORRADE_COMPARE_AS(image->data(), copy->data(),
+        TestSuite::Compare::Container);
+
+    if(data.referenced) {
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        CORRADE_VERIFY(isViewOn(image->data(), *memory));
+    } else {
+        CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::DdsImporterTest)
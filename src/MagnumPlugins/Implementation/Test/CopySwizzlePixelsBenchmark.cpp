@@ -0,0 +1,143 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/EndiannessBatch.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Math/Swizzle.h>
+#include <Magnum/Math/Vector4.h>
+
+#include "MagnumPlugins/Implementation/copySwizzlePixels.h"
+
+namespace Magnum { namespace Trade { namespace Implementation { namespace Test { namespace {
+
+struct CopySwizzlePixelsBenchmark: TestSuite::Tester {
+    explicit CopySwizzlePixelsBenchmark();
+
+    void separatePasses();
+    void singlePass();
+
+    private:
+        Containers::Array<char> _in, _out;
+};
+
+/* Formats the importers swizzle. 16-bit types need the endian swap on
+   big-endian platforms, on little-endian platforms it's a no-op. */
+const struct {
+    const char* name;
+    UnsignedInt typeSize, channelCount;
+} FormatData[]{
+    {"BGR8", 1, 3},
+    {"BGRA8", 1, 4},
+    {"BGR16", 2, 3},
+    {"BGRA16", 2, 4}
+};
+
+const struct {
+    const char* name;
+    Cpu::Features features;
+} FeaturesData[]{
+    {"scalar", Cpu::Features{}},
+    #ifdef CORRADE_ENABLE_SSSE3
+    {"SSSE3", Cpu::Ssse3},
+    #endif
+    #ifdef CORRADE_ENABLE_AVX2
+    {"AVX2", Cpu::Ssse3|Cpu::Avx2},
+    #endif
+    #ifdef MAGNUM_TRADE_COPYSWIZZLEPIXELS_NEON
+    {"NEON", Cpu::Neon},
+    #endif
+};
+
+constexpr std::size_t Size = 1024;
+
+CopySwizzlePixelsBenchmark::CopySwizzlePixelsBenchmark() {
+    addInstancedBenchmarks({&CopySwizzlePixelsBenchmark::separatePasses}, 10,
+        Containers::arraySize(FormatData));
+
+    addInstancedBenchmarks({&CopySwizzlePixelsBenchmark::singlePass}, 10,
+        Containers::arraySize(FormatData)*Containers::arraySize(FeaturesData));
+
+    /* A Y-flipped 1024x1024 image of the largest pixel size */
+    _in = Containers::Array<char>{NoInit, Size*Size*8};
+    for(std::size_t i = 0; i != _in.size(); ++i)
+        _in[i] = char(i*7 + 3);
+    _out = Containers::Array<char>{ValueInit, _in.size()};
+}
+
+template<class T> void swizzlePixels(const Containers::ArrayView<char> data, const UnsignedInt channelCount) {
+    if(channelCount == 3) {
+        for(Math::Vector3<T>& pixel: Containers::arrayCast<Math::Vector3<T>>(data))
+            pixel = Math::gather<'b', 'g', 'r'>(pixel);
+    } else if(channelCount == 4) {
+        for(Math::Vector4<T>& pixel: Containers::arrayCast<Math::Vector4<T>>(data))
+            pixel = Math::gather<'b', 'g', 'r', 'a'>(pixel);
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+}
+
+void CopySwizzlePixelsBenchmark::separatePasses() {
+    auto&& data = FormatData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* What the importers did before, a flipping copy followed by an endian
+       swap and a swizzle pass over the output */
+    const std::size_t pixelSize = data.typeSize*data.channelCount;
+    const Containers::StridedArrayView4D<const char> src = Containers::StridedArrayView4D<const char>{_in.prefix(Size*Size*pixelSize), {1, Size, Size, pixelSize}}.flipped<1>();
+    const Containers::ArrayView<char> out = _out.prefix(Size*Size*pixelSize);
+    CORRADE_BENCHMARK(1) {
+        Utility::copy(src, Containers::StridedArrayView4D<char>{out, src.size()});
+        if(data.typeSize == 1)
+            swizzlePixels<UnsignedByte>(out, data.channelCount);
+        else if(data.typeSize == 2) {
+            Utility::Endianness::littleEndianInPlace(Containers::arrayCast<UnsignedShort>(out));
+            swizzlePixels<UnsignedShort>(out, data.channelCount);
+        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    }
+
+    CORRADE_COMPARE(out[0], _in[(Size - 1)*Size*pixelSize + 2*data.typeSize]);
+}
+
+void CopySwizzlePixelsBenchmark::singlePass() {
+    auto&& format = FormatData[testCaseInstanceId()/Containers::arraySize(FeaturesData)];
+    auto&& features = FeaturesData[testCaseInstanceId()%Containers::arraySize(FeaturesData)];
+    setTestCaseDescription(Utility::format("{}, {}", format.name, features.name));
+
+    if((features.features & Cpu::runtimeFeatures()) != features.features)
+        CORRADE_SKIP(features.name << "not supported on this machine");
+
+    const std::size_t pixelSize = format.typeSize*format.channelCount;
+    const Containers::StridedArrayView4D<const char> src = Containers::StridedArrayView4D<const char>{_in.prefix(Size*Size*pixelSize), {1, Size, Size, pixelSize}}.flipped<1>();
+    const Containers::ArrayView<char> out = _out.prefix(Size*Size*pixelSize);
+    CORRADE_BENCHMARK(1)
+        copySwizzlePixels(src, Containers::StridedArrayView4D<char>{out, src.size()}, format.typeSize, true, features.features);
+
+    CORRADE_COMPARE(out[0], _in[(Size - 1)*Size*pixelSize + 2*format.typeSize]);
+}
+
+}}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Implementation::Test::CopySwizzlePixelsBenchmark)
@@ -0,0 +1,176 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Format.h>
+
+#include "MagnumPlugins/Implementation/copySwizzlePixels.h"
+
+namespace Magnum { namespace Trade { namespace Implementation { namespace Test { namespace {
+
+struct CopySwizzlePixelsTest: TestSuite::Tester {
+    explicit CopySwizzlePixelsTest();
+
+    void mask();
+
+    void copy();
+    void copyFlipped();
+};
+
+const struct {
+    const char* name;
+    Cpu::Features features;
+} FeaturesData[]{
+    {"scalar", Cpu::Features{}},
+    #ifdef CORRADE_ENABLE_SSSE3
+    {"SSSE3", Cpu::Ssse3},
+    #endif
+    #ifdef CORRADE_ENABLE_AVX2
+    {"AVX2", Cpu::Ssse3|Cpu::Avx2},
+    #endif
+    #ifdef MAGNUM_TRADE_COPYSWIZZLEPIXELS_NEON
+    {"NEON", Cpu::Neon},
+    #endif
+};
+
+CopySwizzlePixelsTest::CopySwizzlePixelsTest() {
+    addTests({&CopySwizzlePixelsTest::mask});
+
+    addInstancedTests({&CopySwizzlePixelsTest::copy,
+                       &CopySwizzlePixelsTest::copyFlipped},
+        Containers::arraySize(FeaturesData));
+}
+
+/* Reference implementation, going byte by byte */
+Containers::Array<char> expected(const Containers::StridedArrayView4D<const char>& src, const UnsignedInt typeSize, const bool swizzle) {
+    const std::size_t pixelSize = src.size()[3];
+    Containers::Array<char> out{NoInit, src.size()[0]*src.size()[1]*src.size()[2]*pixelSize};
+    std::size_t o = 0;
+    for(std::size_t z = 0; z != src.size()[0]; ++z) {
+        for(std::size_t y = 0; y != src.size()[1]; ++y) {
+            for(std::size_t x = 0; x != src.size()[2]; ++x) {
+                for(std::size_t i = 0; i != pixelSize; ++i) {
+                    const std::size_t channel = i/typeSize;
+                    std::size_t byte = i%typeSize;
+                    std::size_t srcChannel = channel;
+                    if(swizzle && channel == 0) srcChannel = 2;
+                    else if(swizzle && channel == 2) srcChannel = 0;
+                    #ifdef CORRADE_TARGET_BIG_ENDIAN
+                    byte = typeSize - byte - 1;
+                    #endif
+                    out[o++] = src[z][y][x][srcChannel*typeSize + byte];
+                }
+            }
+        }
+    }
+    return out;
+}
+
+void CopySwizzlePixelsTest::mask() {
+    char mask[16];
+
+    copySwizzlePixelsMask(3, 1, mask);
+    CORRADE_COMPARE_AS(Containers::arrayView(mask), Containers::arrayView<char>({
+        2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15
+    }), TestSuite::Compare::Container);
+
+    copySwizzlePixelsMask(8, 2, mask);
+    CORRADE_COMPARE_AS(Containers::arrayView(mask), Containers::arrayView<char>({
+        4, 5, 2, 3, 0, 1, 6, 7, 12, 13, 10, 11, 8, 9, 14, 15
+    }), TestSuite::Compare::Container);
+
+    /* Only one whole pixel fits, the rest stays in place */
+    copySwizzlePixelsMask(12, 4, mask);
+    CORRADE_COMPARE_AS(Containers::arrayView(mask), Containers::arrayView<char>({
+        8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15
+    }), TestSuite::Compare::Container);
+}
+
+void CopySwizzlePixelsTest::copy() {
+    auto&& data = FeaturesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if((data.features & Cpu::runtimeFeatures()) != data.features)
+        CORRADE_SKIP(data.name << "not supported on this machine");
+
+    /* Widths around and past the SIMD block sizes, for all supported type and
+       channel counts */
+    for(const UnsignedInt typeSize: {1u, 2u, 4u}) {
+        for(const UnsignedInt channelCount: {3u, 4u}) {
+            for(const bool swizzle: {false, true}) {
+                for(std::size_t width: {0, 1, 5, 10, 11, 16, 17, 33}) {
+                    CORRADE_ITERATION(Utility::format("{}-byte type, {} channels, {}swizzle, width {}", typeSize, channelCount, swizzle ? "" : "no ", width));
+
+                    const std::size_t pixelSize = typeSize*channelCount;
+                    Containers::Array<char> in{NoInit, 2*3*width*pixelSize};
+                    for(std::size_t i = 0; i != in.size(); ++i)
+                        in[i] = char(i*7 + 3);
+                    Containers::Array<char> out{ValueInit, in.size()};
+
+                    const Containers::StridedArrayView4D<const char> src{in, {2, 3, width, pixelSize}};
+                    copySwizzlePixels(src, Containers::StridedArrayView4D<char>{out, src.size()}, typeSize, swizzle, data.features);
+                    CORRADE_COMPARE_AS(out, expected(src, typeSize, swizzle),
+                        TestSuite::Compare::Container);
+                }
+            }
+        }
+    }
+}
+
+void CopySwizzlePixelsTest::copyFlipped() {
+    auto&& data = FeaturesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if((data.features & Cpu::runtimeFeatures()) != data.features)
+        CORRADE_SKIP(data.name << "not supported on this machine");
+
+    /* The importers flip along Y and Z, which keeps the rows contiguous.
+       Flipping along X makes each pixel processed separately. */
+    for(const UnsignedInt typeSize: {1u, 2u, 4u}) {
+        for(const UnsignedInt channelCount: {3u, 4u}) {
+            for(const bool flipX: {false, true}) {
+                CORRADE_ITERATION(Utility::format("{}-byte type, {} channels, {}flipped along X", typeSize, channelCount, flipX ? "" : "not "));
+
+                const std::size_t pixelSize = typeSize*channelCount;
+                Containers::Array<char> in{NoInit, 2*3*19*pixelSize};
+                for(std::size_t i = 0; i != in.size(); ++i)
+                    in[i] = char(i*5 + 1);
+                Containers::Array<char> out{ValueInit, in.size()};
+
+                Containers::StridedArrayView4D<const char> src = Containers::StridedArrayView4D<const char>{in, {2, 3, 19, pixelSize}}.flipped<0>().flipped<1>();
+                if(flipX) src = src.flipped<2>();
+                copySwizzlePixels(src, Containers::StridedArrayView4D<char>{out, src.size()}, typeSize, true, data.features);
+                CORRADE_COMPARE_AS(out, expected(src, typeSize, true),
+                    TestSuite::Compare::Container);
+            }
+        }
+    }
+}
+
+}}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Implementation::Test::CopySwizzlePixelsTest)
@@ -0,0 +1,228 @@
+#ifndef Magnum_Trade_Implementation_Test_MeshImporterBenchmark_h
+#define Magnum_Trade_Implementation_Test_MeshImporterBenchmark_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Common scaffolding of the StanfordImporter, StlImporter and OpenGexImporter
+   benchmarks. As it replaces the global operator new, it's meant to be
+   included in exactly one source file of a benchmark executable. */
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
+
+/* Counting allocations by replacing the global operator new. Only
+   allocations going through new / new[] are counted, growable arrays that
+   use std::malloc() directly are not. With a dynamic plugin the replacement
+   applies only if the platform resolves the plugin's operator new to the
+   executable, which is the case on ELF platforms. */
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+std::size_t liveAllocationCount = 0;
+std::size_t peakLiveAllocationCount = 0;
+
+void* allocate(std::size_t size) noexcept {
+    if(++liveAllocationCount > peakLiveAllocationCount)
+        peakLiveAllocationCount = liveAllocationCount;
+    return std::malloc(size ? size : 1);
+}
+
+void deallocate(void* pointer) noexcept {
+    if(!pointer) return;
+    --liveAllocationCount;
+    std::free(pointer);
+}
+
+}}}}
+
+void* operator new(std::size_t size) {
+    if(void* pointer = Magnum::Trade::Test::allocate(size)) return pointer;
+    throw std::bad_alloc{};
+}
+void* operator new[](std::size_t size) {
+    if(void* pointer = Magnum::Trade::Test::allocate(size)) return pointer;
+    throw std::bad_alloc{};
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Trade::Test::allocate(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Magnum::Trade::Test::allocate(size);
+}
+void operator delete(void* pointer) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { Magnum::Trade::Test::deallocate(pointer); }
+#endif
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Measures openData() time, mesh() time per megabyte of input (the Tester
+   has no rate unit, so throughput is reported as its inverse) and the peak
+   count of live allocations during a mesh() call, for each generated file.
+   The derived class fills _files in its constructor, loads the plugin and
+   implements instanceName() and optionally configure(). */
+struct MeshImporterBenchmark: TestSuite::Tester {
+    explicit MeshImporterBenchmark(const char* plugin, std::size_t instanceCount);
+
+    void openData();
+    void meshThroughput();
+    void meshPeakAllocations();
+
+    void throughputBegin();
+    std::uint64_t throughputEnd();
+    void peakAllocationsBegin();
+    std::uint64_t peakAllocationsEnd();
+
+    virtual Containers::StringView instanceName(std::size_t id) const = 0;
+    /* Called on each importer instance before the file is opened */
+    virtual void configure(AbstractImporter&, std::size_t) const {}
+
+    Containers::Pointer<AbstractImporter> openedImporter();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    const char* _plugin;
+    UnsignedInt _faceCount;
+    Containers::Array<Containers::Array<char>> _files;
+    std::size_t _processedSize;
+    std::chrono::high_resolution_clock::time_point _begin;
+    std::size_t _allocationsBegin;
+};
+
+MeshImporterBenchmark::MeshImporterBenchmark(const char* const plugin, const std::size_t instanceCount): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"benchmark"})}, _plugin{plugin} {
+    Utility::Arguments args{"benchmark"};
+    args.addOption("face-count", "10000").setHelp("face-count", "face count in generated files", "N")
+        .parse(arguments().first, arguments().second);
+    _faceCount = args.value<UnsignedInt>("face-count");
+
+    addInstancedBenchmarks({&MeshImporterBenchmark::openData}, 10,
+        instanceCount);
+
+    addCustomInstancedBenchmarks({&MeshImporterBenchmark::meshThroughput}, 10,
+        instanceCount,
+        &MeshImporterBenchmark::throughputBegin,
+        &MeshImporterBenchmark::throughputEnd,
+        BenchmarkUnits::Nanoseconds);
+
+    addCustomInstancedBenchmarks({&MeshImporterBenchmark::meshPeakAllocations}, 1,
+        instanceCount,
+        &MeshImporterBenchmark::peakAllocationsBegin,
+        &MeshImporterBenchmark::peakAllocationsEnd,
+        BenchmarkUnits::Count);
+
+    _files = Containers::Array<Containers::Array<char>>{instanceCount};
+}
+
+void MeshImporterBenchmark::openData() {
+    const Containers::ArrayView<const char> file = _files[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {} kB", instanceName(testCaseInstanceId()), file.size()/1024));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(_plugin);
+    configure(*importer, testCaseInstanceId());
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData(file);
+
+    CORRADE_VERIFY(opened);
+}
+
+Containers::Pointer<AbstractImporter> MeshImporterBenchmark::openedImporter() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate(_plugin);
+    configure(*importer, testCaseInstanceId());
+    if(!importer->openData(_files[testCaseInstanceId()])) return {};
+    return importer;
+}
+
+void MeshImporterBenchmark::meshThroughput() {
+    const Containers::ArrayView<const char> file = _files[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {} kB, time per MB", instanceName(testCaseInstanceId()), file.size()/1024));
+
+    Containers::Pointer<AbstractImporter> importer = openedImporter();
+    CORRADE_VERIFY(importer);
+    _processedSize = file.size();
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1)
+        mesh = importer->mesh(0);
+
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Position), 1);
+}
+
+void MeshImporterBenchmark::meshPeakAllocations() {
+    const Containers::ArrayView<const char> file = _files[testCaseInstanceId()];
+    setTestCaseDescription(Utility::format("{}, {} kB", instanceName(testCaseInstanceId()), file.size()/1024));
+
+    Containers::Pointer<AbstractImporter> importer = openedImporter();
+    CORRADE_VERIFY(importer);
+
+    /* The returned mesh is destroyed at the end of the benchmark run, so
+       its own allocations are included in the peak as well */
+    bool imported = false;
+    CORRADE_BENCHMARK(1)
+        imported = !!importer->mesh(0);
+
+    CORRADE_VERIFY(imported);
+}
+
+void MeshImporterBenchmark::throughputBegin() {
+    _begin = std::chrono::high_resolution_clock::now();
+}
+
+std::uint64_t MeshImporterBenchmark::throughputEnd() {
+    const std::uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - _begin).count();
+    /* Time needed to process one megabyte, i.e. an inverse of the MB/s
+       throughput */
+    return nanoseconds*1024*1024/_processedSize;
+}
+
+void MeshImporterBenchmark::peakAllocationsBegin() {
+    _allocationsBegin = liveAllocationCount;
+    peakLiveAllocationCount = liveAllocationCount;
+}
+
+std::uint64_t MeshImporterBenchmark::peakAllocationsEnd() {
+    return peakLiveAllocationCount - _allocationsBegin;
+}
+
+}}}}
+
+#endif
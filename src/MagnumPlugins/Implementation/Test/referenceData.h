@@ -0,0 +1,44 @@
+#ifndef Magnum_Trade_Implementation_Test_referenceData_h
+#define Magnum_Trade_Implementation_Test_referenceData_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Shared by the referenceData() tests of image importers that implement the
+   referenceData option, i.e. AstcImporter, DdsImporter and KtxImporter. */
+
+#include <Corrade/Containers/ArrayView.h>
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+/* Whether the data are a view on (a part of) given memory, as opposed to a
+   copy of it or a view on some importer-owned data */
+inline bool isViewOn(Containers::ArrayView<const char> data, Containers::ArrayView<const char> memory) {
+    return data.data() >= memory.data() &&
+        data.data() + data.size() <= memory.data() + memory.size();
+}
+
+}}}}
+
+#endif
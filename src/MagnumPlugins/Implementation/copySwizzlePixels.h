@@ -0,0 +1,210 @@
+#ifndef Magnum_Trade_Implementation_copySwizzlePixels_h
+#define Magnum_Trade_Implementation_copySwizzlePixels_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Pixel copy with an optional BGR(A) to RGB(A) swizzle and a little-endian to
+   host conversion, done in a single pass over the data. Used by KtxImporter
+   and DdsImporter. */
+
+#include <cstring>
+#include <Corrade/Cpu.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Magnum.h>
+
+#if defined(CORRADE_ENABLE_SSSE3) || defined(CORRADE_ENABLE_AVX2)
+#include <immintrin.h>
+#endif
+/* vqtbl1q_u8() is only on AArch64 */
+#if defined(CORRADE_ENABLE_NEON) && !defined(CORRADE_TARGET_32BIT)
+#define MAGNUM_TRADE_COPYSWIZZLEPIXELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* Byte shuffle mask swapping the first and third channel of all whole pixels
+   that fit into 16 bytes. The remaining bytes are kept in place, the SIMD
+   loops then advance only by the whole pixels and the next iteration
+   overwrites them. */
+inline void copySwizzlePixelsMask(const std::size_t pixelSize, const UnsignedInt typeSize, char(&mask)[16]) {
+    for(std::size_t i = 0; i != 16; ++i)
+        mask[i] = char(i);
+    for(std::size_t pixel = 0; pixel + pixelSize <= 16; pixel += pixelSize) {
+        for(UnsignedInt i = 0; i != typeSize; ++i) {
+            mask[pixel + i] = char(pixel + 2*typeSize + i);
+            mask[pixel + 2*typeSize + i] = char(pixel + i);
+        }
+    }
+}
+
+/* Each of the SIMD variants processes as much of the row as it can without
+   reading or writing past its end and returns the processed byte count, which
+   is always a multiple of the pixel size */
+#ifdef CORRADE_ENABLE_SSSE3
+CORRADE_ENABLE_SSSE3 inline std::size_t copySwizzlePixelsSsse3(const char* const src, char* const dst, const std::size_t size, const std::size_t step, const char(&mask)[16]) {
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    std::size_t i = 0;
+    for(; i + 16 <= size; i += step)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), shuffle));
+    return i;
+}
+#endif
+
+#ifdef CORRADE_ENABLE_AVX2
+/* The shuffle operates on each 128-bit lane separately, so this is used only
+   for pixel sizes that divide 16 */
+CORRADE_ENABLE_AVX2 inline std::size_t copySwizzlePixelsAvx2(const char* const src, char* const dst, const std::size_t size, const char(&mask)[16]) {
+    const __m128i shuffle128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+    const __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(shuffle128), shuffle128, 1);
+    std::size_t i = 0;
+    for(; i + 32 <= size; i += 32)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), shuffle));
+    return i;
+}
+#endif
+
+#ifdef MAGNUM_TRADE_COPYSWIZZLEPIXELS_NEON
+CORRADE_ENABLE_NEON inline std::size_t copySwizzlePixelsNeon(const char* const src, char* const dst, const std::size_t size, const std::size_t step, const char(&mask)[16]) {
+    const uint8x16_t shuffle = vld1q_u8(reinterpret_cast<const std::uint8_t*>(mask));
+    std::size_t i = 0;
+    for(; i + 16 <= size; i += step)
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i), vqtbl1q_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i)), shuffle));
+    return i;
+}
+#endif
+
+/* Scalar variant, used for whatever the SIMD variants didn't process and on
+   big-endian platforms, where it performs the endian swap as well */
+template<class T, UnsignedInt channelCount, bool swizzle> void copySwizzlePixelsScalar(const char* const src, char* const dst, const std::size_t size) {
+    T pixel[channelCount];
+    for(std::size_t i = 0; i < size; i += sizeof(pixel)) {
+        std::memcpy(pixel, src + i, sizeof(pixel));
+        if(swizzle) {
+            const T tmp = pixel[0];
+            pixel[0] = pixel[2];
+            pixel[2] = tmp;
+        }
+        for(T& component: pixel)
+            Utility::Endianness::littleEndianInPlace(component);
+        std::memcpy(dst + i, pixel, sizeof(pixel));
+    }
+}
+
+template<class T> void copySwizzlePixelsScalar(const char* const src, char* const dst, const std::size_t size, const UnsignedInt swizzleChannelCount) {
+    if(swizzleChannelCount == 3)
+        copySwizzlePixelsScalar<T, 3, true>(src, dst, size);
+    else if(swizzleChannelCount == 4)
+        copySwizzlePixelsScalar<T, 4, true>(src, dst, size);
+    else
+        copySwizzlePixelsScalar<T, 1, false>(src, dst, size);
+}
+
+/* Copies src to dst, swapping the first and third channel if swizzle is set
+   and converting each component of typeSize bytes from little endian. The
+   last dimension is pixel bytes. It has to be contiguous in src, dst has to
+   be contiguous entirely; src can be flipped in any other dimension. Only 3-
+   and 4-channel pixels can be swizzled. */
+inline void copySwizzlePixels(const Containers::StridedArrayView4D<const char>& src, const Containers::StridedArrayView4D<char>& dst, const UnsignedInt typeSize, const bool swizzle, const Cpu::Features features = Cpu::runtimeFeatures()) {
+    CORRADE_INTERNAL_ASSERT(src.size() == dst.size());
+    CORRADE_INTERNAL_ASSERT(src.isContiguous<3>() && dst.isContiguous());
+    const std::size_t pixelSize = src.size()[3];
+    CORRADE_INTERNAL_ASSERT(typeSize == 1 || typeSize == 2 || typeSize == 4);
+    CORRADE_INTERNAL_ASSERT(!swizzle || pixelSize == 3*typeSize || pixelSize == 4*typeSize);
+
+    /* Nothing to do except copying, a single memcpy if nothing is flipped */
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    if(!swizzle)
+    #else
+    if(!swizzle && typeSize == 1)
+    #endif
+    {
+        Utility::copy(src, dst);
+        return;
+    }
+
+    const UnsignedInt swizzleChannelCount = swizzle ? pixelSize/typeSize : 0;
+
+    /* The shuffle mask is used by all SIMD variants. They aren't used on
+       big-endian platforms, as those would need an endian swap as well. */
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    char mask[16];
+    const std::size_t step = 16/pixelSize*pixelSize;
+    copySwizzlePixelsMask(pixelSize, typeSize, mask);
+    #endif
+    static_cast<void>(features);
+
+    /* Process whole rows if they're contiguous, otherwise (when flipped along
+       X) each pixel is treated as a separate row */
+    const bool rowContiguous = src.isContiguous<2>();
+    const std::size_t rowSize = rowContiguous ? src.size()[2]*pixelSize : pixelSize;
+    const std::size_t rowsPerLine = rowContiguous ? 1 : src.size()[2];
+    for(std::size_t z = 0; z != src.size()[0]; ++z) {
+        for(std::size_t y = 0; y != src.size()[1]; ++y) {
+            for(std::size_t x = 0; x != rowsPerLine; ++x) {
+                const char* const srcRow = static_cast<const char*>(src[z][y][x].data());
+                char* const dstRow = static_cast<char*>(dst[z][y][x].data());
+
+                std::size_t i = 0;
+                #ifndef CORRADE_TARGET_BIG_ENDIAN
+                if(swizzle) {
+                    #ifdef CORRADE_ENABLE_AVX2
+                    if((features & Cpu::Avx2) && step == 16)
+                        i += copySwizzlePixelsAvx2(srcRow, dstRow, rowSize, mask);
+                    #endif
+                    #ifdef CORRADE_ENABLE_SSSE3
+                    if(features & Cpu::Ssse3)
+                        i += copySwizzlePixelsSsse3(srcRow + i, dstRow + i, rowSize - i, step, mask);
+                    #endif
+                    #ifdef MAGNUM_TRADE_COPYSWIZZLEPIXELS_NEON
+                    if(features & Cpu::Neon)
+                        i += copySwizzlePixelsNeon(srcRow + i, dstRow + i, rowSize - i, step, mask);
+                    #endif
+                }
+                #endif
+
+                switch(typeSize) {
+                    case 1:
+                        copySwizzlePixelsScalar<UnsignedByte>(srcRow + i, dstRow + i, rowSize - i, swizzleChannelCount);
+                        break;
+                    case 2:
+                        copySwizzlePixelsScalar<UnsignedShort>(srcRow + i, dstRow + i, rowSize - i, swizzleChannelCount);
+                        break;
+                    case 4:
+                        copySwizzlePixelsScalar<UnsignedInt>(srcRow + i, dstRow + i, rowSize - i, swizzleChannelCount);
+                        break;
+                    /* No 64-bit pixel formats at the moment */
+                }
+            }
+        }
+    }
+}
+
+}}}
+
+#endif
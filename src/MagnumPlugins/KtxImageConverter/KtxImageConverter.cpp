@@ -26,7 +26,9 @@
 
 #include "KtxImageConverter.h"
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pair.h>
@@ -42,6 +44,10 @@
 
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
+#ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -605,6 +611,26 @@ template<typename Format> Containers::Array<char> fillDataFormatDescriptor(Forma
     return data;
 }
 
+#ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+struct Compressed {
+    const char* error;
+    Containers::Array<char> data;
+    std::size_t size;
+};
+
+/* Gets called from worker threads, so it doesn't print anything on its own */
+template<class View> Compressed compressLevel(const View& image, const std::size_t levelSize, const UnsignedInt typeSize, const Int compressionLevel) {
+    Containers::Array<char> pixels{ValueInit, levelSize};
+    copyPixels(image, pixels);
+    endianSwap(pixels, typeSize);
+
+    Containers::Array<char> out{NoInit, ZSTD_compressBound(levelSize)};
+    const std::size_t size = ZSTD_compress(out.data(), out.size(), pixels.data(), pixels.size(), compressionLevel);
+    if(ZSTD_isError(size)) return {ZSTD_getErrorName(size), nullptr, 0};
+    return {nullptr, std::move(out), size};
+}
+#endif
+
 UnsignedInt leastCommonMultiple(UnsignedInt a, UnsignedInt b) {
     const UnsignedInt product = a*b;
 
@@ -680,7 +706,28 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         return {};
     }
 
-    const Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second());
+    const auto supercompression = configuration.value<Containers::StringView>("supercompression");
+    Implementation::SuperCompressionScheme supercompressionScheme;
+    if(supercompression.isEmpty())
+        supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    else if(supercompression == "zstd"_s) {
+        #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+        supercompressionScheme = Implementation::SuperCompressionScheme::Zstandard;
+        #else
+        Error{} << "Trade::KtxImageConverter::convertToData(): Zstandard supercompression is not supported, the plugin was built without Zstd";
+        return {};
+        #endif
+    } else {
+        Error{} << "Trade::KtxImageConverter::convertToData(): unsupported supercompression scheme" << supercompression;
+        return {};
+    }
+
+    Containers::Array<char> dataFormatDescriptor = fillDataFormatDescriptor(format, vkFormat.second());
+
+    /* The plane byte count has to be 0 for supercompressed data, as the
+       actual unit size is unknown until the data is inflated */
+    if(supercompressionScheme != Implementation::SuperCompressionScheme::None)
+        reinterpret_cast<Implementation::KdfBasicBlockHeader*>(dataFormatDescriptor.data() + sizeof(UnsignedInt))->bytesPlane[0] = 0;
 
     /* Fill key/value data. Values can be any byte-string but we only write
        constant text strings. Keys must be sorted alphabetically.
@@ -803,19 +850,72 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
             return {};
         }
 
-        /* Offset needs to be aligned to the least common multiple of the
-           texel/block size and 4. Not needed with supercompression. */
-        const std::size_t alignment = leastCommonMultiple(unitDataSize, 4);
-        levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
-
         const Vector3i unitCount = (Vector3i::pad(mipSize, 1) + unitSize - Vector3i{1})/unitSize;
         const std::size_t levelSize = unitDataSize*unitCount.product();
 
-        levelIndex[mip].byteOffset = levelOffset;
         levelIndex[mip].byteLength = levelSize;
         levelIndex[mip].uncompressedByteLength = levelSize;
+    }
 
-        levelOffset += levelSize;
+    const UnsignedInt typeSize = formatTypeSize(format);
+
+    #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+    /* Compress the levels. Each level is compressed independently so it can
+       be done in parallel, the levels differ a lot in size so instead of
+       splitting them into equally-sized ranges each thread picks the next
+       level once it's done with the previous one. */
+    Containers::Array<Compressed> compressed;
+    if(supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard) {
+        const Int compressionLevel = configuration.value<Int>("supercompressionLevel");
+        UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+        #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+        /* Without pthreads there's no way to spawn threads */
+        threadCount = 1;
+        #else
+        if(!threadCount) threadCount = std::thread::hardware_concurrency();
+        if(!threadCount) threadCount = 1;
+        #endif
+
+        compressed = Containers::Array<Compressed>{ValueInit, numMipmaps};
+        std::atomic<std::size_t> next{0};
+        auto compressPending = [&]() {
+            for(;;) {
+                const std::size_t mip = next++;
+                if(mip >= numMipmaps) break;
+                compressed[mip] = compressLevel(imageLevels[mip], levelIndex[mip].uncompressedByteLength, typeSize, compressionLevel);
+            }
+        };
+        Containers::Array<std::thread> threads{ValueInit, Math::min(threadCount, numMipmaps) - 1};
+        for(std::thread& thread: threads)
+            thread = std::thread{compressPending};
+        compressPending();
+        for(std::thread& thread: threads)
+            thread.join();
+
+        /* Errors are printed only here as the redirection is thread-local */
+        for(UnsignedInt mip = 0; mip != numMipmaps; ++mip) {
+            if(compressed[mip].error) {
+                Error{} << "Trade::KtxImageConverter::convertToData(): Zstandard compression of level" << mip << "failed:" << compressed[mip].error;
+                return {};
+            }
+
+            levelIndex[mip].byteLength = compressed[mip].size;
+        }
+    }
+    #endif
+
+    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+        const UnsignedInt mip = levelIndex.size() - 1 - i;
+
+        /* Offset needs to be aligned to the least common multiple of the
+           texel/block size and 4. Not needed with supercompression. */
+        if(supercompressionScheme == Implementation::SuperCompressionScheme::None) {
+            const std::size_t alignment = leastCommonMultiple(unitDataSize, 4);
+            levelOffset = (levelOffset + alignment - 1)/alignment*alignment;
+        }
+
+        levelIndex[mip].byteOffset = levelOffset;
+        levelOffset += levelIndex[mip].byteLength;
     }
 
     const std::size_t dataSize = levelOffset;
@@ -829,7 +929,7 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
     Utility::copy(Containers::arrayView(Implementation::KtxFileIdentifier), Containers::arrayView(header.identifier));
 
     header.vkFormat = vkFormat.first();
-    header.typeSize = formatTypeSize(format);
+    header.typeSize = typeSize;
     header.imageSize = Vector3ui{Vector3i::pad(size, 0u)};
     /* Array and cube images have the last dimension 0, instead layer and face
        count is filled. Face count is 6 for cube maps, layer count != 0 only if
@@ -848,15 +948,20 @@ template<UnsignedInt dimensions, template<UnsignedInt, typename> class View> Con
         header.faceCount = 1;
     }
     header.levelCount = levelIndex.size();
-    header.supercompressionScheme = Implementation::SuperCompressionScheme::None;
+    header.supercompressionScheme = supercompressionScheme;
 
     for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
-        const Implementation::KtxLevel& level = levelIndex[i];
-        const auto& image = imageLevels[i];
+        Implementation::KtxLevel& level = levelIndex[i];
         const auto pixels = data.exceptPrefix(level.byteOffset).prefix(level.byteLength);
-        copyPixels(image, pixels);
-
-        endianSwap(pixels, header.typeSize);
+        #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+        if(supercompressionScheme == Implementation::SuperCompressionScheme::Zstandard)
+            Utility::copy(compressed[i].data.prefix(compressed[i].size), pixels);
+        else
+        #endif
+        {
+            copyPixels(imageLevels[i], pixels);
+            endianSwap(pixels, header.typeSize);
+        }
 
         Utility::Endianness::littleEndianInPlace(
             level.byteOffset, level.byteLength,
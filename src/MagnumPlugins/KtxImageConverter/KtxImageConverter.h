@@ -35,6 +35,17 @@
 
 #include "MagnumPlugins/KtxImageConverter/configure.h"
 
+#ifdef DOXYGEN_GENERATING_OUTPUT
+/**
+@brief Whether the KtxImageConverter plugin is built with Zstandard supercompression support
+@m_since_latest_{plugins}
+
+Defined if Zstd was found when building the plugin. See
+@ref Trade-KtxImageConverter-behavior-supercompression for more information.
+*/
+#define MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+#endif
+
 #ifndef DOXYGEN_GENERATING_OUTPUT
 #ifndef MAGNUM_KTXIMAGECONVERTER_BUILD_STATIC
     #ifdef KtxImageConverter_EXPORTS
@@ -121,9 +132,18 @@ supported.
 
 @subsection Trade-KtxImageConverter-behavior-supercompression Supercompression
 
-Saving files with [supercompression](https://github.khronos.org/KTX-Specification/#supercompressionSchemes)
-is not supported. You can however use @ref BasisImageConverter to create
-Basis-supercompressed KTX2 files.
+Files can be saved with [Zstandard supercompression](https://github.khronos.org/KTX-Specification/#zstd)
+by setting the @cb{.ini} supercompression @ce
+@ref Trade-KtxImageConverter-configuration "configuration option" to
+@cb{.ini} zstd @ce. This is available only if the plugin is built with
+[Zstd](https://github.com/facebook/zstd), in which case
+@ref MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD is defined. Each mip level is
+compressed independently, with the compression level given by
+@cb{.ini} supercompressionLevel @ce. If the @cb{.ini} threads @ce option is
+set to a value other than @cpp 1 @ce, the levels are compressed in parallel,
+except on @ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" without pthreads.
+Other supercompression schemes are not supported. You can however use
+@ref BasisImageConverter to create Basis-supercompressed KTX2 files.
 
 @section Trade-KtxImageConverter-configuration Plugin-specific configuration
 
@@ -32,6 +32,7 @@
 #include <Corrade/Containers/Pair.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -51,6 +52,8 @@
 
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
+#include "MagnumPlugins/KtxImageConverter/configure.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -119,6 +122,10 @@ struct KtxImageConverterTest: TestSuite::Tester {
     void configurationEmpty();
     void configurationSorted();
 
+    void supercompression();
+    void supercompressionNotSupported();
+    void supercompressionInvalid();
+
     void convertTwice();
 
     /* Explicitly forbid system-wide plugin dependencies */
@@ -325,6 +332,18 @@ const struct {
     {"invalid characters", "1012", "invalid characters in swizzle 1012"}
 };
 
+const struct {
+    const char* name;
+    Int level;
+    UnsignedInt threads;
+} SupercompressionData[]{
+    {"", 3, 1},
+    {"fastest level", -5, 1},
+    {"highest level", 22, 1},
+    {"2 threads", 3, 2},
+    {"all threads", 3, 0}
+};
+
 Containers::Array<char> readDataFormatDescriptor(Containers::ArrayView<const char> fileData) {
     CORRADE_INTERNAL_ASSERT(fileData.size() >= sizeof(Implementation::KtxHeader));
     const Implementation::KtxHeader& header = *reinterpret_cast<const Implementation::KtxHeader*>(fileData.data());
@@ -420,7 +439,13 @@ KtxImageConverterTest::KtxImageConverterTest() {
     addTests({&KtxImageConverterTest::configurationWriterName,
               &KtxImageConverterTest::configurationWriterNameEmpty,
               &KtxImageConverterTest::configurationEmpty,
-              &KtxImageConverterTest::configurationSorted,
+              &KtxImageConverterTest::configurationSorted});
+
+    addInstancedTests({&KtxImageConverterTest::supercompression},
+        Containers::arraySize(SupercompressionData));
+
+    addTests({&KtxImageConverterTest::supercompressionNotSupported,
+              &KtxImageConverterTest::supercompressionInvalid,
 
               &KtxImageConverterTest::convertTwice});
 
@@ -1436,6 +1461,116 @@ void KtxImageConverterTest::configurationSorted() {
     CORRADE_VERIFY(swizzleOffset.begin() < writerOffset.begin());
 }
 
+void KtxImageConverterTest::supercompression() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+    CORRADE_SKIP("KtxImageConverter was built without Zstd support, cannot test");
+    #else
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "zstd");
+    converter->configuration().setValue("supercompressionLevel", data.level);
+    converter->configuration().setValue("threads", data.threads);
+
+    /* A repetitive pattern that compresses well, the last level is a single
+       pixel */
+    Containers::Array<Color4ub> pixels{NoInit, 64*32 + 32*16 + 16*8 + 8*4 + 4*2 + 2*1 + 1*1};
+    for(std::size_t i = 0; i != pixels.size(); ++i)
+        pixels[i] = Color4ub{UnsignedByte(i%16*16), UnsignedByte(i%7*32), 0x33, 0xff};
+
+    ImageView2D inputImages[7]{
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}},
+        ImageView2D{PixelFormat::RGBA8Unorm, {}}
+    };
+    std::size_t offset = 0;
+    for(UnsignedInt i = 0; i != Containers::arraySize(inputImages); ++i) {
+        const Vector2i size = Math::max(Vector2i{64, 32} >> i, 1);
+        inputImages[i] = ImageView2D{PixelFormat::RGBA8Unorm, size, pixels.exceptPrefix(offset).prefix(size.product())};
+        offset += size.product();
+    }
+    CORRADE_COMPARE(offset, pixels.size());
+
+    Containers::Optional<Containers::Array<char>> output = converter->convertToData(inputImages);
+    CORRADE_VERIFY(output);
+
+    const Implementation::KtxHeader& header = *reinterpret_cast<const Implementation::KtxHeader*>(output->data());
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(header.supercompressionScheme), Implementation::SuperCompressionScheme::Zstandard);
+    CORRADE_COMPARE(Utility::Endianness::littleEndian(header.levelCount), 7);
+
+    /* Plane byte count is required to be 0 for supercompressed data */
+    const Containers::Array<char> dfd = readDataFormatDescriptor(*output);
+    CORRADE_COMPARE(reinterpret_cast<const Implementation::KdfBasicBlockHeader*>(dfd.data() + sizeof(UnsignedInt))->bytesPlane[0], 0);
+
+    /* Levels are stored from the smallest, tightly packed one after another,
+       and the largest compresses to a fraction of its size */
+    const auto levelIndex = Containers::arrayCast<const Implementation::KtxLevel>(output->exceptPrefix(sizeof(Implementation::KtxHeader)).prefix(7*sizeof(Implementation::KtxLevel)));
+    for(UnsignedInt i = 0; i != levelIndex.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(std::size_t(Utility::Endianness::littleEndian(levelIndex[i].uncompressedByteLength)), inputImages[i].data().size());
+        if(i != 0) CORRADE_COMPARE(Utility::Endianness::littleEndian(levelIndex[i].byteOffset) + Utility::Endianness::littleEndian(levelIndex[i].byteLength), Utility::Endianness::littleEndian(levelIndex[i - 1].byteOffset));
+    }
+    CORRADE_COMPARE(std::size_t(Utility::Endianness::littleEndian(levelIndex[0].byteOffset) + Utility::Endianness::littleEndian(levelIndex[0].byteLength)), output->size());
+    CORRADE_COMPARE_AS(std::size_t(Utility::Endianness::littleEndian(levelIndex[0].byteLength)), inputImages[0].data().size()/4,
+        TestSuite::Compare::Less);
+
+    if(_importerManager.loadState("KtxImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("KtxImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("KtxImporter");
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        if(!importer->openData(*output)) {
+            CORRADE_VERIFY(out.str().find("the plugin was built without Zstd") != std::string::npos);
+            CORRADE_SKIP("KtxImporter was built without Zstd support, cannot test");
+        }
+    }
+
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 7);
+    for(UnsignedInt i = 0; i != Containers::arraySize(inputImages); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), inputImages[i].size());
+        CORRADE_COMPARE_AS(image->data(), inputImages[i].data(), TestSuite::Compare::Container);
+    }
+    #endif
+}
+
+void KtxImageConverterTest::supercompressionNotSupported() {
+    #ifdef MAGNUM_KTXIMAGECONVERTER_WITH_ZSTD
+    CORRADE_SKIP("KtxImageConverter was built with Zstd support, cannot test");
+    #else
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "zstd");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    const UnsignedByte bytes[4]{};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, bytes}));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImageConverter::convertToData(): Zstandard supercompression is not supported, the plugin was built without Zstd\n");
+    #endif
+}
+
+void KtxImageConverterTest::supercompressionInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
+    converter->configuration().setValue("supercompression", "zlib");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    const UnsignedByte bytes[4]{};
+    CORRADE_VERIFY(!converter->convertToData(ImageView2D{PixelFormat::RGBA8Unorm, {1, 1}, bytes}));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImageConverter::convertToData(): unsupported supercompression scheme zlib\n");
+}
+
 void KtxImageConverterTest::convertTwice() {
     Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("KtxImageConverter");
 
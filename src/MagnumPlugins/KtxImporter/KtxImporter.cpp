@@ -26,6 +26,8 @@
 
 #include "KtxImporter.h"
 
+#include <atomic>
+#include <thread>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
@@ -38,47 +40,29 @@
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once PluginMetadata is <string>-free */
 #include <Corrade/Utility/Endianness.h>
-#include <Corrade/Utility/EndiannessBatch.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/BitVector.h>
 #include <Magnum/Math/Functions.h>
-#include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector3.h>
-#include <Magnum/Math/Vector4.h>
 #include <Magnum/Trade/ImageData.h>
+#include "MagnumPlugins/Implementation/copySwizzlePixels.h"
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
 
 #ifdef MAGNUM_BUILD_DEPRECATED
 #include <Magnum/Trade/TextureData.h>
 #endif
 
+#ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 namespace {
 
-template<std::size_t> struct TypeForSize {};
-template<> struct TypeForSize<1> { typedef UnsignedByte  Type; };
-template<> struct TypeForSize<2> { typedef UnsignedShort Type; };
-template<> struct TypeForSize<4> { typedef UnsignedInt   Type; };
-template<> struct TypeForSize<8> { typedef UnsignedLong  Type; };
-
-void endianSwap(Containers::ArrayView<char> data, UnsignedInt typeSize) {
-    switch(typeSize) {
-        case 1:
-            /* Single-byte or block-compressed format, nothing to do */
-            return;
-        case 2:
-            Utility::Endianness::littleEndianInPlace(Containers::arrayCast<TypeForSize<2>::Type>(data));
-            return;
-        case 4:
-            Utility::Endianness::littleEndianInPlace(Containers::arrayCast<TypeForSize<4>::Type>(data));
-            return;
-        /* No 64-bit pixel formats at the moment */
-    }
-
-    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-}
-
 enum SwizzleType: UnsignedByte {
     None = 0,
     BGR,
@@ -92,35 +76,6 @@ inline SwizzleType& operator^=(SwizzleType& a, SwizzleType b) {
     return a = SwizzleType(a ^ b);
 }
 
-/** @todo implement these in TextureTools(?) with proper optimizations,
-    together with an ability to endian-swap on the fly */
-template<typename T> void swizzlePixels(SwizzleType type, Containers::ArrayView<char> data) {
-    if(type == SwizzleType::BGR) {
-        for(auto& pixel: Containers::arrayCast<Math::Vector3<T>>(data))
-            pixel = Math::gather<'b', 'g', 'r'>(pixel);
-    } else if(type == SwizzleType::BGRA) {
-        for(auto& pixel: Containers::arrayCast<Math::Vector4<T>>(data))
-            pixel = Math::gather<'b', 'g', 'r', 'a'>(pixel);
-    }
-}
-
-void swizzlePixels(SwizzleType type, UnsignedInt typeSize, Containers::ArrayView<char> data) {
-    switch(typeSize) {
-        case 1:
-            swizzlePixels<TypeForSize<1>::Type>(type, data);
-            return;
-        case 2:
-            swizzlePixels<TypeForSize<2>::Type>(type, data);
-            return;
-        case 4:
-            swizzlePixels<TypeForSize<4>::Type>(type, data);
-            return;
-        /* No 64-bit pixel formats at the moment */
-    }
-
-    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-}
-
 struct Format {
     union {
         PixelFormat uncompressed;
@@ -255,16 +210,77 @@ Containers::Optional<Format> decodeFormat(Implementation::VkFormat vkFormat) {
     return {};
 }
 
+const char* supercompressionSchemeName(const Implementation::SuperCompressionScheme scheme) {
+    switch(scheme) {
+        case Implementation::SuperCompressionScheme::Zstandard:
+            return "Zstandard";
+        case Implementation::SuperCompressionScheme::ZLIB:
+            return "ZLIB";
+        /* BasisLZ is handled by BasisImporter, None isn't decompressed */
+        default:
+            break;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+struct Decompressed {
+    /* Library-provided message if the decompression failed, nullptr
+       otherwise */
+    const char* error;
+    std::size_t size;
+};
+
+/* Gets called from worker threads, so it doesn't print anything on its own */
+Decompressed decompress(const Implementation::SuperCompressionScheme scheme, const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out) {
+    #ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+    if(scheme == Implementation::SuperCompressionScheme::Zstandard) {
+        const std::size_t size = ZSTD_decompress(out.data(), out.size(), in.data(), in.size());
+        if(ZSTD_isError(size)) return {ZSTD_getErrorName(size), 0};
+        return {nullptr, size};
+    }
+    #endif
+
+    #ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+    if(scheme == Implementation::SuperCompressionScheme::ZLIB) {
+        uLongf size = out.size();
+        const int result = uncompress(reinterpret_cast<Bytef*>(out.data()), &size, reinterpret_cast<const Bytef*>(in.data()), in.size());
+        if(result != Z_OK) return {zError(result), 0};
+        return {nullptr, std::size_t(size)};
+    }
+    #endif
+
+    /* Other schemes are rejected in doOpenData() already */
+    static_cast<void>(scheme);
+    static_cast<void>(in);
+    static_cast<void>(out);
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
 }
 
 struct KtxImporter::File {
     struct LevelData {
         Vector3i size;
-        Containers::ArrayView<char> data;
+        /* Location of the image in the (decompressed) level data */
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    struct Level {
+        /* Level data in the file, supercompressed if supercompressionScheme
+           isn't None */
+        Containers::ArrayView<const char> data;
+        std::size_t uncompressedLength;
+        /* Decompressed level data, populated on first access in doImage().
+           Empty if supercompressionScheme is None. */
+        Containers::Array<char> decompressed;
     };
 
     Containers::Array<char> in;
 
+    Implementation::SuperCompressionScheme supercompressionScheme;
+
     /* Dimensions of the source image (1-3) */
     UnsignedByte numDimensions;
     /* Dimensions of the imported image data, including extra dimensions for
@@ -277,6 +293,9 @@ struct KtxImporter::File {
 
     Format pixelFormat;
 
+    /* Data of each mip level, shared by all images */
+    Containers::Array<Level> levels;
+
     /* Usually only one image with n or n+1 dimensions, multiple images for
        3D array layers */
     Containers::Array<Containers::Array<LevelData>> imageData;
@@ -497,11 +516,31 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
         return;
     }
 
-    /** @todo Support supercompression */
-    if(header.supercompressionScheme != Implementation::SuperCompressionScheme::None) {
-        Error{} << "Trade::KtxImporter::openData(): supercompression is currently not supported";
-        return;
+    /* Zstandard and ZLIB supercompressed levels get decompressed on access
+       in doImage(), if the plugin was built with support for them. BasisLZ
+       is only valid for Basis Universal images, which are handled above. */
+    switch(header.supercompressionScheme) {
+        case Implementation::SuperCompressionScheme::None:
+            break;
+        case Implementation::SuperCompressionScheme::Zstandard:
+            #ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+            break;
+            #else
+            Error{} << "Trade::KtxImporter::openData(): Zstandard supercompression is not supported, the plugin was built without Zstd";
+            return;
+            #endif
+        case Implementation::SuperCompressionScheme::ZLIB:
+            #ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+            break;
+            #else
+            Error{} << "Trade::KtxImporter::openData(): ZLIB supercompression is not supported, the plugin was built without zlib";
+            return;
+            #endif
+        default:
+            Error{} << "Trade::KtxImporter::openData(): unsupported supercompression scheme" << UnsignedInt(header.supercompressionScheme);
+            return;
     }
+    f->supercompressionScheme = header.supercompressionScheme;
 
     /* typeSize is the size of the format's underlying type, not the texel
        size, e.g. 2 for RG16F. For any sane format it should be a
@@ -523,8 +562,8 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
 
     /* We have no 64-bit PixelFormat at the moment, so if the above format
        check didn't fail, the type size should never be 8. Once it does,
-       endianSwap() and swizzlePixels() need to handle 64-bit sizes as well.
-       Now they don't to save a bit on binary size. */
+       Implementation::copySwizzlePixels() needs to handle 64-bit sizes as
+       well. Now it doesn't to save a bit on binary size. */
     CORRADE_INTERNAL_ASSERT(header.typeSize < 8);
 
     if(f->pixelFormat.isDepth && f->numDimensions == 3) {
@@ -561,6 +600,7 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
        image per layer. */
     const bool is3DArrayImage = f->numDimensions == 3 && isLayered;
     const UnsignedInt numImages = is3DArrayImage ? numLayers : 1;
+    f->levels = Containers::Array<File::Level>{numMipmaps};
     f->imageData = Containers::Array<Containers::Array<File::LevelData>>{numImages};
     for(UnsignedInt image = 0; image != numImages; ++image)
         f->imageData[image] = Containers::Array<File::LevelData>{numMipmaps};
@@ -604,16 +644,25 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
             imageLength = levelSize.product()*f->pixelFormat.size;
         const std::size_t totalLength = imageLength*numImages;
 
-        if(level.byteLength < totalLength) {
-            Error{} << "Trade::KtxImporter::openData(): level data too short, "
-                "expected at least" << totalLength << "bytes but got" << level.byteLength;
+        /* With supercompression the uncompressed length is what the
+           decompressed data get allocated with, so be strict about it
+           instead */
+        if(header.supercompressionScheme == Implementation::SuperCompressionScheme::None) {
+            if(level.byteLength < totalLength) {
+                Error{} << "Trade::KtxImporter::openData(): level data too short, "
+                    "expected at least" << totalLength << "bytes but got" << level.byteLength;
+                return;
+            }
+        } else if(level.uncompressedByteLength != totalLength) {
+            Error{} << "Trade::KtxImporter::openData(): expected uncompressed "
+                "level data of" << totalLength << "bytes but got" << level.uncompressedByteLength;
             return;
         }
 
-        for(UnsignedInt image = 0; image != numImages; ++image) {
-            const std::size_t offset = level.byteOffset + image*imageLength;
-            f->imageData[image][i] = {levelSize, f->in.exceptPrefix(offset).prefix(imageLength)};
-        }
+        f->levels[i].data = f->in.exceptPrefix(level.byteOffset).prefix(level.byteLength);
+        f->levels[i].uncompressedLength = totalLength;
+        for(UnsignedInt image = 0; image != numImages; ++image)
+            f->imageData[image][i] = {levelSize, image*imageLength, imageLength};
 
         /* Halve each dimension, rounding down */
         mipSize = Math::max(mipSize >> 1, 1);
@@ -812,10 +861,87 @@ void KtxImporter::doOpenData(Containers::Array<char>&& data, DataFlags dataFlags
     _f = std::move(f);
 }
 
-template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(UnsignedInt id, UnsignedInt level) {
+Containers::Optional<Containers::ArrayView<const char>> KtxImporter::loadLevel(const char* const messagePrefix, const UnsignedInt level) {
+    File::Level& levelData = _f->levels[level];
+    if(_f->supercompressionScheme == Implementation::SuperCompressionScheme::None)
+        return levelData.data;
+    if(!levelData.decompressed.isEmpty())
+        return Containers::ArrayView<const char>{levelData.decompressed};
+
+    /* With multithreading disabled only the requested level gets
+       decompressed. Otherwise all levels that weren't decompressed yet are
+       decompressed at once, as the remaining levels are usually imported
+       right after. */
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    /* Without pthreads there's no way to spawn threads */
+    threadCount = 1;
+    #else
+    if(!threadCount) threadCount = std::thread::hardware_concurrency();
+    if(!threadCount) threadCount = 1;
+    #endif
+
+    Containers::Array<UnsignedInt> pending{NoInit, _f->levels.size()};
+    std::size_t pendingCount = 0;
+    if(threadCount == 1) pending[pendingCount++] = level;
+    else for(UnsignedInt i = 0; i != _f->levels.size(); ++i)
+        if(_f->levels[i].decompressed.isEmpty()) pending[pendingCount++] = i;
+
+    for(std::size_t i = 0; i != pendingCount; ++i) {
+        File::Level& pendingLevel = _f->levels[pending[i]];
+        pendingLevel.decompressed = Containers::Array<char>{NoInit, pendingLevel.uncompressedLength};
+    }
+
+    /* The levels differ a lot in size, so instead of splitting them into
+       equally-sized ranges each thread picks the next level once it's done
+       with the previous one */
+    Containers::Array<Decompressed> results{NoInit, pendingCount};
+    std::atomic<std::size_t> next{0};
+    auto decompressPending = [&]() {
+        for(;;) {
+            const std::size_t i = next++;
+            if(i >= pendingCount) break;
+            File::Level& pendingLevel = _f->levels[pending[i]];
+            results[i] = decompress(_f->supercompressionScheme, pendingLevel.data, pendingLevel.decompressed);
+        }
+    };
+    Containers::Array<std::thread> threads{ValueInit, Math::min(std::size_t(threadCount), pendingCount) - 1};
+    for(std::thread& thread: threads)
+        thread = std::thread{decompressPending};
+    decompressPending();
+    for(std::thread& thread: threads)
+        thread.join();
+
+    /* Print an error only for the requested level, other failed levels get
+       discarded and will fail again once they're requested */
+    bool success = true;
+    for(std::size_t i = 0; i != pendingCount; ++i) {
+        File::Level& pendingLevel = _f->levels[pending[i]];
+        const Decompressed& result = results[i];
+        if(result.error || result.size != pendingLevel.uncompressedLength) {
+            if(pending[i] == level) {
+                if(result.error)
+                    Error{} << messagePrefix << supercompressionSchemeName(_f->supercompressionScheme) << "decompression of level" << level << "failed:" << result.error;
+                else
+                    Error{} << messagePrefix << "expected" << pendingLevel.uncompressedLength << "bytes after decompressing level" << level << "but got" << result.size;
+                success = false;
+            }
+            pendingLevel.decompressed = nullptr;
+        }
+    }
+
+    if(!success) return {};
+    return Containers::ArrayView<const char>{levelData.decompressed};
+}
+
+template<UnsignedInt dimensions> Containers::Optional<ImageData<dimensions>> KtxImporter::doImage(const char* const messagePrefix, UnsignedInt id, UnsignedInt level) {
     const File::LevelData& levelData = _f->imageData[id][level];
     const auto size = Math::Vector<dimensions, Int>::pad(levelData.size);
-    Containers::Array<char> data{NoInit, levelData.data.size()};
+
+    const Containers::Optional<Containers::ArrayView<const char>> allImages = loadLevel(messagePrefix, level);
+    if(!allImages) return {};
+    const Containers::ArrayView<const char> imageData = allImages->slice(levelData.offset, levelData.offset + levelData.length);
+    const ImageFlags<dimensions> flags = ImageFlag<dimensions>(UnsignedShort(_f->imageFlags));
 
     /* Block-compressed images don't have any flipping, swizzling or endian
        swapping performed on them. Special-casing this mainly to avoid having
@@ -826,15 +952,35 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(Unsi
         CORRADE_INTERNAL_ASSERT(_f->pixelFormat.swizzle == SwizzleType::None);
         CORRADE_INTERNAL_ASSERT(_f->pixelFormat.typeSize == 1);
 
-        Utility::copy(levelData.data, data);
-        return ImageData<dimensions>{_f->pixelFormat.compressed, size, std::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+        if(configuration().value<bool>("referenceData"))
+            return ImageData<dimensions>{_f->pixelFormat.compressed, size, DataFlags{}, imageData, flags};
+
+        Containers::Array<char> data{NoInit, imageData.size()};
+        Utility::copy(imageData, data);
+        return ImageData<dimensions>{_f->pixelFormat.compressed, size, std::move(data), flags};
     }
 
     /* Uncompressed image */
 
+    /* Adjust pixel storage if row size is not four byte aligned */
+    PixelStorage storage;
+    if((levelData.size.x()*_f->pixelFormat.size)%4 != 0)
+        storage.setAlignment(1);
+
+    /* The level data are tightly packed, so if they don't need any
+       processing, they can be referenced directly. Endian swap is a no-op
+       for single-byte types and on little-endian platforms. */
+    if(configuration().value<bool>("referenceData") &&
+       _f->flip.none() &&
+       _f->pixelFormat.swizzle == SwizzleType::None &&
+       (_f->pixelFormat.typeSize == 1 || !Utility::Endianness::isBigEndian()))
+        return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, DataFlags{}, imageData, flags};
+
+    Containers::Array<char> data{NoInit, imageData.size()};
+
     /* Copy image data, flipping along axes if necessary. Assuming src is
        tightly packed, stride gets calculated implicitly. */
-    Containers::StridedArrayView4D<const char> src{levelData.data, {
+    Containers::StridedArrayView4D<const char> src{imageData, {
         std::size_t(levelData.size.z()),
         std::size_t(levelData.size.y()),
         std::size_t(levelData.size.x()),
@@ -846,23 +992,14 @@ template<UnsignedInt dimensions> ImageData<dimensions> KtxImporter::doImage(Unsi
     if(_f->flip[1]) src = src.flipped<1>();
     if(_f->flip[0]) src = src.flipped<2>();
 
-    /* Without flipped dimensions this becomes a single memcpy */
-    Utility::copy(src, dst);
-
-    /* Swizzle BGR(A) if necessary */
-    swizzlePixels(_f->pixelFormat.swizzle, _f->pixelFormat.typeSize, data);
-
-    endianSwap(data, _f->pixelFormat.typeSize);
-
-    /* Adjust pixel storage if row size is not four byte aligned */
-    PixelStorage storage;
-    if((levelData.size.x()*_f->pixelFormat.size)%4 != 0)
-        storage.setAlignment(1);
+    /* Swizzle BGR(A) and endian-swap if necessary while copying. Without any
+       of that and without flipped dimensions this becomes a single memcpy. */
+    Implementation::copySwizzlePixels(src, dst, _f->pixelFormat.typeSize, _f->pixelFormat.swizzle != SwizzleType::None);
 
     /** @todo the DFD block has KHR_DF_FLAG_ALPHA_PREMULTIPLIED, pass it
         through ImageFlags once such flag exists:
         https://github.khronos.org/KTX-Specification/#_providing_additional_information */
-    return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, std::move(data), ImageFlag<dimensions>(UnsignedShort(_f->imageFlags))};
+    return ImageData<dimensions>{storage, _f->pixelFormat.uncompressed, size, std::move(data), flags};
 }
 
 UnsignedInt KtxImporter::doImage1DCount() const {
@@ -889,7 +1026,7 @@ Containers::Optional<ImageData1D> KtxImporter::doImage1D(UnsignedInt id, Unsigne
            1D image interface), so this will never be called */
         CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
     else
-        return doImage<1>(id, level);
+        return doImage<1>("Trade::KtxImporter::image1D():", id, level);
 }
 
 UnsignedInt KtxImporter::doImage2DCount() const {
@@ -912,7 +1049,7 @@ Containers::Optional<ImageData2D> KtxImporter::doImage2D(UnsignedInt id, Unsigne
     if(_basisImporter)
         return _basisImporter->image2D(id, level);
     else
-        return doImage<2>(id, level);
+        return doImage<2>("Trade::KtxImporter::image2D():", id, level);
 }
 
 UnsignedInt KtxImporter::doImage3DCount() const {
@@ -935,7 +1072,7 @@ Containers::Optional<ImageData3D> KtxImporter::doImage3D(UnsignedInt id, const U
     if(_basisImporter)
         return _basisImporter->image3D(id, level);
     else
-        return doImage<3>(id, level);
+        return doImage<3>("Trade::KtxImporter::image3D():", id, level);
 }
 
 #ifdef MAGNUM_BUILD_DEPRECATED
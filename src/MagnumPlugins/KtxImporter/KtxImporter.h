@@ -35,6 +35,26 @@
 
 #include "MagnumPlugins/KtxImporter/configure.h"
 
+#ifdef DOXYGEN_GENERATING_OUTPUT
+/**
+@brief Whether the KtxImporter plugin is built with Zstandard supercompression support
+@m_since_latest_{plugins}
+
+Defined if Zstd was found when building the plugin. See
+@ref Trade-KtxImporter-behavior-supercompression for more information.
+*/
+#define MAGNUM_KTXIMPORTER_WITH_ZSTD
+
+/**
+@brief Whether the KtxImporter plugin is built with ZLIB supercompression support
+@m_since_latest_{plugins}
+
+Defined if zlib was found when building the plugin. See
+@ref Trade-KtxImporter-behavior-supercompression for more information.
+*/
+#define MAGNUM_KTXIMPORTER_WITH_ZLIB
+#endif
+
 #ifndef DOXYGEN_GENERATING_OUTPUT
 #ifndef MAGNUM_KTXIMPORTER_BUILD_STATIC
     #ifdef KtxImporter_EXPORTS
@@ -182,10 +202,40 @@ Calls to the @ref image1DCount() / @ref image2DCount() / @ref image3DCount(),
 
 @subsection Trade-KtxImporter-behavior-supercompression Supercompression
 
-Importing files with [supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
-is not supported. When @ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
-some supercompression schemes like BasisLZ and Zstandard can be handled by
-@ref BasisImporter.
+Files with [Zstandard or ZLIB supercompression](https://www.khronos.org/registry/KTX/specs/2.0/ktxspec_v2.html#supercompressionSchemes)
+are supported if the plugin is built with [Zstd](https://github.com/facebook/zstd)
+or [zlib](https://zlib.net), respectively. Both dependencies are optional and
+get used if found when building the plugin, their presence is indicated by
+@ref MAGNUM_KTXIMPORTER_WITH_ZSTD and @ref MAGNUM_KTXIMPORTER_WITH_ZLIB being
+defined in the `MagnumPlugins/KtxImporter/configure.h` header. Importing a
+file with a scheme the plugin wasn't built with fails in @ref openData().
+
+The levels aren't decompressed in @ref openData() but on first access in
+@ref image1D() / @ref image2D() / @ref image3D() and are kept in memory until
+the file is closed. With the @cb{.ini} threads @ce
+@ref Trade-KtxImporter-configuration "configuration option" set to a value
+other than @cpp 1 @ce, the first access decompresses all levels in parallel
+instead, one level per thread. That's not done on
+@ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" unless the plugin is built with
+pthreads enabled.
+
+Other supercompression schemes are not supported. When
+@ref Trade-KtxImporter-behavior-basis "forwarding Basis Universal compressed files",
+the BasisLZ and Zstandard schemes are handled by @ref BasisImporter.
+
+@subsection Trade-KtxImporter-behavior-reference Referencing file data
+
+By default, @ref image1D() / @ref image2D() / @ref image3D() return a copy of
+the level data. With the @cb{.ini} referenceData @ce
+@ref Trade-KtxImporter-configuration "configuration option" enabled, levels
+that don't need any flipping, swizzling or endian swapping are instead returned
+as views with empty @ref ImageData::dataFlags(). That's always the case for
+block-compressed formats and on little-endian platforms also for uncompressed
+formats in the default orientation without a BGR(A) swizzle. For
+supercompressed files the view points to the level data decompressed on first
+access, which the importer keeps until the file is closed. Otherwise it points
+directly into the file data, which means the memory passed to
+@ref openMemory() has to stay in scope for as long as the image is used.
 
 @section Trade-KtxImporter-configuration Plugin-specific configuration
 
@@ -211,7 +261,8 @@ class MAGNUM_KTXIMPORTER_EXPORT KtxImporter: public AbstractImporter {
         MAGNUM_KTXIMPORTER_LOCAL void doClose() override;
         MAGNUM_KTXIMPORTER_LOCAL void doOpenData(Containers::Array<char>&& data, DataFlags dataFlags) override;
 
-        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL ImageData<dimensions> doImage(UnsignedInt id, UnsignedInt level);
+        MAGNUM_KTXIMPORTER_LOCAL Containers::Optional<Containers::ArrayView<const char>> loadLevel(const char* messagePrefix, UnsignedInt level);
+        template<UnsignedInt dimensions> MAGNUM_KTXIMPORTER_LOCAL Containers::Optional<ImageData<dimensions>> doImage(const char* messagePrefix, UnsignedInt id, UnsignedInt level);
 
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DCount() const override;
         MAGNUM_KTXIMPORTER_LOCAL UnsignedInt doImage1DLevelCount(UnsignedInt id) override;
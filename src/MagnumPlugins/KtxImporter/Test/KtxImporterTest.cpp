@@ -36,6 +36,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/TestSuite/Compare/String.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -54,7 +55,9 @@
 #include <Magnum/Trade/TextureData.h>
 #endif
 
+#include "MagnumPlugins/Implementation/Test/referenceData.h"
 #include "MagnumPlugins/KtxImporter/KtxHeader.h"
+#include "MagnumPlugins/KtxImporter/configure.h"
 
 #include "configure.h"
 
@@ -104,6 +107,11 @@ struct KtxImporterTest: TestSuite::Tester {
     void image3DCompressed();
     void image3DCompressedMipmaps();
 
+    void supercompression();
+    void supercompressionNotSupported();
+    void supercompressionInvalid();
+    void supercompressionInvalidUncompressedLength();
+
     void forwardBasis();
     void forwardBasisFormat();
     void forwardBasisInvalid();
@@ -125,6 +133,8 @@ struct KtxImporterTest: TestSuite::Tester {
 
     void openMemory();
     void openTwice();
+
+    void referenceData();
     void openNormalAfterBasis();
     void importTwice();
 
@@ -250,9 +260,12 @@ const struct {
     {"compressed type size", "2d-compressed-etc2.ktx2",
         offsetof(Implementation::KtxHeader, typeSize), 4,
         "invalid type size for compressed format, expected 1 but got 4"},
-    {"supercompression", "2d-rgb.ktx2",
+    {"BasisLZ supercompression", "2d-rgb.ktx2",
         offsetof(Implementation::KtxHeader, supercompressionScheme), 1,
-        "supercompression is currently not supported"},
+        "unsupported supercompression scheme 1"},
+    {"unknown supercompression", "2d-rgb.ktx2",
+        offsetof(Implementation::KtxHeader, supercompressionScheme), 4,
+        "unsupported supercompression scheme 4"},
     {"3d depth", "3d.ktx2",
         offsetof(Implementation::KtxHeader, vkFormat), VK_FORMAT_D32_SFLOAT,
         "3D images can't have depth/stencil format"},
@@ -503,6 +516,44 @@ const struct {
         nullptr, Containers::arrayCast<const char>(PatternRgba2DData)}
 };
 
+const struct {
+    const char* name;
+    const char* file;
+    const char* scheme;
+    bool supported;
+    const char* message;
+    UnsignedInt threads;
+} SupercompressionData[]{
+    {"Zstandard", "2d-mipmaps-zstd.ktx2", "Zstandard",
+        #ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+        true,
+        #else
+        false,
+        #endif
+        "Zstandard supercompression is not supported, the plugin was built without Zstd", 1},
+    {"Zstandard, 3 threads", "2d-mipmaps-zstd.ktx2", "Zstandard",
+        #ifdef MAGNUM_KTXIMPORTER_WITH_ZSTD
+        true,
+        #else
+        false,
+        #endif
+        "Zstandard supercompression is not supported, the plugin was built without Zstd", 3},
+    {"ZLIB", "2d-mipmaps-zlib.ktx2", "ZLIB",
+        #ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+        true,
+        #else
+        false,
+        #endif
+        "ZLIB supercompression is not supported, the plugin was built without zlib", 1},
+    {"ZLIB, 3 threads", "2d-mipmaps-zlib.ktx2", "ZLIB",
+        #ifdef MAGNUM_KTXIMPORTER_WITH_ZLIB
+        true,
+        #else
+        false,
+        #endif
+        "ZLIB supercompression is not supported, the plugin was built without zlib", 3},
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -519,6 +570,20 @@ const struct {
     }},
 };
 
+const struct {
+    const char* name;
+    const char* file;
+    bool referenced;
+    /* Multi-byte types need an endian swap on big-endian platforms */
+    bool multiByte;
+} ReferenceDataData[]{
+    {"compressed", "2d-compressed-bc1.ktx2", true, false},
+    {"single-byte", "2d-s8.ktx2", true, false},
+    {"multi-byte", "2d-d16.ktx2", true, true},
+    {"flipped", "2d-rgb.ktx2", false, false},
+    {"swizzled", "bgr.ktx2", false, false}
+};
+
 Containers::Array<char> createKeyValueData(Containers::StringView key, Containers::ArrayView<const char> value, bool terminatingZero = false) {
     UnsignedInt size = key.size() + 1 + value.size() + UnsignedInt(terminatingZero);
     size = (size + 3)/4*4;
@@ -605,6 +670,12 @@ KtxImporterTest::KtxImporterTest() {
               &KtxImporterTest::image3DCompressed,
               &KtxImporterTest::image3DCompressedMipmaps});
 
+    addInstancedTests({&KtxImporterTest::supercompression,
+                       &KtxImporterTest::supercompressionNotSupported,
+                       &KtxImporterTest::supercompressionInvalid,
+                       &KtxImporterTest::supercompressionInvalidUncompressedLength},
+        Containers::arraySize(SupercompressionData));
+
     addInstancedTests({&KtxImporterTest::forwardBasis},
         Containers::arraySize(ForwardBasisData));
 
@@ -647,6 +718,9 @@ KtxImporterTest::KtxImporterTest() {
               &KtxImporterTest::openNormalAfterBasis,
               &KtxImporterTest::importTwice});
 
+    addInstancedTests({&KtxImporterTest::referenceData},
+        Containers::arraySize(ReferenceDataData));
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef KTXIMPORTER_PLUGIN_FILENAME
@@ -1682,6 +1756,127 @@ void KtxImporterTest::image3DCompressedMipmaps() {
     }
 }
 
+void KtxImporterTest::supercompression() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this supercompression scheme, can't test.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file)));
+
+    /* Same as in image2DMipmaps() */
+    const auto mip0 = Containers::arrayCast<const Color3ub>(PatternRgbData[0]);
+    const Color3ub mip1[2]{0xffffff_rgb, 0x007f7f_rgb};
+    const Color3ub mip2[1]{0x000000_rgb};
+    const Containers::ArrayView<const Color3ub> mipViews[3]{mip0, mip1, mip2};
+    const Vector2i mipSizes[3]{{4, 3}, {2, 1}, {1, 1}};
+
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), Containers::arraySize(mipViews));
+
+    /* Going from the smallest level to verify that each level gets
+       decompressed independently */
+    for(UnsignedInt i = importer->image2DLevelCount(0); i-- != 0; ) {
+        CORRADE_ITERATION(i);
+
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(!image->isCompressed());
+        CORRADE_COMPARE(image->format(), PixelFormat::RGB8Srgb);
+        CORRADE_COMPARE(image->size(), mipSizes[i]);
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(mipViews[i]), TestSuite::Compare::Container);
+    }
+
+    /* Importing again gives the same result */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(mipViews[0]), TestSuite::Compare::Container);
+}
+
+void KtxImporterTest::supercompressionNotSupported() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(data.supported)
+        CORRADE_SKIP("The plugin was built with support for this supercompression scheme, can't test.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file)));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::KtxImporter::openData(): {}\n", data.message));
+}
+
+void KtxImporterTest::supercompressionInvalid() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this supercompression scheme, can't test.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    importer->configuration().setValue("threads", data.threads);
+
+    /* Corrupt the start of the first level data, which breaks the header
+       of both Zstandard and ZLIB streams */
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file));
+    CORRADE_VERIFY(fileData);
+    UnsignedLong byteOffset = reinterpret_cast<const Implementation::KtxLevel*>(fileData->exceptPrefix(sizeof(Implementation::KtxHeader)).data())->byteOffset;
+    Utility::Endianness::littleEndianInPlace(byteOffset);
+    for(std::size_t i = 0; i != 4; ++i)
+        (*fileData)[byteOffset + i] = '\xff';
+
+    /* The data aren't touched in openData() yet */
+    CORRADE_VERIFY(importer->openData(*fileData));
+
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->image2D(0, 0));
+        CORRADE_COMPARE_AS(out.str(),
+            Utility::formatString("Trade::KtxImporter::image2D(): {} decompression of level 0 failed: ", data.scheme),
+            TestSuite::Compare::StringHasPrefix);
+    }
+
+    /* Other levels are not affected, even if they were decompressed in
+       parallel with the failed one */
+    const Color3ub mip1[2]{0xffffff_rgb, 0x007f7f_rgb};
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayCast<const char>(Containers::arrayView(mip1)), TestSuite::Compare::Container);
+
+    /* The failed level fails again */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->image2D(0, 0));
+        CORRADE_VERIFY(!out.str().empty());
+    }
+}
+
+void KtxImporterTest::supercompressionInvalidUncompressedLength() {
+    auto&& data = SupercompressionData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(!data.supported)
+        CORRADE_SKIP("The plugin was built without support for this supercompression scheme, can't test.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+
+    Containers::Optional<Containers::Array<char>> fileData = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file));
+    CORRADE_VERIFY(fileData);
+    (*fileData)[sizeof(Implementation::KtxHeader) + offsetof(Implementation::KtxLevel, uncompressedByteLength)] = 37;
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(*fileData));
+    CORRADE_COMPARE(out.str(), "Trade::KtxImporter::openData(): expected uncompressed level data of 36 bytes but got 37\n");
+}
+
 void KtxImporterTest::forwardBasis() {
     auto&& data = ForwardBasisData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2185,6 +2380,46 @@ void KtxImporterTest::importTwice() {
     }
 }
 
+void KtxImporterTest::referenceData() {
+    auto&& data = ReferenceDataData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(KTXIMPORTER_TEST_DIR, data.file));
+    CORRADE_VERIFY(memory);
+
+    /* Import a copy first to have something to compare against */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("KtxImporter");
+    Containers::Optional<Trade::ImageData2D> expected;
+    {
+        /* Compressed images aren't flipped, which is warned about */
+        Warning silenceWarning{nullptr};
+        CORRADE_VERIFY(importer->openMemory(*memory));
+        expected = importer->image2D(0);
+    }
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(expected->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    importer->configuration().setValue("referenceData", true);
+    {
+        Warning silenceWarning{nullptr};
+        CORRADE_VERIFY(importer->openMemory(*memory));
+    }
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->isCompressed(), expected->isCompressed());
+    CORRADE_COMPARE(image->size(), expected->size());
+    CORRADE_COMPARE(image->storage().alignment(), expected->storage().alignment());
+    CORRADE_COMPARE_AS(image->data(), expected->data(), TestSuite::Compare::Container);
+
+    if(data.referenced && !(data.multiByte && Utility::Endianness::isBigEndian())) {
+        CORRADE_COMPARE(image->dataFlags(), DataFlags{});
+        /* The data point straight into the memory passed to openMemory() */
+        CORRADE_VERIFY(isViewOn(image->data(), *memory));
+    } else {
+        CORRADE_COMPARE(image->dataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::KtxImporterTest)
@@ -44,6 +44,11 @@ PVRTexToolCLI -i pattern.png -o 2d-rgbf32.ktx2 -f r32g32b32,SF,sRGB
 toktx --t2 --mipmap 2d-mipmaps.ktx2 pattern.png pattern-mip1.png pattern-mip2.png
 toktx --t2 --mipmap --levels 2 2d-mipmaps-incomplete.ktx2 pattern.png pattern-mip1.png
 
+# supercompressed manual mipmaps, data should come out the same as in
+# 2d-mipmaps.ktx2
+toktx --t2 --mipmap --zcmp 19 2d-mipmaps-zstd.ktx2 pattern.png pattern-mip1.png pattern-mip2.png
+toktx --t2 --mipmap --zlib 9 2d-mipmaps-zlib.ktx2 pattern.png pattern-mip1.png pattern-mip2.png
+
 # layers
 PVRTexToolCLI -i pattern.png,pattern.png,black.png -o 2d-layers.ktx2 -array -f r8g8b8,UBN,sRGB
 
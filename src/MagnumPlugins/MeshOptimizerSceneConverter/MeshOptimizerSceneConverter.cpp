@@ -25,16 +25,31 @@
 
 #include "MeshOptimizerSceneConverter.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Iterable.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/PackingBatch.h>
-#include <Magnum/Math/Vector3.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/MeshTools/Combine.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
 #include <Magnum/MeshTools/Interleave.h>
 #include <Magnum/MeshTools/Reference.h>
+#include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 #include <meshoptimizer.h>
@@ -43,22 +58,183 @@ namespace Magnum { namespace Trade {
 
 MeshOptimizerSceneConverter::MeshOptimizerSceneConverter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractSceneConverter{manager, plugin} {}
 
-MeshOptimizerSceneConverter::~MeshOptimizerSceneConverter() = default;
-
 SceneConverterFeatures MeshOptimizerSceneConverter::doFeatures() const {
-    return SceneConverterFeature::ConvertMeshInPlace|SceneConverterFeature::ConvertMesh;
+    return SceneConverterFeature::ConvertMeshInPlace|SceneConverterFeature::ConvertMesh|SceneConverterFeature::ConvertMeshToData|SceneConverterFeature::ConvertMultiple|SceneConverterFeature::AddMeshes;
 }
 
 namespace {
 
-template<class T> void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const UnsignedInt vertexSize, const Containers::StridedArrayView1D<const Vector3> positions, meshopt_VertexCacheStatistics& vertexCacheStats, meshopt_VertexFetchStatistics& vertexFetchStats, meshopt_OverdrawStatistics& overdrawStats) {
+/* Configuration values, parsed just once in begin() for all meshes added
+   after instead of being looked up again for each */
+struct Options {
+    bool generateIndices;
+    bool optimizeVertexCache;
+    bool optimizeOverdraw;
+    Float optimizeOverdrawThreshold;
+    bool optimizeVertexFetch;
+    bool simplify;
+    bool simplifySloppy;
+    Float simplifyTargetIndexCountThreshold;
+    Float simplifyTargetError;
+    bool simplifyLockBorder;
+    Float simplifyNormalWeight;
+    Float simplifyTextureCoordinatesWeight;
+    Float simplifyColorWeight;
+    UnsignedInt lodCount;
+    Float lodTargetIndexCountThreshold;
+    Float lodTargetError;
+    bool buildMeshlets;
+    bool encode;
+    bool generateShadowIndices;
+    bool spatialSort;
+    bool report;
+    bool referenceVertexData;
+    UnsignedInt meshletMaxVertices;
+    UnsignedInt meshletMaxTriangles;
+    Float meshletConeWeight;
+    UnsignedInt analyzeCacheSize;
+    UnsignedInt analyzeWarpSize;
+    UnsignedInt analyzePrimitiveGroupSize;
+};
+
+Options readOptions(const Utility::ConfigurationGroup& configuration) {
+    Options options;
+    options.generateIndices = configuration.value<bool>("generateIndices");
+    options.optimizeVertexCache = configuration.value<bool>("optimizeVertexCache");
+    options.optimizeOverdraw = configuration.value<bool>("optimizeOverdraw");
+    options.optimizeOverdrawThreshold = configuration.value<Float>("optimizeOverdrawThreshold");
+    options.optimizeVertexFetch = configuration.value<bool>("optimizeVertexFetch");
+    options.simplify = configuration.value<bool>("simplify");
+    options.simplifySloppy = configuration.value<bool>("simplifySloppy");
+    options.simplifyTargetIndexCountThreshold = configuration.value<Float>("simplifyTargetIndexCountThreshold");
+    options.simplifyTargetError = configuration.value<Float>("simplifyTargetError");
+    options.simplifyLockBorder = configuration.value<bool>("simplifyLockBorder");
+    options.simplifyNormalWeight = configuration.value<Float>("simplifyNormalWeight");
+    options.simplifyTextureCoordinatesWeight = configuration.value<Float>("simplifyTextureCoordinatesWeight");
+    options.simplifyColorWeight = configuration.value<Float>("simplifyColorWeight");
+    options.lodCount = configuration.value<UnsignedInt>("lodCount");
+    options.lodTargetIndexCountThreshold = configuration.value<Float>("lodTargetIndexCountThreshold");
+    options.lodTargetError = configuration.value<Float>("lodTargetError");
+    options.buildMeshlets = configuration.value<bool>("buildMeshlets");
+    options.encode = configuration.value<bool>("encode");
+    options.generateShadowIndices = configuration.value<bool>("generateShadowIndices");
+    options.spatialSort = configuration.value<bool>("spatialSort");
+    options.report = configuration.value<bool>("report");
+    options.referenceVertexData = configuration.value<bool>("referenceVertexData");
+    options.meshletMaxVertices = configuration.value<UnsignedInt>("meshletMaxVertices");
+    options.meshletMaxTriangles = configuration.value<UnsignedInt>("meshletMaxTriangles");
+    options.meshletConeWeight = configuration.value<Float>("meshletConeWeight");
+    options.analyzeCacheSize = configuration.value<UnsignedInt>("analyzeCacheSize");
+    options.analyzeWarpSize = configuration.value<UnsignedInt>("analyzeWarpSize");
+    options.analyzePrimitiveGroupSize = configuration.value<UnsignedInt>("analyzePrimitiveGroupSize");
+    return options;
+}
+
+/* Temporary storage reused across meshes processed by the same thread,
+   avoiding allocations for each. Only ever grows. */
+struct Scratch {
+    Containers::Array<Vector3> positions;
+    Containers::Array<UnsignedInt> indices;
+    Containers::Array<UnsignedInt> simplifiedIndices;
+    Containers::Array<Float> simplifyAttributes;
+    Containers::Array<char> vertices;
+    Containers::Array<char> encoded;
+    #if MESHOPTIMIZER_VERSION >= 170
+    Containers::Array<meshopt_Meshlet> meshlets;
+    Containers::Array<UnsignedInt> meshletVertices;
+    Containers::Array<UnsignedByte> meshletTriangles;
+    #endif
+};
+
+template<class T> Containers::ArrayView<T> scratchView(Containers::Array<T>& storage, const std::size_t size) {
+    if(storage.size() < size)
+        storage = Containers::Array<T>{NoInit, size};
+    return storage.prefix(size);
+}
+
+/* meshoptimizer doesn't provide overloads for smaller index types in
+   simplification and meshlet building, so convert those on our side */
+Containers::ArrayView<const UnsignedInt> indicesAsUnsignedInt(const MeshData& mesh, Containers::Array<UnsignedInt>& storage) {
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        return mesh.indices<UnsignedInt>().asContiguous();
+
+    const Containers::ArrayView<UnsignedInt> indices = scratchView(storage, mesh.indexCount());
+    mesh.indicesInto(indices);
+    return indices;
+}
+
+/* Efficiency statistics of the index and vertex buffer, calculated before and
+   after the processing if verbose output or the report is requested */
+struct Statistics {
+    UnsignedInt vertexCount;
+    UnsignedInt indexCount;
+    meshopt_VertexCacheStatistics vertexCache;
+    meshopt_VertexFetchStatistics vertexFetch;
+    meshopt_OverdrawStatistics overdraw;
+};
+
+struct Timing {
+    const char* pass;
+    Float milliseconds;
+};
+
+/* Filled if the report option is enabled, put into a [report] configuration
+   group once the conversion is done */
+struct Report {
+    /* False if the mesh didn't go through the optimization passes, such as
+       when it was only spatially sorted */
+    bool analyzed = false;
+    /* Vertex fetch statistics aren't available for meshes with
+       implementation-specific vertex formats, overdraw statistics for meshes
+       without positions */
+    bool vertexFetch = false;
+    bool overdraw = false;
+    Statistics before;
+    Statistics after;
+    Containers::Array<Timing> timings;
+};
+
+void addTiming(Report& report, const char* const pass, const std::chrono::steady_clock::time_point start) {
+    arrayAppend(report.timings, Timing{pass, std::chrono::duration<Float, std::milli>(std::chrono::steady_clock::now() - start).count()});
+}
+
+void writeStatistics(Utility::ConfigurationGroup& group, const Report& report, const Statistics& statistics) {
+    group.setValue("vertexCount", statistics.vertexCount);
+    group.setValue("indexCount", statistics.indexCount);
+    group.setValue("verticesTransformed", statistics.vertexCache.vertices_transformed);
+    group.setValue("warpsExecuted", statistics.vertexCache.warps_executed);
+    group.setValue("acmr", statistics.vertexCache.acmr);
+    group.setValue("atvr", statistics.vertexCache.atvr);
+    if(report.vertexFetch) {
+        group.setValue("bytesFetched", statistics.vertexFetch.bytes_fetched);
+        group.setValue("overfetch", statistics.vertexFetch.overfetch);
+    }
+    if(report.overdraw) {
+        group.setValue("pixelsShaded", statistics.overdraw.pixels_shaded);
+        group.setValue("pixelsCovered", statistics.overdraw.pixels_covered);
+        group.setValue("overdraw", statistics.overdraw.overdraw);
+    }
+}
+
+void writeReport(Utility::ConfigurationGroup& group, const Report& report) {
+    if(report.analyzed) {
+        writeStatistics(*group.addGroup("before"), report, report.before);
+        writeStatistics(*group.addGroup("after"), report, report.after);
+    }
+
+    Utility::ConfigurationGroup& time = *group.addGroup("time");
+    for(const Timing& timing: report.timings)
+        time.setValue(timing.pass, timing.milliseconds);
+}
+
+template<class T> void analyze(const MeshData& mesh, const Options& options, const UnsignedInt vertexSize, const Containers::StridedArrayView1D<const Vector3> positions, Statistics& statistics) {
     const auto indices = mesh.indices<T>().asContiguous();
-    vertexCacheStats = meshopt_analyzeVertexCache(indices.data(), mesh.indexCount(), mesh.vertexCount(), configuration.value<UnsignedInt>("analyzeCacheSize"), configuration.value<UnsignedInt>("analyzeWarpSize"), configuration.value<UnsignedInt>("analyzePrimitiveGroupSize"));
-    if(vertexSize) vertexFetchStats = meshopt_analyzeVertexFetch(indices.data(), mesh.indexCount(), mesh.vertexCount(), vertexSize);
-    if(positions) overdrawStats = meshopt_analyzeOverdraw(indices.data(), mesh.indexCount(), static_cast<const float*>(positions.data()), mesh.vertexCount(), positions.stride());
+    statistics.vertexCache = meshopt_analyzeVertexCache(indices.data(), mesh.indexCount(), mesh.vertexCount(), options.analyzeCacheSize, options.analyzeWarpSize, options.analyzePrimitiveGroupSize);
+    if(vertexSize) statistics.vertexFetch = meshopt_analyzeVertexFetch(indices.data(), mesh.indexCount(), mesh.vertexCount(), vertexSize);
+    if(positions) statistics.overdraw = meshopt_analyzeOverdraw(indices.data(), mesh.indexCount(), static_cast<const float*>(positions.data()), mesh.vertexCount(), positions.stride());
 }
 
-void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStats, meshopt_VertexFetchStatistics& vertexFetchStats, meshopt_OverdrawStatistics& overdrawStats) {
+void analyze(const MeshData& mesh, const Options& options, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, Statistics& statistics) {
     /* Calculate vertex size out of all attributes. If any attribute is
        implementation-specific, do nothing (warning will be printed by the
        caller) */
@@ -75,16 +251,18 @@ void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configurat
         }
     }
 
+    statistics.vertexCount = mesh.vertexCount();
+    statistics.indexCount = mesh.indexCount();
     if(mesh.indexType() == MeshIndexType::UnsignedInt)
-        analyze<UnsignedInt>(mesh, configuration, *vertexSize, positions, vertexCacheStats, vertexFetchStats, overdrawStats);
+        analyze<UnsignedInt>(mesh, options, *vertexSize, positions, statistics);
     else if(mesh.indexType() == MeshIndexType::UnsignedShort)
-        analyze<UnsignedShort>(mesh, configuration, *vertexSize, positions, vertexCacheStats, vertexFetchStats, overdrawStats);
+        analyze<UnsignedShort>(mesh, options, *vertexSize, positions, statistics);
     else if(mesh.indexType() == MeshIndexType::UnsignedByte)
-        analyze<UnsignedByte>(mesh, configuration, *vertexSize, positions, vertexCacheStats, vertexFetchStats, overdrawStats);
+        analyze<UnsignedByte>(mesh, options, *vertexSize, positions, statistics);
     else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-void analyzePost(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
+void analyzePost(const char* prefix, const MeshData& mesh, const SceneConverterFlags flags, const Options& options, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, const Statistics& before, Report& report) {
     /* If vertex size is zero, it means there was an implementation-specific
        vertex format somewhere. Print a warning about that. */
     CORRADE_INTERNAL_ASSERT(vertexSize);
@@ -96,47 +274,58 @@ void analyzePost(const char* prefix, const MeshData& mesh, const Utility::Config
         }
     }
 
-    meshopt_VertexCacheStatistics vertexCacheStats;
-    meshopt_VertexFetchStatistics vertexFetchStats;
-    meshopt_OverdrawStatistics overdrawStats;
-    analyze(mesh, configuration, positions, vertexSize, vertexCacheStats, vertexFetchStats, overdrawStats);
+    Statistics after;
+    analyze(mesh, options, positions, vertexSize, after);
+
+    if(options.report) {
+        report.analyzed = true;
+        report.vertexFetch = *vertexSize;
+        report.overdraw = bool(positions);
+        report.before = before;
+        report.after = after;
+    }
+
+    if(!(flags & SceneConverterFlag::Verbose)) return;
 
     Debug{} << prefix << "processing stats:";
     Debug{} << "  vertex cache:\n   "
-        << vertexCacheStatsBefore.vertices_transformed << "->"
-        << vertexCacheStats.vertices_transformed
+        << before.vertexCache.vertices_transformed << "->"
+        << after.vertexCache.vertices_transformed
         << "transformed vertices\n   "
-        << vertexCacheStatsBefore.warps_executed << "->"
-        << vertexCacheStats.warps_executed << "executed warps\n    ACMR"
-        << vertexCacheStatsBefore.acmr << "->" << vertexCacheStats.acmr
-        << Debug::newline << "    ATVR" << vertexCacheStatsBefore.atvr
-        << "->" << vertexCacheStats.atvr;
+        << before.vertexCache.warps_executed << "->"
+        << after.vertexCache.warps_executed << "executed warps\n    ACMR"
+        << before.vertexCache.acmr << "->" << after.vertexCache.acmr
+        << Debug::newline << "    ATVR" << before.vertexCache.atvr
+        << "->" << after.vertexCache.atvr;
     if(*vertexSize) Debug{} << "  vertex fetch:\n   "
-        << vertexFetchStatsBefore.bytes_fetched << "->"
-        << vertexFetchStats.bytes_fetched << "bytes fetched\n    overfetch"
-        << vertexFetchStatsBefore.overfetch << "->"
-        << vertexFetchStats.overfetch;
+        << before.vertexFetch.bytes_fetched << "->"
+        << after.vertexFetch.bytes_fetched << "bytes fetched\n    overfetch"
+        << before.vertexFetch.overfetch << "->"
+        << after.vertexFetch.overfetch;
     if(positions) Debug{} << "  overdraw:\n   "
-        << overdrawStatsBefore.pixels_shaded << "->"
-        << overdrawStats.pixels_shaded << "shaded pixels\n   "
-        << overdrawStatsBefore.pixels_covered << "->"
-        << overdrawStats.pixels_covered << "covered pixels\n    overdraw"
-        << overdrawStatsBefore.overdraw << "->" << overdrawStats.overdraw;
+        << before.overdraw.pixels_shaded << "->"
+        << after.overdraw.pixels_shaded << "shaded pixels\n   "
+        << before.overdraw.pixels_covered << "->"
+        << after.overdraw.pixels_covered << "covered pixels\n    overdraw"
+        << before.overdraw.overdraw << "->" << after.overdraw.overdraw;
 }
 
 void populatePositions(const MeshData& mesh, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions) {
-    /* MeshOptimizer accepts float positions with stride divisible by four. If
-       the input doesn't have that (for example because it's a tightly-packed
-       PLY with 24bit RGB colors), we need to supply unpacked aligned copy. */
-    if(mesh.attributeFormat(MeshAttribute::Position) == VertexFormat::Vector3 && mesh.attributeStride(MeshAttribute::Position) % 4 == 0)
+    /* MeshOptimizer accepts float positions with a positive stride divisible
+       by four. If the input doesn't have that (for example because it's a
+       tightly-packed PLY with 24bit RGB colors, or the vertex data are
+       referenced directly from the input in convert()), we need to supply
+       unpacked aligned copy. */
+    if(mesh.attributeFormat(MeshAttribute::Position) == VertexFormat::Vector3 && mesh.attributeStride(MeshAttribute::Position) > 0 && mesh.attributeStride(MeshAttribute::Position) % 4 == 0)
         positions = mesh.attribute<Vector3>(MeshAttribute::Position);
     else {
-        positionStorage = mesh.positions3DAsArray();
-        positions = positionStorage;
+        const Containers::ArrayView<Vector3> unpacked = scratchView(positionStorage, mesh.vertexCount());
+        mesh.positions3DInto(unpacked);
+        positions = unpacked;
     }
 }
 
-bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions, Containers::Optional<UnsignedInt>& vertexSize,  meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
+bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConverterFlags flags, const Options& options, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions, Containers::Optional<UnsignedInt>& vertexSize, Statistics& before, Report& report) {
     /* Only doConvert() can handle triangle strips etc, in-place only triangles */
     if(mesh.primitive() != MeshPrimitive::Triangles) {
         Error{} << prefix << "expected a triangle mesh, got" << mesh.primitive();
@@ -150,12 +339,14 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
     }
 
     /* If we need it, get the position attribute, unpack if packed. It's used
-       by the verbose stats also but in that case the processing shouldn't fail
-       if there are no positions -- so check the hasAttribute() earlier. */
-    if((flags & SceneConverterFlag::Verbose && mesh.hasAttribute(MeshAttribute::Position)) ||
-       configuration.value<bool>("optimizeOverdraw") ||
-       configuration.value<bool>("simplify") ||
-       configuration.value<bool>("simplifySloppy"))
+       by the verbose stats and the report also but in that case the
+       processing shouldn't fail if there are no positions -- so check the
+       hasAttribute() earlier. */
+    const bool analyzeStats = (flags & SceneConverterFlag::Verbose) || options.report;
+    if((analyzeStats && mesh.hasAttribute(MeshAttribute::Position)) ||
+       options.optimizeOverdraw ||
+       options.simplify ||
+       options.simplifySloppy)
     {
         if(!mesh.hasAttribute(MeshAttribute::Position)) {
             Error{} << prefix << "optimizeOverdraw and simplify require the mesh to have positions";
@@ -165,14 +356,16 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
         populatePositions(mesh, positionStorage, positions);
     }
 
-    /* Save "before" stats if verbose output is requested. No messages as those
-       will be printed only at the end if the processing passes. */
-    if(flags & SceneConverterFlag::Verbose) {
-        analyze(mesh, configuration, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    /* Save "before" stats if verbose output or the report is requested. No
+       messages as those will be printed only at the end if the processing
+       passes. */
+    if(analyzeStats) {
+        analyze(mesh, options, positions, vertexSize, before);
     }
 
     /* Vertex cache optimization. Goes first. */
-    if(configuration.value<bool>("optimizeVertexCache")) {
+    if(options.optimizeVertexCache) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         if(mesh.indexType() == MeshIndexType::UnsignedInt) {
             Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>().asContiguous();
             meshopt_optimizeVertexCache(indices.data(), indices.data(), mesh.indexCount(), mesh.vertexCount());
@@ -183,11 +376,13 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
             Containers::ArrayView<UnsignedByte> indices = mesh.mutableIndices<UnsignedByte>().asContiguous();
             meshopt_optimizeVertexCache(indices.data(), indices.data(), mesh.indexCount(), mesh.vertexCount());
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        if(options.report) addTiming(report, "optimizeVertexCache", start);
     }
 
     /* Overdraw optimization. Goes after vertex cache optimization. */
-    if(configuration.value<bool>("optimizeOverdraw")) {
-        const Float optimizeOverdrawThreshold = configuration.value<Float>("optimizeOverdrawThreshold");
+    if(options.optimizeOverdraw) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const Float optimizeOverdrawThreshold = options.optimizeOverdrawThreshold;
 
         if(mesh.indexType() == MeshIndexType::UnsignedInt) {
             Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>().asContiguous();
@@ -199,6 +394,7 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
             Containers::ArrayView<UnsignedByte> indices = mesh.mutableIndices<UnsignedByte>().asContiguous();
             meshopt_optimizeOverdraw(indices.data(), indices.data(), mesh.indexCount(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride(), optimizeOverdrawThreshold);
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        if(options.report) addTiming(report, "optimizeOverdraw", start);
     }
 
     /* Vertex fetch optimization. Goes after overdraw optimization. Reorders
@@ -206,7 +402,9 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
        attributes it's of no use (also meshoptimizer asserts in that case).
        Skipping silently instead of failing hard, as an attribute-less mesh
        always *is* optimized for vertex fetch, so there's nothing wrong. */
-    if(configuration.value<bool>("optimizeVertexFetch") && mesh.attributeCount()) {
+    if(options.optimizeVertexFetch && mesh.attributeCount()) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
         /* This assumes the mesh is interleaved. doConvert() already ensures
            that, doConvertInPlace() has a runtime check */
         Containers::StridedArrayView2D<char> interleavedData = MeshTools::interleavedMutableData(mesh);
@@ -221,6 +419,7 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
             Containers::ArrayView<UnsignedByte> indices = mesh.mutableIndices<UnsignedByte>().asContiguous();
             meshopt_optimizeVertexFetch(interleavedData.data(), indices.data(), mesh.indexCount(), interleavedData.data(), mesh.vertexCount(), interleavedData.stride()[0]);
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        if(options.report) addTiming(report, "optimizeVertexFetch", start);
     }
 
     return true;
@@ -229,16 +428,18 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
 }
 
 bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
-    if((configuration().value<bool>("optimizeVertexCache") ||
-        configuration().value<bool>("optimizeOverdraw") ||
-        configuration().value<bool>("optimizeVertexFetch")) &&
+    const Options options = readOptions(configuration());
+
+    if((options.optimizeVertexCache ||
+        options.optimizeOverdraw ||
+        options.optimizeVertexFetch) &&
        !(mesh.indexDataFlags() & DataFlag::Mutable))
     {
         Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexCache, optimizeOverdraw and optimizeVertexFetch require index data to be mutable";
         return false;
     }
 
-    if(configuration().value<bool>("optimizeVertexFetch")) {
+    if(options.optimizeVertexFetch) {
         if(!(mesh.vertexDataFlags() & DataFlag::Mutable)) {
             Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexFetch requires vertex data to be mutable";
             return false;
@@ -250,13 +451,16 @@ bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
         }
     }
 
-    if(configuration().value<bool>("simplify") ||
-       configuration().value<bool>("simplifySloppy"))
-    {
+    if(options.simplify || options.simplifySloppy) {
         Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): mesh simplification can't be performed in-place, use convert() instead";
         return false;
     }
 
+    if(options.buildMeshlets || options.lodCount || options.generateShadowIndices) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): meshlets, LODs and shadow indices are produced as additional mesh levels, use begin(), add() and end() instead";
+        return false;
+    }
+
     /* Errors for non-indexed meshes and implementation-specific index buffers
        are printed directly in convertInPlaceInternal() */
     if(mesh.isIndexed()) {
@@ -271,17 +475,21 @@ bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
         }
     }
 
-    meshopt_VertexCacheStatistics vertexCacheStatsBefore;
-    meshopt_VertexFetchStatistics vertexFetchStatsBefore;
-    meshopt_OverdrawStatistics overdrawStatsBefore;
+    configuration().removeAllGroups("report");
+
+    Statistics before;
+    Report report;
     Containers::Array<Vector3> positionStorage;
     Containers::StridedArrayView1D<const Vector3> positions;
     Containers::Optional<UnsignedInt> vertexSize;
-    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
+    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), options, positionStorage, positions, vertexSize, before, report))
         return false;
 
-    if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, configuration(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    if((flags() & SceneConverterFlag::Verbose) || options.report)
+        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), options, positions, vertexSize, before, report);
+
+    if(options.report)
+        writeReport(*configuration().addGroup("report"), report);
 
     return true;
 }
@@ -317,19 +525,267 @@ template<std::size_t(*F)(UnsignedInt*, const UnsignedInt*, std::size_t, const Fl
     return F;
 }
 
+/* Normals, 2D texture coordinates and RGBA colors */
+constexpr UnsignedInt SimplifyAttributeMaxComponentCount = 3 + 2 + 4;
+
+/* Attributes taken into account by attribute-aware simplification, unpacked
+   to a tightly packed float array with a weight for each component */
+struct SimplifyAttributes {
+    Containers::ArrayView<const Float> data;
+    UnsignedInt componentCount;
+    Float weights[SimplifyAttributeMaxComponentCount];
+};
+
+template<class T> Containers::StridedArrayView1D<T> simplifyAttributeView(const Containers::ArrayView<Float> data, const UnsignedInt offset, const UnsignedInt componentCount) {
+    const std::size_t vertexCount = componentCount ? data.size()/componentCount : 0;
+    return {data, reinterpret_cast<T*>(data.data() + offset), vertexCount, std::ptrdiff_t(componentCount*sizeof(Float))};
 }
 
-Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
+bool hasSimplifyAttribute(const MeshData& mesh, const MeshAttribute name, const Float weight) {
+    /* Implementation-specific formats can't be unpacked, skip those */
+    return weight != 0.0f && mesh.hasAttribute(name) && !isVertexFormatImplementationSpecific(mesh.attributeFormat(name));
+}
+
+/* If no weight is set or the mesh has none of the weighted attributes,
+   componentCount is zero and only positions are used. Attribute weights are
+   ignored with meshoptimizer before 0.20, a warning is printed in that case. */
+SimplifyAttributes populateSimplifyAttributes(const char* const prefix, const MeshData& mesh, const Options& options, Scratch& scratch) {
+    SimplifyAttributes out{};
+
+    const bool normals = hasSimplifyAttribute(mesh, MeshAttribute::Normal, options.simplifyNormalWeight);
+    const bool textureCoordinates = hasSimplifyAttribute(mesh, MeshAttribute::TextureCoordinates, options.simplifyTextureCoordinatesWeight);
+    const bool colors = hasSimplifyAttribute(mesh, MeshAttribute::Color, options.simplifyColorWeight);
+    if(!normals && !textureCoordinates && !colors) return out;
+
+    #if MESHOPTIMIZER_VERSION < 200
+    Warning{} << prefix << "attribute-aware simplification requires meshoptimizer 0.20 or newer, using positions only";
+    return out;
+    #else
+    static_cast<void>(prefix);
+
+    const UnsignedInt componentCount = (normals ? 3 : 0) + (textureCoordinates ? 2 : 0) + (colors ? 4 : 0);
+    const Containers::ArrayView<Float> data = scratchView(scratch.simplifyAttributes, mesh.vertexCount()*componentCount);
+
+    if(normals) {
+        mesh.normalsInto(simplifyAttributeView<Vector3>(data, out.componentCount, componentCount));
+        for(UnsignedInt i = 0; i != 3; ++i)
+            out.weights[out.componentCount++] = options.simplifyNormalWeight;
+    }
+    if(textureCoordinates) {
+        mesh.textureCoordinates2DInto(simplifyAttributeView<Vector2>(data, out.componentCount, componentCount));
+        for(UnsignedInt i = 0; i != 2; ++i)
+            out.weights[out.componentCount++] = options.simplifyTextureCoordinatesWeight;
+    }
+    if(colors) {
+        mesh.colorsInto(simplifyAttributeView<Color4>(data, out.componentCount, componentCount));
+        for(UnsignedInt i = 0; i != 4; ++i)
+            out.weights[out.componentCount++] = options.simplifyColorWeight;
+    }
+
+    CORRADE_INTERNAL_ASSERT(out.componentCount == componentCount);
+    out.data = data;
+    return out;
+    #endif
+}
+
+/* Uses attribute-aware simplification if there are any attributes, plain
+   meshopt_simplify() otherwise */
+std::size_t simplifyIndices(UnsignedInt* const destination, const Containers::ArrayView<const UnsignedInt> indices, const Containers::StridedArrayView1D<const Vector3> positions, const SimplifyAttributes& attributes, const std::size_t targetIndexCount, const Float targetError, const UnsignedInt simplifyOptions, Float* const resultError) {
+    #if MESHOPTIMIZER_VERSION >= 200
+    if(attributes.componentCount) return meshopt_simplifyWithAttributes(
+        destination,
+        indices.data(),
+        indices.size(),
+        static_cast<const Float*>(positions.data()),
+        positions.size(),
+        positions.stride(),
+        attributes.data.data(),
+        attributes.componentCount*sizeof(Float),
+        attributes.weights,
+        attributes.componentCount,
+        /* Version 0.21 added an optional per-vertex lock array */
+        #if MESHOPTIMIZER_VERSION >= 210
+        nullptr,
+        #endif
+        targetIndexCount,
+        targetError,
+        simplifyOptions,
+        resultError);
+    #else
+    static_cast<void>(attributes);
+    #endif
+
+    /* See adaptMeshOptSimplifySignature() above for details */
+    return adaptMeshOptSimplifySignature<meshopt_simplify>()(
+        destination,
+        indices.data(),
+        indices.size(),
+        static_cast<const Float*>(positions.data()),
+        positions.size(),
+        positions.stride(),
+        targetIndexCount,
+        targetError,
+        simplifyOptions,
+        resultError);
+}
+
+/* meshopt_generateVertexRemapMulti() asserts on more than 16 streams and
+   on streams larger than 256 bytes or with a stride larger than 4096 */
+constexpr std::size_t MaxVertexStreamCount = 16;
+constexpr std::size_t MaxVertexStreamSize = 256;
+constexpr std::size_t MaxVertexStreamStride = MaxVertexStreamCount*MaxVertexStreamSize;
+
+/* meshopt_Stream can describe an attribute only if it has a positive stride
+   and is at most 256 bytes large. Meshes with too many attributes go through
+   the interleaved path as well. */
+bool canUseVertexStreams(const MeshData& mesh) {
+    if(mesh.attributeCount() > MaxVertexStreamCount)
+        return false;
+
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const UnsignedInt arraySize = mesh.attributeArraySize(i);
+        const UnsignedInt size = vertexFormatSize(mesh.attributeFormat(i))*(arraySize ? arraySize : 1);
+        if(size > MaxVertexStreamSize || mesh.attributeStride(i) < Short(size) || std::size_t(mesh.attributeStride(i)) > MaxVertexStreamStride)
+            return false;
+    }
+
+    return true;
+}
+
+/* Turns a non-indexed mesh into an interleaved, owned and indexed one with
+   bitwise-identical vertices merged together. The remap is calculated
+   directly from the original attribute streams and each of them is then
+   copied to its final interleaved location, so non-interleaved input isn't
+   interleaved first. */
+Containers::Optional<MeshData> deduplicateVertices(const char* const prefix, const MeshData& mesh, const SceneConverterFlags flags) {
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        if(isVertexFormatImplementationSpecific(mesh.attributeFormat(i))) {
+            Error{} << prefix << "can't generate indices for a mesh with an implementation-specific vertex format" << reinterpret_cast<void*>(vertexFormatUnwrap(mesh.attributeFormat(i)));
+            return {};
+        }
+    }
+
+    /* If some attribute can't be described as a stream (such as one with a
+       negative stride) or there's too many of them, interleave first and use
+       the interleaved vertex split into chunks of at most 256 bytes instead.
+       That covers vertices up to 4 kB, which is a limit of meshoptimizer. */
+    Containers::Optional<MeshData> interleaved;
+    if(!canUseVertexStreams(mesh))
+        interleaved = MeshTools::interleave(mesh);
+    const MeshData& source = interleaved ? *interleaved : mesh;
+
+    Containers::Array<meshopt_Stream> streams;
+    if(interleaved) {
+        const Containers::StridedArrayView2D<const char> data = MeshTools::interleavedData(source);
+        const std::size_t stride = data.stride()[0];
+        if(stride > MaxVertexStreamStride) {
+            Error{} << prefix << "can't generate indices for a mesh with a vertex stride of" << stride << "bytes, expected at most" << MaxVertexStreamStride;
+            return {};
+        }
+        for(std::size_t offset = 0; offset < data.size()[1]; offset += 256)
+            arrayAppend(streams, meshopt_Stream{data.data() + offset, Math::min(data.size()[1] - offset, MaxVertexStreamSize), stride});
+    } else for(UnsignedInt i = 0; i != source.attributeCount(); ++i) {
+        const Containers::StridedArrayView2D<const char> data = source.attribute(i);
+        arrayAppend(streams, meshopt_Stream{data.data(), data.size()[1], std::size_t(data.stride()[0])});
+    }
+
+    Containers::Array<char> indexData{NoInit, source.vertexCount()*sizeof(UnsignedInt)};
+    const Containers::ArrayView<UnsignedInt> remap = Containers::arrayCast<UnsignedInt>(indexData);
+    const UnsignedInt vertexCount = streams.isEmpty() ? Math::min(source.vertexCount(), 1u) :
+        meshopt_generateVertexRemapMulti(remap.data(), nullptr, source.vertexCount(), source.vertexCount(), streams.data(), streams.size());
+    /* Without attributes all vertices are the same */
+    if(streams.isEmpty())
+        for(UnsignedInt& i: remap) i = 0;
+
+    /* Copy each unique vertex to its location in the output. All duplicates
+       of it write the same value, which is cheaper than finding the first
+       occurrence. */
+    MeshData out = MeshTools::interleavedLayout(source, vertexCount);
+    for(UnsignedInt i = 0; i != source.attributeCount(); ++i) {
+        const Containers::StridedArrayView2D<const char> src = source.attribute(i);
+        const Containers::StridedArrayView2D<char> dst = out.mutableAttribute(i);
+        const std::size_t size = src.size()[1];
+        for(std::size_t j = 0; j != remap.size(); ++j)
+            std::memcpy(dst[remap[j]].data(), src[j].data(), size);
+    }
+
+    if(flags & SceneConverterFlag::Verbose)
+        Debug{} << prefix << "deduplicated" << source.vertexCount() << "vertices to" << vertexCount;
+
+    const MeshIndexData indices{remap};
+    return MeshData{source.primitive(), std::move(indexData), indices,
+        out.releaseVertexData(), out.releaseAttributeData(), vertexCount};
+}
+
+#if MESHOPTIMIZER_VERSION >= 150
+/* Spatial sort of triangles of a triangle soup that got indexed by
+   deduplicateVertices(), which makes the index buffer UnsignedInt and
+   mutable. Done before all other operations, the vertices get reordered to
+   match by optimizeVertexFetch, if enabled. */
+bool spatialSortIndexedTriangles(const char* const prefix, MeshData& mesh) {
+    if(!mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << prefix << "spatialSort requires the mesh to have positions";
+        return false;
+    }
+    if(mesh.indexCount() % 3) {
+        Error{} << prefix << "expected vertex count of a triangle soup to be divisible by three, got" << mesh.indexCount();
+        return false;
+    }
+
+    Containers::Array<Vector3> positionStorage;
+    Containers::StridedArrayView1D<const Vector3> positions;
+    populatePositions(mesh, positionStorage, positions);
+
+    const Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>().asContiguous();
+    Containers::Array<UnsignedInt> sorted{NoInit, indices.size()};
+    meshopt_spatialSortTriangles(sorted.data(), indices.data(), indices.size(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+    Utility::copy(sorted, indices);
+    return true;
+}
+#endif
+
+/* Makes the mesh interleaved, owned and indexed, which all further processing
+   relies on. In add() this is done directly in the calling thread as the
+   input mesh isn't guaranteed to stay around after. */
+Containers::Optional<MeshData> prepare(const char* const prefix, const MeshData& mesh, const SceneConverterFlags flags, const Options& options, Report& report) {
     /* If the mesh is indexed with an implementation-specific index type,
        interleave() won't be able to turn its index buffer into a contiguous
        one. So fail early if that's the case. The mesh doesn't necessarily have
        to be indexed though -- it could be e.g. a triangle strip which we turn
        into an indexed mesh right after. */
     if(mesh.isIndexed() && isMeshIndexTypeImplementationSpecific(mesh.indexType())) {
-        Error{} << "Trade::MeshOptimizerSceneConverter::convert(): can't perform any operation on an implementation-specific index type" << reinterpret_cast<void*>(meshIndexTypeUnwrap(mesh.indexType()));
+        Error{} << prefix << "can't perform any operation on an implementation-specific index type" << reinterpret_cast<void*>(meshIndexTypeUnwrap(mesh.indexType()));
         return {};
     }
 
+    /* Non-indexed triangle soups get deduplicated, which makes them
+       interleaved and owned as well. If spatial sort is enabled, the
+       triangles get sorted right after, as process() would treat the
+       mesh as any other indexed mesh and skip the sort. */
+    if(options.generateIndices && !mesh.isIndexed() && mesh.primitive() == MeshPrimitive::Triangles) {
+        #if MESHOPTIMIZER_VERSION < 150
+        if(options.spatialSort) {
+            Error{} << prefix << "spatialSort requires meshoptimizer 0.15 or newer";
+            return {};
+        }
+        #endif
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Containers::Optional<MeshData> out = deduplicateVertices(prefix, mesh, flags);
+        if(!out) return {};
+        if(options.report) addTiming(report, "generateIndices", start);
+
+        #if MESHOPTIMIZER_VERSION >= 150
+        if(options.spatialSort) {
+            start = std::chrono::steady_clock::now();
+            if(!spatialSortIndexedTriangles(prefix, *out)) return {};
+            if(options.report) addTiming(report, "spatialSort", start);
+        }
+        #endif
+
+        return out;
+    }
+
     /* Make the mesh interleaved (with a contiguous index array) and owned
        first */
     MeshData out = MeshTools::owned(MeshTools::interleave(mesh));
@@ -342,92 +798,1083 @@ Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const Mesh
         out = MeshTools::generateIndices(std::move(out));
     }
 
-    meshopt_VertexCacheStatistics vertexCacheStatsBefore;
-    meshopt_VertexFetchStatistics vertexFetchStatsBefore;
-    meshopt_OverdrawStatistics overdrawStatsBefore;
-    Containers::Array<Vector3> positionStorage;
+    /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
+       thing and fails */
+    return Containers::optional(std::move(out));
+}
+
+#if MESHOPTIMIZER_VERSION >= 150
+/* Reorders the vertices so the vertex with index i ends up at index
+   source[i]. Expects an interleaved mesh with mutable vertex data. */
+void gatherVertices(MeshData& mesh, const Containers::ArrayView<const UnsignedInt> source, Scratch& scratch) {
+    const Containers::StridedArrayView2D<char> vertices = MeshTools::interleavedMutableData(mesh);
+    const std::size_t vertexSize = vertices.size()[1];
+    const Containers::ArrayView<char> copy = scratchView(scratch.vertices, mesh.vertexCount()*vertexSize);
+    Utility::copy(Containers::StridedArrayView2D<const char>{vertices}, Containers::StridedArrayView2D<char>{copy, {mesh.vertexCount(), vertexSize}});
+    for(std::size_t i = 0; i != source.size(); ++i)
+        std::memcpy(vertices[i].data(), copy.data() + source[i]*vertexSize, vertexSize);
+}
+
+template<class T> void remapIndices(const Containers::StridedArrayView1D<T> indices, const Containers::ArrayView<const UnsignedInt> remap) {
+    for(T& i: indices) i = remap[i];
+}
+
+/* Spatial sort of point clouds and triangle soups, which the other
+   operations can't do anything with. Points get sorted along a Morton curve,
+   triangles get sorted by their centroids with the vertices reordered to
+   match. */
+bool spatialSort(const char* const prefix, MeshData& mesh, Scratch& scratch) {
+    if(!mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << prefix << "spatialSort requires the mesh to have positions";
+        return false;
+    }
+
     Containers::StridedArrayView1D<const Vector3> positions;
-    Containers::Optional<UnsignedInt> vertexSize;
-    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convert():", out, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
-        return Containers::NullOpt;
+    populatePositions(mesh, scratch.positions, positions);
 
-    if(configuration().value<bool>("simplify") ||
-       configuration().value<bool>("simplifySloppy"))
-    {
-        const UnsignedInt targetIndexCount = out.indexCount()*configuration().value<Float>("simplifyTargetIndexCountThreshold");
-        const Float targetError = configuration().value<Float>("simplifyTargetError");
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    const Containers::ArrayView<UnsignedInt> source = scratchView(scratch.simplifiedIndices, vertexCount);
+
+    if(mesh.primitive() == MeshPrimitive::Points) {
+        /* The remap is the new location of each vertex, invert it to know
+           where to take each vertex from */
+        const Containers::ArrayView<UnsignedInt> remap = scratchView(scratch.indices, vertexCount);
+        meshopt_spatialSortRemap(remap.data(), static_cast<const Float*>(positions.data()), vertexCount, positions.stride());
+        for(UnsignedInt i = 0; i != vertexCount; ++i)
+            source[remap[i]] = i;
 
-        /* In this case meshoptimizer doesn't provide overloads, so let's do
-           this on our side instead */
-        Containers::Array<UnsignedInt> inputIndicesStorage;
-        Containers::ArrayView<const UnsignedInt> inputIndices;
-        if(out.indexType() == MeshIndexType::UnsignedInt)
-            inputIndices = out.indices<UnsignedInt>().asContiguous();
-        else {
-            inputIndicesStorage = out.indicesAsArray();
-            inputIndices = inputIndicesStorage;
+        /* If the points are indexed, make the indices point to the new
+           locations. The index buffer is contiguous and mutable after
+           prepare(). */
+        if(mesh.isIndexed()) {
+            if(mesh.indexType() == MeshIndexType::UnsignedInt)
+                remapIndices(mesh.mutableIndices<UnsignedInt>(), remap);
+            else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+                remapIndices(mesh.mutableIndices<UnsignedShort>(), remap);
+            else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+                remapIndices(mesh.mutableIndices<UnsignedByte>(), remap);
+            else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
         }
 
-        Containers::Array<UnsignedInt> outputIndices;
-        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, NoInit, mesh.indexCount());
+    } else {
+        CORRADE_INTERNAL_ASSERT(mesh.primitive() == MeshPrimitive::Triangles && !mesh.isIndexed());
+        if(vertexCount % 3) {
+            Error{} << prefix << "expected vertex count of a triangle soup to be divisible by three, got" << vertexCount;
+            return false;
+        }
+
+        /* Each triangle of the soup is a consecutive triplet of vertices, so
+           the sorted identity index buffer directly says where to take each
+           vertex from */
+        const Containers::ArrayView<UnsignedInt> indices = scratchView(scratch.indices, vertexCount);
+        for(UnsignedInt i = 0; i != vertexCount; ++i) indices[i] = i;
+        meshopt_spatialSortTriangles(source.data(), indices.data(), vertexCount, static_cast<const Float*>(positions.data()), vertexCount, positions.stride());
+    }
+
+    gatherVertices(mesh, source, scratch);
+    return true;
+}
+#endif
+
+bool process(const char* const prefix, MeshData& out, const SceneConverterFlags flags, const Options& options, Scratch& scratch, Report& report) {
+    /* Point clouds and triangle soups only get spatially sorted, if enabled.
+       Other meshes are left to the checks in convertInPlaceInternal(). */
+    if(options.spatialSort && (out.primitive() == MeshPrimitive::Points || (out.primitive() == MeshPrimitive::Triangles && !out.isIndexed()))) {
+        #if MESHOPTIMIZER_VERSION >= 150
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if(!spatialSort(prefix, out, scratch)) return false;
+        if(options.report) addTiming(report, "spatialSort", start);
+        return true;
+        #else
+        Error{} << prefix << "spatialSort requires meshoptimizer 0.15 or newer";
+        return false;
+        #endif
+    }
+
+    Statistics before;
+    Containers::StridedArrayView1D<const Vector3> positions;
+    Containers::Optional<UnsignedInt> vertexSize;
+    if(!convertInPlaceInternal(prefix, out, flags, options, scratch.positions, positions, vertexSize, before, report))
+        return false;
+
+    if(options.simplify || options.simplifySloppy) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const UnsignedInt targetIndexCount = out.indexCount()*options.simplifyTargetIndexCountThreshold;
+        const Float targetError = options.simplifyTargetError;
+
+        const Containers::ArrayView<const UnsignedInt> inputIndices = indicesAsUnsignedInt(out, scratch.indices);
+        const Containers::ArrayView<UnsignedInt> simplifiedIndices = scratchView(scratch.simplifiedIndices, out.indexCount());
 
         UnsignedInt vertexCount;
-        if(configuration().value<bool>("simplifySloppy")) {
+        if(options.simplifySloppy) {
             /* The nullptr at the end is not needed but without it GCC's
                -Wzero-as-null-pointer-constant fires due to the default
                argument being `= 0`. WHAT THE FUCK, how is this warning
                useful?! Why everything today feels like hastily patched
                together by incompetent idiots?! */
-            vertexCount = meshopt_simplifySloppy(outputIndices.data(), inputIndices.data(), out.indexCount(), static_cast<const float*>(positions.data()), out.vertexCount(), positions.stride(), targetIndexCount
+            vertexCount = meshopt_simplifySloppy(simplifiedIndices.data(), inputIndices.data(), out.indexCount(), static_cast<const float*>(positions.data()), out.vertexCount(), positions.stride(), targetIndexCount
                 #if MESHOPTIMIZER_VERSION >= 160
                 , targetError, nullptr
                 #endif
             );
         } else {
-            /* See adaptMeshOptSimplifySignature() above for details */
-            vertexCount = adaptMeshOptSimplifySignature<meshopt_simplify>()(
-                outputIndices.data(),
-                inputIndices.data(),
-                out.indexCount(),
-                static_cast<const Float*>(positions.data()),
-                out.vertexCount(),
-                positions.stride(),
+            vertexCount = simplifyIndices(
+                simplifiedIndices.data(),
+                inputIndices,
+                positions,
+                populateSimplifyAttributes(prefix, out, options, scratch),
                 targetIndexCount,
                 targetError,
-                configuration().value<bool>("simplifyLockBorder") ?
+                options.simplifyLockBorder ?
                     /** @todo switch to #if MESHOPTIMIZER_VERSION >= 180 once
                         enough time passes (released on 2022-08-01) */
                     1 /*meshopt_SimplifyLockBorder*/ : 0,
                 nullptr);
         }
 
-        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, vertexCount);
+        /* The simplification was done into a scratch buffer, copy the result
+           to an array of the exact size */
+        Containers::Array<UnsignedInt> outputIndices;
+        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, NoInit, vertexCount);
+        Utility::copy(simplifiedIndices.prefix(vertexCount), outputIndices);
 
         /* Take the original mesh vertex data with the reduced index buffer and
            call combineIndexedAttributes() to throw away the unused vertices */
-        /** @todo provide a way to use the new vertices with the original
-            vertex buffer for LODs */
         MeshIndexData indices{outputIndices};
         out = Trade::MeshData{out.primitive(),
             Containers::arrayAllocatorCast<char, Trade::ArrayAllocator>(std::move(outputIndices)), indices,
             out.releaseVertexData(), out.releaseAttributeData()};
         out = MeshTools::combineIndexedAttributes({out});
+        if(options.report) addTiming(report, "simplify", start);
 
-        /* If we're printing stats after, repopulate the positions to avoid
+        /* If we're calculating stats after, repopulate the positions to avoid
            using a now-gone array */
-        if(flags() & SceneConverterFlag::Verbose)
-            populatePositions(out, positionStorage, positions);
+        if((flags & SceneConverterFlag::Verbose) || options.report)
+            populatePositions(out, scratch.positions, positions);
+    }
+
+    /* Print before & after stats if verbose output is requested, save them if
+       the report is */
+    if((flags & SceneConverterFlag::Verbose) || options.report)
+        analyzePost(prefix, out, flags, options, positions, vertexSize, before, report);
+
+    return true;
+}
+
+#if MESHOPTIMIZER_VERSION >= 170
+/* Names of custom attributes in the meshlet mesh level, indexed by the custom
+   attribute ID */
+constexpr const char* MeshletAttributeNames[]{
+    "meshletVertices",
+    "meshletTriangles",
+    "meshletVertexCount",
+    "meshletTriangleCount",
+    "meshletBoundingSphere",
+    "meshletConeApex",
+    "meshletConeAxis",
+    "meshletConeCutoff"
+};
+
+struct MeshletBounds {
+    UnsignedInt vertexCount;
+    UnsignedInt triangleCount;
+    Vector4 boundingSphere;
+    Vector3 coneApex;
+    Vector3 coneAxis;
+    Float coneCutoff;
+};
+
+MeshData buildMeshlets(const MeshData& mesh, const Containers::StridedArrayView1D<const Vector3> positions, const Options& options, Scratch& scratch) {
+    const UnsignedInt maxVertices = options.meshletMaxVertices;
+    const UnsignedInt maxTriangles = options.meshletMaxTriangles;
+
+    /* Same as with simplification, meshoptimizer has no overloads for smaller
+       index types here */
+    const Containers::ArrayView<const UnsignedInt> indices = indicesAsUnsignedInt(mesh, scratch.indices);
+
+    const std::size_t maxMeshletCount = meshopt_buildMeshletsBound(indices.size(), maxVertices, maxTriangles);
+    const Containers::ArrayView<meshopt_Meshlet> meshlets = scratchView(scratch.meshlets, maxMeshletCount);
+    const Containers::ArrayView<UnsignedInt> meshletVertices = scratchView(scratch.meshletVertices, maxMeshletCount*maxVertices);
+    const Containers::ArrayView<UnsignedByte> meshletTriangles = scratchView(scratch.meshletTriangles, maxMeshletCount*maxTriangles*3);
+    const std::size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(), indices.data(), indices.size(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride(), maxVertices, maxTriangles, options.meshletConeWeight);
+
+    /* Each meshlet is an item of a MeshPrimitive::Meshlets mesh, with the
+       vertex and triangle lists stored in fixed-size array attributes so they
+       can be accessed directly. Non-interleaved, first vertices, then
+       triangles padded to four bytes, then the per-meshlet properties. */
+    const std::size_t verticesSize = meshletCount*maxVertices*sizeof(UnsignedInt);
+    const std::size_t trianglesSize = (meshletCount*maxTriangles*3 + 3) & ~std::size_t{3};
+    Containers::Array<char> data{ValueInit, verticesSize + trianglesSize + meshletCount*sizeof(MeshletBounds)};
+    const Containers::ArrayView<UnsignedInt> outVertices = Containers::arrayCast<UnsignedInt>(data.prefix(verticesSize));
+    const Containers::ArrayView<UnsignedByte> outTriangles = Containers::arrayCast<UnsignedByte>(data.slice(verticesSize, verticesSize + meshletCount*maxTriangles*3));
+    const Containers::ArrayView<MeshletBounds> outBounds = Containers::arrayCast<MeshletBounds>(data.exceptPrefix(verticesSize + trianglesSize));
+
+    for(std::size_t i = 0; i != meshletCount; ++i) {
+        const meshopt_Meshlet& meshlet = meshlets[i];
+        Utility::copy(meshletVertices.slice(meshlet.vertex_offset, meshlet.vertex_offset + meshlet.vertex_count),
+            outVertices.slice(i*maxVertices, i*maxVertices + meshlet.vertex_count));
+        Utility::copy(meshletTriangles.slice(meshlet.triangle_offset, meshlet.triangle_offset + meshlet.triangle_count*3),
+            outTriangles.slice(i*maxTriangles*3, i*maxTriangles*3 + meshlet.triangle_count*3));
+
+        const meshopt_Bounds bounds = meshopt_computeMeshletBounds(meshletVertices + meshlet.vertex_offset, meshletTriangles + meshlet.triangle_offset, meshlet.triangle_count, static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+        outBounds[i].vertexCount = meshlet.vertex_count;
+        outBounds[i].triangleCount = meshlet.triangle_count;
+        outBounds[i].boundingSphere = {Vector3::from(bounds.center), bounds.radius};
+        outBounds[i].coneApex = Vector3::from(bounds.cone_apex);
+        outBounds[i].coneAxis = Vector3::from(bounds.cone_axis);
+        outBounds[i].coneCutoff = bounds.cone_cutoff;
+    }
+
+    const Containers::StridedArrayView1D<const MeshletBounds> bounds = outBounds;
+    Containers::Array<MeshAttributeData> attributes{InPlaceInit, {
+        MeshAttributeData{meshAttributeCustom(0), VertexFormat::UnsignedInt,
+            Containers::StridedArrayView1D<const void>{data, outVertices.data(), meshletCount, std::ptrdiff_t(maxVertices*sizeof(UnsignedInt))},
+            UnsignedShort(maxVertices)},
+        MeshAttributeData{meshAttributeCustom(1), VertexFormat::UnsignedByte,
+            Containers::StridedArrayView1D<const void>{data, outTriangles.data(), meshletCount, std::ptrdiff_t(maxTriangles*3)},
+            UnsignedShort(maxTriangles*3)},
+        MeshAttributeData{meshAttributeCustom(2), bounds.slice(&MeshletBounds::vertexCount)},
+        MeshAttributeData{meshAttributeCustom(3), bounds.slice(&MeshletBounds::triangleCount)},
+        MeshAttributeData{meshAttributeCustom(4), bounds.slice(&MeshletBounds::boundingSphere)},
+        MeshAttributeData{meshAttributeCustom(5), bounds.slice(&MeshletBounds::coneApex)},
+        MeshAttributeData{meshAttributeCustom(6), bounds.slice(&MeshletBounds::coneAxis)},
+        MeshAttributeData{meshAttributeCustom(7), bounds.slice(&MeshletBounds::coneCutoff)}
+    }};
+
+    return MeshData{MeshPrimitive::Meshlets, std::move(data), std::move(attributes), UnsignedInt(meshletCount)};
+}
+#endif
+
+template<class T> MeshIndexData copyIndices(const Containers::ArrayView<const UnsignedInt> indices, const Containers::ArrayView<char> indexData) {
+    const Containers::ArrayView<T> out = Containers::arrayCast<T>(indexData);
+    for(std::size_t i = 0; i != indices.size(); ++i) out[i] = indices[i];
+    return MeshIndexData{out};
+}
+
+/* Creates a mesh level sharing the vertex data and attribute layout of the
+   base mesh, with the index type matching the base mesh as well */
+MeshData sharedVertexLevel(const MeshData& mesh, const Containers::ArrayView<const UnsignedInt> indices) {
+    Containers::Array<char> indexData{NoInit, indices.size()*meshIndexTypeSize(mesh.indexType())};
+    MeshIndexData indexView;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        indexView = copyIndices<UnsignedInt>(indices, indexData);
+    else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+        indexView = copyIndices<UnsignedShort>(indices, indexData);
+    else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+        indexView = copyIndices<UnsignedByte>(indices, indexData);
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        attributes[i] = mesh.attributeData()[i];
+
+    return MeshData{mesh.primitive(), std::move(indexData), indexView,
+        DataFlags{}, mesh.vertexData(), std::move(attributes), mesh.vertexCount()};
+}
+
+/* Generates an index buffer referencing only the first of vertices with
+   bitwise identical positions, for position-only rendering such as depth
+   prepass or shadows. Shares the vertex data with the base mesh. */
+MeshData shadowLevel(const MeshData& mesh, const Options& options, Scratch& scratch) {
+    const Containers::ArrayView<const UnsignedInt> indices = indicesAsUnsignedInt(mesh, scratch.indices);
+    const Containers::ArrayView<UnsignedInt> shadowIndices = scratchView(scratch.simplifiedIndices, indices.size());
+    const Containers::StridedArrayView2D<const char> positions = mesh.attribute(MeshAttribute::Position);
+    meshopt_generateShadowIndexBuffer(shadowIndices.data(), indices.data(), indices.size(), positions.data(), mesh.vertexCount(), positions.size()[1], positions.stride()[0]);
+
+    /* With fewer unique vertices the cache order of the base mesh is no
+       longer optimal */
+    if(options.optimizeVertexCache)
+        meshopt_optimizeVertexCache(shadowIndices.data(), shadowIndices.data(), shadowIndices.size(), mesh.vertexCount());
+
+    return sharedVertexLevel(mesh, shadowIndices);
+}
+
+/* Generates a chain of progressively simplified index buffers, each
+   simplified from the previous one. The levels reference vertex data of the
+   base mesh, the accumulated simplification error of each is put into
+   errors. */
+Containers::Array<MeshData> generateLods(const char* const prefix, const MeshData& mesh, const Containers::StridedArrayView1D<const Vector3> positions, const Options& options, Scratch& scratch, Containers::Array<Float>& errors) {
+    /* All levels reference the same vertices, so the attributes are gathered
+       just once */
+    const SimplifyAttributes attributes = populateSimplifyAttributes(prefix, mesh, options, scratch);
+    const UnsignedInt simplifyOptions = options.simplifyLockBorder ?
+        /** @todo switch to #if MESHOPTIMIZER_VERSION >= 180 once enough time
+            passes (released on 2022-08-01) */
+        1 /*meshopt_SimplifyLockBorder*/ : 0;
+
+    /* The two scratch buffers get swapped after each level */
+    Containers::ArrayView<UnsignedInt> previous = scratchView(scratch.indices, mesh.indexCount());
+    Containers::ArrayView<UnsignedInt> current = scratchView(scratch.simplifiedIndices, mesh.indexCount());
+    mesh.indicesInto(previous);
+    std::size_t previousCount = mesh.indexCount();
+    Float error = 0.0f;
+
+    Containers::Array<MeshData> lods;
+    for(UnsignedInt i = 0; i != options.lodCount; ++i) {
+        /* On versions before 0.16 the error isn't reported and stays zero.
+           With attributes it includes the weighted attribute error. */
+        Float levelError = 0.0f;
+        const std::size_t count = simplifyIndices(
+            current.data(),
+            previous.prefix(previousCount),
+            positions,
+            attributes,
+            std::size_t(previousCount*options.lodTargetIndexCountThreshold),
+            options.lodTargetError,
+            simplifyOptions,
+            &levelError);
+
+        /* If the simplification can't make any more progress, stop the chain
+           early instead of producing duplicate levels */
+        if(!count || count >= previousCount) break;
+
+        if(options.optimizeVertexCache)
+            meshopt_optimizeVertexCache(current.data(), current.data(), count, mesh.vertexCount());
+
+        error += levelError;
+        arrayAppend(errors, error);
+        arrayAppend(lods, sharedVertexLevel(mesh, current.prefix(count)));
+
+        std::swap(previous, current);
+        previousCount = count;
+    }
+
+    return lods;
+}
+
+/* Layout of the encoded data produced by convertToData() and by convert()
+   with the encode option enabled. Header, followed by a description of each
+   attribute, then the encoded vertex stream and the encoded index stream. All
+   header and attribute fields are little-endian. */
+constexpr char EncodedMagic[4]{'M', 'O', 'P', 'T'};
+constexpr UnsignedInt EncodedVersion = 1;
+/* Implementation-specific primitive of a MeshData wrapping the encoded data,
+   the same four characters */
+constexpr UnsignedInt EncodedPrimitive = 0x4d4f5054;
+
+struct EncodedHeader {
+    char magic[4];
+    UnsignedInt version;
+    UnsignedInt primitive;
+    UnsignedInt indexType;
+    UnsignedInt indexCount;
+    UnsignedInt vertexCount;
+    UnsignedInt vertexStride;
+    UnsignedInt attributeCount;
+    UnsignedInt encodedVertexSize;
+    UnsignedInt encodedIndexSize;
+};
+
+static_assert(sizeof(EncodedHeader) == 40, "improper size of EncodedHeader");
+
+struct EncodedAttribute {
+    UnsignedShort name;
+    UnsignedShort arraySize;
+    UnsignedInt format;
+    UnsignedInt offset;
+};
+
+static_assert(sizeof(EncodedAttribute) == 12, "improper size of EncodedAttribute");
+
+Containers::Optional<Containers::Array<char>> encode(const char* const prefix, const MeshData& mesh, Scratch& scratch) {
+    /* The index codec works only on triangles, process() lets through also
+       spatially sorted points and triangle soups */
+    if(mesh.primitive() != MeshPrimitive::Triangles || !mesh.isIndexed()) {
+        Error{} << prefix << "expected an indexed triangle mesh for encoding";
+        return {};
+    }
+    CORRADE_INTERNAL_ASSERT(MeshTools::isInterleaved(mesh));
+
+    /* The vertex codec works on whole vertices and requires the size to be a
+       multiple of four */
+    Containers::StridedArrayView2D<const char> vertices;
+    std::size_t stride = 0;
+    std::size_t vertexOffset = 0;
+    if(mesh.attributeCount()) {
+        vertices = MeshTools::interleavedData(mesh);
+        stride = vertices.stride()[0];
+        vertexOffset = static_cast<const char*>(vertices.data()) - mesh.vertexData().data();
+        if(stride % 4 || stride > 256) {
+            Error{} << prefix << "expected vertex stride to be a multiple of four and at most 256 bytes for encoding, got" << stride;
+            return {};
+        }
+    }
+
+    /* Copy the vertices to a contiguous buffer. If the attributes don't span
+       the whole stride, zero-fill the rest so the output is deterministic. */
+    const std::size_t vertexCount = mesh.vertexCount();
+    const Containers::ArrayView<char> contiguousVertices = scratchView(scratch.vertices, vertexCount*stride);
+    if(stride) {
+        if(vertices.size()[1] != stride)
+            std::memset(contiguousVertices.data(), 0, contiguousVertices.size());
+        Utility::copy(vertices, Containers::StridedArrayView2D<char>{contiguousVertices, {vertexCount, stride}}.prefix({vertexCount, vertices.size()[1]}));
+    }
+
+    /* Encode both streams into a scratch buffer first, the final size isn't
+       known upfront */
+    const std::size_t vertexBound = stride ? meshopt_encodeVertexBufferBound(vertexCount, stride) : 0;
+    const std::size_t indexBound = meshopt_encodeIndexBufferBound(mesh.indexCount(), vertexCount);
+    const Containers::ArrayView<char> encoded = scratchView(scratch.encoded, vertexBound + indexBound);
+    const std::size_t encodedVertexSize = stride ? meshopt_encodeVertexBuffer(reinterpret_cast<unsigned char*>(encoded.data()), vertexBound, contiguousVertices.data(), vertexCount, stride) : 0;
+    const Containers::ArrayView<const UnsignedInt> indices = indicesAsUnsignedInt(mesh, scratch.indices);
+    const std::size_t encodedIndexSize = meshopt_encodeIndexBuffer(reinterpret_cast<unsigned char*>(encoded.data() + encodedVertexSize), indexBound, indices.data(), indices.size());
+    CORRADE_INTERNAL_ASSERT((encodedVertexSize || !stride) && encodedIndexSize);
+
+    const std::size_t headerSize = sizeof(EncodedHeader) + mesh.attributeCount()*sizeof(EncodedAttribute);
+    Containers::Array<char> out{NoInit, headerSize + encodedVertexSize + encodedIndexSize};
+
+    EncodedHeader& header = *reinterpret_cast<EncodedHeader*>(out.data());
+    Utility::copy(EncodedMagic, header.magic);
+    header.version = EncodedVersion;
+    header.primitive = UnsignedInt(mesh.primitive());
+    header.indexType = UnsignedInt(mesh.indexType());
+    header.indexCount = mesh.indexCount();
+    header.vertexCount = vertexCount;
+    header.vertexStride = stride;
+    header.attributeCount = mesh.attributeCount();
+    header.encodedVertexSize = encodedVertexSize;
+    header.encodedIndexSize = encodedIndexSize;
+    Utility::Endianness::littleEndianInPlace(header.version, header.primitive,
+        header.indexType, header.indexCount, header.vertexCount,
+        header.vertexStride, header.attributeCount, header.encodedVertexSize,
+        header.encodedIndexSize);
+
+    const Containers::ArrayView<EncodedAttribute> attributes = Containers::arrayCast<EncodedAttribute>(out.slice(sizeof(EncodedHeader), headerSize));
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        EncodedAttribute& attribute = attributes[i];
+        attribute.name = UnsignedShort(mesh.attributeName(i));
+        attribute.arraySize = mesh.attributeArraySize(i);
+        attribute.format = UnsignedInt(mesh.attributeFormat(i));
+        attribute.offset = mesh.attributeOffset(i) - vertexOffset;
+        Utility::Endianness::littleEndianInPlace(attribute.name,
+            attribute.arraySize, attribute.format, attribute.offset);
     }
 
-    /* Print before & after stats if verbose output is requested */
-    if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convert():", out, configuration(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    Utility::copy(encoded.prefix(encodedVertexSize + encodedIndexSize), out.exceptPrefix(headerSize));
 
     /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
        thing and fails */
     return Containers::optional(std::move(out));
 }
 
+/* The last format known to this code, anything above that isn't accepted in
+   the encoded data */
+constexpr VertexFormat LastVertexFormat = VertexFormat::Matrix4x4sNormalized;
+
+/* Mirrors the format restrictions MeshAttributeData has for builtin
+   attributes, which are otherwise only asserted. Expects a valid
+   non-implementation-specific format. */
+bool isVertexFormatAllowed(const MeshAttribute name, const VertexFormat format) {
+    if(isMeshAttributeCustom(name)) return true;
+    if(vertexFormatVectorCount(format) != 1) return false;
+
+    const VertexFormat componentFormat = vertexFormatComponentFormat(format);
+    const UnsignedInt componentCount = vertexFormatComponentCount(format);
+    const bool normalized = isVertexFormatNormalized(format);
+    const bool floatingPoint = componentFormat == VertexFormat::Float || componentFormat == VertexFormat::Half;
+    const bool integer = componentFormat == VertexFormat::UnsignedByte || componentFormat == VertexFormat::Byte || componentFormat == VertexFormat::UnsignedShort || componentFormat == VertexFormat::Short;
+    const bool signedNormalized = normalized && (componentFormat == VertexFormat::Byte || componentFormat == VertexFormat::Short);
+    const bool unsignedNormalized = normalized && (componentFormat == VertexFormat::UnsignedByte || componentFormat == VertexFormat::UnsignedShort);
+    switch(name) {
+        case MeshAttribute::Position:
+            return (componentCount == 2 || componentCount == 3) &&
+                (floatingPoint || integer);
+        case MeshAttribute::TextureCoordinates:
+            return componentCount == 2 && (floatingPoint || integer);
+        case MeshAttribute::Tangent:
+            return (componentCount == 3 || componentCount == 4) &&
+                (floatingPoint || signedNormalized);
+        case MeshAttribute::Normal:
+        case MeshAttribute::Bitangent:
+            return componentCount == 3 && (floatingPoint || signedNormalized);
+        case MeshAttribute::Color:
+            return (componentCount == 3 || componentCount == 4) &&
+                (floatingPoint || unsignedNormalized);
+        case MeshAttribute::ObjectId:
+            return componentCount == 1 && !normalized &&
+                (componentFormat == VertexFormat::UnsignedInt || componentFormat == VertexFormat::UnsignedShort || componentFormat == VertexFormat::UnsignedByte);
+        /* Builtin attributes unknown to this code */
+        default: return false;
+    }
+}
+
+Containers::Optional<MeshData> decode(const char* const prefix, const Containers::ArrayView<const char> data, Scratch& scratch) {
+    /* The data may come from a file without any alignment guarantees, so
+       the header and attributes are copied out instead of cast */
+    if(data.size() < sizeof(EncodedHeader)) {
+        Error{} << prefix << "expected at least" << sizeof(EncodedHeader) << "bytes of encoded data but got" << data.size();
+        return {};
+    }
+
+    EncodedHeader header;
+    std::memcpy(&header, data.data(), sizeof(EncodedHeader));
+    Utility::Endianness::littleEndianInPlace(header.version, header.primitive,
+        header.indexType, header.indexCount, header.vertexCount,
+        header.vertexStride, header.attributeCount, header.encodedVertexSize,
+        header.encodedIndexSize);
+    if(std::memcmp(header.magic, EncodedMagic, sizeof(EncodedMagic)) != 0 || header.version != EncodedVersion) {
+        Error{} << prefix << "invalid encoded data signature or version";
+        return {};
+    }
+
+    /* Only indexed triangle meshes get encoded */
+    if(header.primitive != UnsignedInt(MeshPrimitive::Triangles)) {
+        Error{} << prefix << "invalid encoded primitive" << reinterpret_cast<void*>(std::size_t(header.primitive));
+        return {};
+    }
+
+    /* Same restriction as in encode(), the vertex codec asserts otherwise */
+    if(header.vertexStride % 4 || header.vertexStride > 256) {
+        Error{} << prefix << "invalid encoded vertex stride" << header.vertexStride;
+        return {};
+    }
+
+    const std::size_t headerSize = sizeof(EncodedHeader) + std::size_t(header.attributeCount)*sizeof(EncodedAttribute);
+    const std::size_t expectedSize = headerSize + std::size_t(header.encodedVertexSize) + header.encodedIndexSize;
+    if(data.size() != expectedSize) {
+        Error{} << prefix << "expected" << expectedSize << "bytes of encoded data but got" << data.size();
+        return {};
+    }
+
+    if(header.indexType < UnsignedInt(MeshIndexType::UnsignedByte) || header.indexType > UnsignedInt(MeshIndexType::UnsignedInt) || header.indexCount % 3) {
+        Error{} << prefix << "invalid encoded index type or count";
+        return {};
+    }
+
+    Containers::Array<MeshAttributeData> attributes{header.attributeCount};
+    for(UnsignedInt i = 0; i != header.attributeCount; ++i) {
+        EncodedAttribute attribute;
+        std::memcpy(&attribute, data.data() + sizeof(EncodedHeader) + i*sizeof(EncodedAttribute), sizeof(EncodedAttribute));
+        Utility::Endianness::littleEndianInPlace(attribute.name,
+            attribute.arraySize, attribute.format, attribute.offset);
+
+        /* Check the name, format and array size first, MeshAttributeData
+           would assert on invalid combinations. Array attributes are only
+           allowed for custom attributes and builtin attributes have
+           restrictions on allowed formats. */
+        const MeshAttribute name = MeshAttribute(attribute.name);
+        const VertexFormat format = VertexFormat(attribute.format);
+        if(name == MeshAttribute{} || (!isMeshAttributeCustom(name) && UnsignedShort(name) > UnsignedShort(MeshAttribute::ObjectId))) {
+            Error{} << prefix << "invalid encoded attribute" << i << "name" << attribute.name;
+            return {};
+        }
+        if(format == VertexFormat{} || (!isVertexFormatImplementationSpecific(format) && UnsignedInt(format) > UnsignedInt(LastVertexFormat))) {
+            Error{} << prefix << "invalid encoded attribute" << i << "format" << reinterpret_cast<void*>(std::size_t(attribute.format));
+            return {};
+        }
+        if(attribute.arraySize && (!isMeshAttributeCustom(name) || isVertexFormatImplementationSpecific(format))) {
+            Error{} << prefix << "invalid encoded attribute" << i << "array size" << attribute.arraySize << "for" << name << "of" << format;
+            return {};
+        }
+        if(!isVertexFormatImplementationSpecific(format) && !isVertexFormatAllowed(name, format)) {
+            Error{} << prefix << "invalid encoded attribute" << i << "format" << format << "for" << name;
+            return {};
+        }
+
+        const std::size_t size = isVertexFormatImplementationSpecific(format) ? 1 :
+            vertexFormatSize(format)*(attribute.arraySize ? attribute.arraySize : 1);
+        if(attribute.offset + size > header.vertexStride) {
+            Error{} << prefix << "encoded attribute" << i << "out of bounds for a stride of" << header.vertexStride << "bytes";
+            return {};
+        }
+
+        attributes[i] = MeshAttributeData{name, format, attribute.offset, header.vertexCount, std::ptrdiff_t(header.vertexStride), attribute.arraySize};
+    }
+
+    Containers::Array<char> vertexData{NoInit, std::size_t(header.vertexCount)*header.vertexStride};
+    if(header.vertexStride && meshopt_decodeVertexBuffer(vertexData.data(), header.vertexCount, header.vertexStride, reinterpret_cast<const unsigned char*>(data.data() + headerSize), header.encodedVertexSize) != 0) {
+        Error{} << prefix << "invalid encoded vertex data";
+        return {};
+    }
+
+    const Containers::ArrayView<UnsignedInt> indices = scratchView(scratch.indices, header.indexCount);
+    if(meshopt_decodeIndexBuffer(indices.data(), header.indexCount, sizeof(UnsignedInt), reinterpret_cast<const unsigned char*>(data.data() + headerSize + header.encodedVertexSize), header.encodedIndexSize) != 0) {
+        Error{} << prefix << "invalid encoded index data";
+        return {};
+    }
+
+    /* The decoder doesn't check the index range, do it here so invalid
+       data can't cause out-of-bounds access later */
+    const MeshIndexType indexType = MeshIndexType(header.indexType);
+    const UnsignedInt maxIndex = indexType == MeshIndexType::UnsignedByte ? 0xff :
+        indexType == MeshIndexType::UnsignedShort ? 0xffff : 0xffffffffu;
+    for(const UnsignedInt index: indices) {
+        if(index >= header.vertexCount || index > maxIndex) {
+            Error{} << prefix << "encoded index" << index << "out of range for" << header.vertexCount << "vertices";
+            return {};
+        }
+    }
+
+    Containers::Array<char> indexData{NoInit, indices.size()*meshIndexTypeSize(indexType)};
+    MeshIndexData indexView;
+    if(indexType == MeshIndexType::UnsignedInt)
+        indexView = copyIndices<UnsignedInt>(indices, indexData);
+    else if(indexType == MeshIndexType::UnsignedShort)
+        indexView = copyIndices<UnsignedShort>(indices, indexData);
+    else if(indexType == MeshIndexType::UnsignedByte)
+        indexView = copyIndices<UnsignedByte>(indices, indexData);
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    return MeshData{MeshPrimitive(header.primitive),
+        std::move(indexData), indexView,
+        std::move(vertexData), std::move(attributes), header.vertexCount};
+}
+
+/* A mesh added in add(), processed either directly or on a worker thread */
+struct Job {
+    explicit Job(MeshData&& mesh) {
+        arrayAppend(levels, std::move(mesh));
+    }
+
+    /* The first level is the prepared mesh, the rest gets filled by
+       processLevels() */
+    Containers::Array<MeshData> levels;
+    Containers::Array<Float> lodErrors;
+    Report report;
+    /* Output captured on a worker thread, printed in end() */
+    std::string debugOutput, warningOutput, errorOutput;
+    bool success = false;
+};
+
+constexpr const char* AddPrefix = "Trade::MeshOptimizerSceneConverter::add():";
+
+bool processLevels(Job& job, const SceneConverterFlags flags, const Options& options, Scratch& scratch) {
+    MeshData& mesh = job.levels[0];
+    if(!process(AddPrefix, mesh, flags, options, scratch, job.report))
+        return false;
+
+    /* Spatially sorted points and triangle soups pass through process() */
+    if((options.generateShadowIndices || options.lodCount || options.buildMeshlets) && (mesh.primitive() != MeshPrimitive::Triangles || !mesh.isIndexed())) {
+        Error{} << AddPrefix << "shadow indices, LODs and meshlets can be generated only for indexed triangle meshes";
+        return false;
+    }
+    if(options.generateShadowIndices && !mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << AddPrefix << "generateShadowIndices requires the mesh to have positions";
+        return false;
+    }
+    if(options.lodCount && !mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << AddPrefix << "lodCount requires the mesh to have positions";
+        return false;
+    }
+    if(options.buildMeshlets && !mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << AddPrefix << "buildMeshlets requires the mesh to have positions";
+        return false;
+    }
+
+    /* The additional levels are appended only at the end, as growing the
+       array would invalidate the mesh reference */
+    Containers::StridedArrayView1D<const Vector3> positions;
+    if(options.lodCount || options.buildMeshlets)
+        populatePositions(mesh, scratch.positions, positions);
+
+    Containers::Optional<MeshData> shadow;
+    if(options.generateShadowIndices) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        shadow = shadowLevel(mesh, options, scratch);
+        if(options.report) addTiming(job.report, "generateShadowIndices", start);
+    }
+
+    Containers::Array<MeshData> lods;
+    if(options.lodCount) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        lods = generateLods(AddPrefix, mesh, positions, options, scratch, job.lodErrors);
+        if(options.report) addTiming(job.report, "generateLods", start);
+
+        if(flags & SceneConverterFlag::Verbose) {
+            Debug d;
+            d << AddPrefix << "generated" << lods.size() << "LODs";
+            for(std::size_t i = 0; i != lods.size(); ++i)
+                d << Debug::newline << "  " << lods[i].indexCount() << "indices, error" << job.lodErrors[i];
+        }
+    }
+
+    #if MESHOPTIMIZER_VERSION >= 170
+    Containers::Optional<MeshData> meshlets;
+    if(options.buildMeshlets) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        meshlets = buildMeshlets(mesh, positions, options, scratch);
+        if(options.report) addTiming(job.report, "buildMeshlets", start);
+    }
+    #endif
+
+    if(shadow) arrayAppend(job.levels, std::move(*shadow));
+    for(MeshData& lod: lods) arrayAppend(job.levels, std::move(lod));
+    #if MESHOPTIMIZER_VERSION >= 170
+    if(meshlets) arrayAppend(job.levels, std::move(*meshlets));
+    #endif
+
+    return true;
+}
+
+/* Returned from end(), exposing the converted meshes and their levels. The
+   meshes reference data owned by the importer. */
+class MeshOptimizerImporter: public AbstractImporter {
+    public:
+        explicit MeshOptimizerImporter(Containers::Array<Containers::Array<MeshData>>&& meshes, Containers::Array<Containers::String>&& names): _meshes{std::move(meshes)}, _names{std::move(names)} {}
+
+    private:
+        ImporterFeatures doFeatures() const override { return {}; }
+        bool doIsOpened() const override { return _opened; }
+        void doClose() override {
+            _opened = false;
+            _meshes = {};
+            _names = {};
+        }
+
+        UnsignedInt doMeshCount() const override { return _meshes.size(); }
+        UnsignedInt doMeshLevelCount(const UnsignedInt id) override {
+            return _meshes[id].size();
+        }
+        Int doMeshForName(const Containers::StringView name) override {
+            for(std::size_t i = 0; i != _names.size(); ++i)
+                if(_names[i] == name) return i;
+            return -1;
+        }
+        Containers::String doMeshName(const UnsignedInt id) override {
+            return _names[id];
+        }
+        Containers::Optional<MeshData> doMesh(const UnsignedInt id, const UnsignedInt level) override {
+            return MeshTools::reference(_meshes[id][level]);
+        }
+
+        #if MESHOPTIMIZER_VERSION >= 170
+        MeshAttribute doMeshAttributeForName(const Containers::StringView name) override {
+            for(std::size_t i = 0; i != Containers::arraySize(MeshletAttributeNames); ++i)
+                if(name == MeshletAttributeNames[i]) return meshAttributeCustom(i);
+            return {};
+        }
+        Containers::String doMeshAttributeName(const UnsignedShort name) override {
+            return name < Containers::arraySize(MeshletAttributeNames) ?
+                MeshletAttributeNames[name] : "";
+        }
+        #endif
+
+        Containers::Array<Containers::Array<MeshData>> _meshes;
+        Containers::Array<Containers::String> _names;
+        bool _opened = true;
+};
+
+}
+
+namespace {
+
+/* If no enabled operation touches the vertex data, convert() can make a copy
+   of just the index buffer and reference the input vertex data. Encoding
+   needs the vertices to be interleaved. */
+bool canReferenceVertexData(const MeshData& mesh, const Options& options, const bool encoding) {
+    return options.referenceVertexData &&
+        mesh.primitive() == MeshPrimitive::Triangles &&
+        mesh.isIndexed() &&
+        !isMeshIndexTypeImplementationSpecific(mesh.indexType()) &&
+        !(options.optimizeVertexFetch && mesh.attributeCount()) &&
+        !options.simplify &&
+        !options.simplifySloppy &&
+        !(encoding && !MeshTools::isInterleaved(mesh));
+}
+
+MeshData referenceVertexData(const MeshData& mesh) {
+    /* The index buffer gets modified, so make an owned contiguous copy of
+       it */
+    const UnsignedInt indexTypeSize = meshIndexTypeSize(mesh.indexType());
+    Containers::Array<char> indexData{NoInit, mesh.indexCount()*indexTypeSize};
+    Utility::copy(mesh.indices(), Containers::StridedArrayView2D<char>{indexData, {mesh.indexCount(), indexTypeSize}});
+    const MeshIndexData indices{mesh.indexType(), indexData};
+
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        attributes[i] = mesh.attributeData()[i];
+
+    return MeshData{mesh.primitive(), std::move(indexData), indices,
+        DataFlags{}, mesh.vertexData(), std::move(attributes), mesh.vertexCount()};
+}
+
+/* Common for convert() and convertToData() */
+Containers::Optional<MeshData> convertSingle(const char* const prefix, const MeshData& mesh, const SceneConverterFlags flags, const Options& options, const bool encoding, Scratch& scratch, Report& report) {
+    if(options.buildMeshlets || options.lodCount || options.generateShadowIndices) {
+        Error{} << prefix << "meshlets, LODs and shadow indices are produced as additional mesh levels, use begin(), add() and end() instead";
+        return {};
+    }
+
+    Containers::Optional<MeshData> out;
+    if(canReferenceVertexData(mesh, options, encoding))
+        out = referenceVertexData(mesh);
+    else
+        out = prepare(prefix, mesh, flags, options, report);
+    if(!out || !process(prefix, *out, flags, options, scratch, report))
+        return {};
+
+    return out;
+}
+
+Containers::Optional<Containers::Array<char>> encodeTimed(const char* const prefix, const MeshData& mesh, const Options& options, Scratch& scratch, Report& report) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Containers::Optional<Containers::Array<char>> out = encode(prefix, mesh, scratch);
+    if(out && options.report) addTiming(report, "encode", start);
+    return out;
+}
+
+}
+
+Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
+    const char* const prefix = "Trade::MeshOptimizerSceneConverter::convert():";
+    Scratch scratch;
+
+    /* Data produced by the encode option get decoded back, without any other
+       processing */
+    if(mesh.primitive() == meshPrimitiveWrap(EncodedPrimitive))
+        return decode(prefix, mesh.vertexData(), scratch);
+
+    const Options options = readOptions(configuration());
+    configuration().removeAllGroups("report");
+
+    Report report;
+    Containers::Optional<MeshData> out = convertSingle(prefix, mesh, flags(), options, options.encode, scratch, report);
+    if(!out) return {};
+
+    if(options.encode) {
+        Containers::Optional<Containers::Array<char>> data = encodeTimed(prefix, *out, options, scratch, report);
+        if(!data) return {};
+
+        out = MeshData{meshPrimitiveWrap(EncodedPrimitive), std::move(*data), {}, out->vertexCount()};
+    }
+
+    if(options.report)
+        writeReport(*configuration().addGroup("report"), report);
+
+    return out;
+}
+
+Containers::Optional<Containers::Array<char>> MeshOptimizerSceneConverter::doConvertToData(const MeshData& mesh) {
+    const char* const prefix = "Trade::MeshOptimizerSceneConverter::convertToData():";
+    Scratch scratch;
+
+    const Options options = readOptions(configuration());
+    configuration().removeAllGroups("report");
+
+    Report report;
+    Containers::Optional<MeshData> out = convertSingle(prefix, mesh, flags(), options, true, scratch, report);
+    if(!out) return {};
+
+    Containers::Optional<Containers::Array<char>> data = encodeTimed(prefix, *out, options, scratch, report);
+    if(!data) return {};
+
+    if(options.report)
+        writeReport(*configuration().addGroup("report"), report);
+
+    return data;
+}
+
+struct MeshOptimizerSceneConverter::State {
+    ~State() { cancel(); }
+
+    /* Run by each worker thread, takes jobs in order until finish() is
+       called and there's nothing left or until cancel() is called */
+    void work(Scratch& scratch);
+    /* Waits until all jobs are processed and joins the worker threads */
+    void finish();
+    /* Drops jobs that weren't started yet, waits only for the ones being
+       processed and joins the worker threads */
+    void cancel();
+
+    Options options;
+    SceneConverterFlags flags;
+    Containers::Array<Containers::Pointer<Job>> jobs;
+    Containers::Array<Containers::String> names;
+    /* One for each worker thread or just one if processing directly in
+       add() */
+    Containers::Array<Scratch> scratch;
+
+    /* Used only if there's more than one thread. Guards jobs, nextJob,
+       finished and cancelled. */
+    Containers::Array<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t nextJob = 0;
+    bool finished = false;
+    bool cancelled = false;
+};
+
+void MeshOptimizerSceneConverter::State::work(Scratch& scratch) {
+    for(;;) {
+        Job* job;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [&]() { return nextJob != jobs.size() || finished; });
+            if(cancelled || nextJob == jobs.size()) return;
+            job = jobs[nextJob++].get();
+        }
+
+        /* Output redirection is thread-local, so this captures output of just
+           this job, to be printed in end() in the order meshes were added */
+        std::ostringstream debugOutput, warningOutput, errorOutput;
+        {
+            Debug redirectDebug{&debugOutput};
+            Warning redirectWarning{&warningOutput};
+            Error redirectError{&errorOutput};
+            job->success = processLevels(*job, flags, options, scratch);
+        }
+        job->debugOutput = debugOutput.str();
+        job->warningOutput = warningOutput.str();
+        job->errorOutput = errorOutput.str();
+    }
+}
+
+void MeshOptimizerSceneConverter::State::finish() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        finished = true;
+    }
+    condition.notify_all();
+    for(std::thread& worker: workers)
+        if(worker.joinable()) worker.join();
+}
+
+void MeshOptimizerSceneConverter::State::cancel() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        cancelled = true;
+    }
+    finish();
+}
+
+MeshOptimizerSceneConverter::~MeshOptimizerSceneConverter() = default;
+
+bool MeshOptimizerSceneConverter::doBegin() {
+    const char* const prefix = "Trade::MeshOptimizerSceneConverter::begin():";
+    const Options options = readOptions(configuration());
+
+    #if MESHOPTIMIZER_VERSION >= 170
+    if(options.buildMeshlets && (options.meshletMaxVertices < 3 || options.meshletMaxVertices > 255 || options.meshletMaxTriangles < 4 || options.meshletMaxTriangles > 512 || options.meshletMaxTriangles % 4)) {
+        Error{} << prefix << "expected meshletMaxVertices to be between 3 and 255 and meshletMaxTriangles to be a multiple of 4 between 4 and 512, got" << options.meshletMaxVertices << "and" << options.meshletMaxTriangles;
+        return false;
+    }
+    #else
+    if(options.buildMeshlets) {
+        Error{} << prefix << "buildMeshlets requires meshoptimizer 0.17 or newer";
+        return false;
+    }
+    #endif
+
+    if(options.encode) {
+        Error{} << prefix << "encoding is supported only with convert() and convertToData()";
+        return false;
+    }
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    /* Without pthreads there's no way to spawn threads */
+    threadCount = 1;
+    #else
+    if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    /* hardware_concurrency() is allowed to return 0 if it can't tell */
+    if(threadCount == 0) threadCount = 1;
+    #endif
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    /* Without this the output redirection isn't thread-local and so output
+       of the worker threads couldn't be captured */
+    if(threadCount > 1) {
+        if(flags() & SceneConverterFlag::Verbose)
+            Debug{} << prefix << "Corrade isn't built with CORRADE_BUILD_MULTITHREADED, processing on a single thread";
+        threadCount = 1;
+    }
+    #endif
+
+    configuration().removeAllGroups("lod");
+    configuration().removeAllGroups("report");
+
+    _state = Containers::pointer<State>();
+    _state->options = options;
+    _state->flags = flags();
+    _state->scratch = Containers::Array<Scratch>{ValueInit, threadCount};
+    if(threadCount > 1) {
+        _state->workers = Containers::Array<std::thread>{ValueInit, threadCount};
+        State& state = *_state;
+        for(UnsignedInt i = 0; i != threadCount; ++i)
+            state.workers[i] = std::thread{[&state, i]() {
+                state.work(state.scratch[i]);
+            }};
+    }
+
+    return true;
+}
+
+bool MeshOptimizerSceneConverter::doAdd(UnsignedInt, const MeshData& mesh, const Containers::StringView name) {
+    Report report;
+    Containers::Optional<MeshData> prepared = prepare(AddPrefix, mesh, _state->flags, _state->options, report);
+    if(!prepared) return false;
+
+    Containers::Pointer<Job> job = Containers::pointer<Job>(std::move(*prepared));
+    job->report = std::move(report);
+
+    /* Without worker threads process the mesh directly, so failures are
+       reported right away */
+    if(_state->workers.isEmpty()) {
+        if(!processLevels(*job, _state->flags, _state->options, _state->scratch[0]))
+            return false;
+        job->success = true;
+        arrayAppend(_state->jobs, std::move(job));
+
+    /* Otherwise queue it for the workers, failures are reported from end() */
+    } else {
+        {
+            std::lock_guard<std::mutex> lock{_state->mutex};
+            arrayAppend(_state->jobs, std::move(job));
+        }
+        _state->condition.notify_one();
+    }
+
+    arrayAppend(_state->names, Containers::String{name});
+    return true;
+}
+
+void MeshOptimizerSceneConverter::doAbort() {
+    /* The results are discarded, so don't wait for meshes that weren't
+       picked up by the workers yet */
+    _state->cancel();
+    _state = nullptr;
+}
+
+Containers::Pointer<AbstractImporter> MeshOptimizerSceneConverter::doEnd() {
+    Containers::Pointer<State> state = std::move(_state);
+    state->finish();
+
+    /* Go through the results in the order the meshes were added, print
+       captured output and fill in LOD errors and reports */
+    bool success = true;
+    Containers::Array<Containers::Array<MeshData>> meshes{state->jobs.size()};
+    for(std::size_t i = 0; i != state->jobs.size(); ++i) {
+        Job& job = *state->jobs[i];
+        if(!job.debugOutput.empty())
+            Debug{Debug::Flag::NoNewlineAtTheEnd} << job.debugOutput.data();
+        if(!job.warningOutput.empty())
+            Warning{Debug::Flag::NoNewlineAtTheEnd} << job.warningOutput.data();
+        if(!job.errorOutput.empty())
+            Error{Debug::Flag::NoNewlineAtTheEnd} << job.errorOutput.data();
+        if(!job.success) {
+            success = false;
+            continue;
+        }
+
+        if(!job.lodErrors.isEmpty()) {
+            Utility::ConfigurationGroup& lod = *configuration().addGroup("lod");
+            lod.setValue("mesh", UnsignedInt(i));
+            for(const Float error: job.lodErrors) lod.addValue("error", error);
+        }
+
+        if(state->options.report) {
+            Utility::ConfigurationGroup& report = *configuration().addGroup("report");
+            report.setValue("mesh", UnsignedInt(i));
+            writeReport(report, job.report);
+        }
+
+        meshes[i] = std::move(job.levels);
+    }
+
+    if(!success) return nullptr;
+
+    return Containers::pointer<MeshOptimizerImporter>(std::move(meshes), std::move(state->names));
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(MeshOptimizerSceneConverter, Magnum::Trade::MeshOptimizerSceneConverter,
@@ -128,6 +128,21 @@ which accepts also triangle strips and fans or non-contiguous index buffers of
 non-implementation-specific index types, returning always an indexed triangle
 mesh without requiring the input to be mutable.
 
+Non-indexed triangle meshes, such as triangle soups coming from STL files, are
+by default rejected. With the @cb{.ini} generateIndices @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+enabled, @ref convert(const MeshData&) and @ref add(const MeshData&, Containers::StringView)
+first merge vertices that are bitwise identical across all attributes using
+meshoptimizer's [vertex remapping](https://github.com/zeux/meshoptimizer#indexing)
+and produce an indexed mesh with an @ref MeshIndexType::UnsignedInt index
+buffer, which then goes through the optimizations above. Non-interleaved input
+is deduplicated directly from the original attribute streams without being
+interleaved first, unless there's more than 16 attributes or some of them
+can't be described to meshoptimizer, in which case the vertices are
+interleaved and compared as a whole. Attributes with implementation-specific
+vertex formats and vertices larger than 4096 bytes aren't supported in this
+case.
+
 The output has the same index type as input and all attributes are preserved,
 including custom attributes and attributes with implementation-specific vertex
 formats, except for @cb{.ini} optimizeOverdraw @ce, which needs a position
@@ -135,10 +150,77 @@ attribute in a known type. Attributes with zero or negative stride are allowed
 on input but the output will always have an interleaved layout with positive
 strides.
 
+To avoid copying vertex data of large meshes when only the index buffer gets
+changed, enable the @cb{.ini} referenceVertexData @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option".
+If the input is an indexed triangle mesh and neither
+@cb{.ini} optimizeVertexFetch @ce nor mesh simplification is enabled,
+@ref convert(const MeshData&) then returns a mesh with an owned copy of the
+index buffer and @ref MeshData::vertexData() referencing the input, with the
+original attribute layout and empty @ref MeshData::vertexDataFlags(). It's the
+caller's responsibility to keep the input alive for as long as the output is
+used. @ref convertToData(const MeshData&) does the same if the input is
+interleaved, as the vertex data get encoded right away. In all other cases
+the option is ignored and the vertex data are copied as usual. The
+@ref add(const MeshData&, Containers::StringView) function ignores it as
+well, as the input isn't guaranteed to stay around until @ref end().
+
 When @ref SceneConverterFlag::Verbose is enabled, the plugin prints the output
 from meshoptimizer's [efficiency analyzers](https://github.com/zeux/meshoptimizer#efficiency-analyzers)
 before and after the operation.
 
+@subsection Trade-MeshOptimizerSceneConverter-behavior-report Optimization report
+
+For tracking the efficiency in asset pipelines, the
+@cb{.ini} report @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+makes the plugin put the analyzer output into @ref configuration() instead.
+After a successful @ref convertInPlace(MeshData&), @ref convert(const MeshData&)
+or @ref convertToData(const MeshData&) there's a @cb{.ini} [report] @ce group
+with the following contents, with @ref end() there's one such group for each
+mesh added, with an additional @cb{.ini} mesh @ce value containing the mesh
+ID. The groups are removed at the start of each conversion and in
+@ref begin().
+
+-   @cb{.ini} [report/before] @ce and @cb{.ini} [report/after] @ce subgroups
+    with @cb{.ini} vertexCount @ce, @cb{.ini} indexCount @ce, and vertex cache
+    statistics in @cb{.ini} verticesTransformed @ce,
+    @cb{.ini} warpsExecuted @ce, @cb{.ini} acmr @ce and @cb{.ini} atvr @ce.
+    Vertex fetch statistics in @cb{.ini} bytesFetched @ce and
+    @cb{.ini} overfetch @ce are present only if the mesh has no attributes
+    with implementation-specific formats, overdraw statistics in
+    @cb{.ini} pixelsShaded @ce, @cb{.ini} pixelsCovered @ce and
+    @cb{.ini} overdraw @ce only if the mesh has positions. The subgroups
+    aren't present for meshes that were only spatially sorted.
+-   A @cb{.ini} [report/time] @ce subgroup with time in milliseconds spent in
+    each operation that was done. The operations are
+    @cb{.ini} generateIndices @ce, @cb{.ini} spatialSort @ce,
+    @cb{.ini} optimizeVertexCache @ce, @cb{.ini} optimizeOverdraw @ce,
+    @cb{.ini} optimizeVertexFetch @ce, @cb{.ini} simplify @ce (used for
+    @cb{.ini} simplifySloppy @ce as well), @cb{.ini} generateShadowIndices @ce,
+    @cb{.ini} generateLods @ce, @cb{.ini} buildMeshlets @ce and
+    @cb{.ini} encode @ce.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-spatial-sort Spatial sorting
+
+The above operations work only on indexed triangle meshes. Point clouds and
+non-indexed triangle meshes can be instead spatially sorted by enabling the
+@cb{.ini} spatialSort @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option",
+which improves memory locality when rendering them and makes them compress
+better. With @ref MeshPrimitive::Points the vertices get reordered along a
+Morton curve and the index buffer, if present, gets updated to match. With
+non-indexed @ref MeshPrimitive::Triangles whole triangles get reordered
+based on their location. No other operation is done on such meshes. If
+@cb{.ini} generateIndices @ce is enabled as well, non-indexed triangle meshes
+get indexed first, then their triangles get sorted based on their location
+and after that the mesh goes through all other enabled operations like any
+other indexed mesh. Note that @cb{.ini} optimizeVertexCache @ce and
+@cb{.ini} optimizeOverdraw @ce reorder the triangles again, so disable them
+if the spatial order is what you're after. Spatial sorting is done by both
+@ref convert(const MeshData&) and @ref add(const MeshData&, Containers::StringView),
+requires meshoptimizer 0.15 or newer and the mesh to have positions.
+
 @subsection Trade-MeshOptimizerSceneConverter-behavior-simplification Mesh simplification
 
 By default the plugin performs only the above non-destructive operations.
@@ -155,6 +237,146 @@ to new locations. It only requires the mesh to have a position attribute, mesh
 connectivity and face seams are figured out from the index buffer. As with all
 other operations, all original attributes are preserved.
 
+By default only positions contribute to the simplification error. Setting the
+@cb{.ini} simplifyNormalWeight @ce, @cb{.ini} simplifyTextureCoordinatesWeight @ce
+and @cb{.ini} simplifyColorWeight @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration options"
+to a non-zero value makes the simplifier take differences in the
+@ref MeshAttribute::Normal, @ref MeshAttribute::TextureCoordinates and
+@ref MeshAttribute::Color attributes into account as well, which keeps
+shading and UV seams intact at the cost of a less aggressive reduction. The
+weights apply to both @cb{.ini} simplify @ce and the LOD chain described below,
+the error reported for each LOD then includes the weighted attribute error.
+This feature requires meshoptimizer 0.20 or newer, with older versions only
+positions are used and a warning is printed.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-multiple Converting multiple meshes
+
+Apart from @ref convert(const MeshData&), the plugin supports converting
+multiple meshes using @ref begin(), @ref add(const MeshData&, Containers::StringView)
+and @ref end(). Each added mesh goes through the same operations as with
+@ref convert(const MeshData&) and the importer returned from @ref end() then
+provides all converted meshes together with their names and additional mesh
+levels described below. Meshes returned from the importer reference its
+internal data, so the importer has to be kept alive for as long as the meshes
+are used. The importer also has to be destroyed before the plugin is unloaded.
+
+The configuration is read just once in @ref begin() and applies to all meshes
+added after. With the @cb{.ini} threads @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+set to a value other than @cpp 1 @ce, @ref add(const MeshData&, Containers::StringView)
+only makes an interleaved copy of the mesh and the rest of the processing is
+done on a pool of worker threads, each reusing its own temporary memory across
+meshes. Meshes in the importer returned from @ref end() are then in the order
+they were added regardless of the thread count. As the processing happens
+asynchronously, a failure of any mesh is reported only from @ref end(), which
+then returns @cpp nullptr @ce. Messages printed for each mesh are printed from
+@ref end() as well, in the order the meshes were added. Calling
+@ref abort() drops all meshes that weren't processed yet and waits only for
+the ones that are being processed at that point. Multithreaded
+processing requires Corrade built with @ref CORRADE_BUILD_MULTITHREADED, the
+plugin falls back to processing on a single thread otherwise. On
+@ref CORRADE_TARGET_EMSCRIPTEN "Emscripten" the meshes are always processed on
+a single thread unless the plugin is built with pthreads enabled.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-shadow Shadow index buffer generation
+
+Depth prepass and shadow rendering use just the positions, so vertices that
+were split because of differing normals or texture coordinates only reduce
+vertex cache reuse there. If the @cb{.ini} generateShadowIndices @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option" is
+enabled, each mesh added with @ref add(const MeshData&, Containers::StringView)
+gets an additional index buffer with such vertices merged, generated using
+meshoptimizer's [shadow indexing](https://github.com/zeux/meshoptimizer#shadow-indexing).
+It's available as the second mesh level, has the same index type as the first
+level and shares its vertex data, so only the index buffer has to be uploaded
+in addition. Vertices are merged if their positions are bitwise identical,
+other attributes of the level are thus valid only for the first of the merged
+vertices. Requires the mesh to have positions.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-lods LOD chain generation
+
+Setting the @cb{.ini} lodCount @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option" to
+a non-zero value makes each mesh added with
+@ref add(const MeshData&, Containers::StringView) produce a chain of up to
+@cb{.ini} lodCount @ce progressively simplified LODs, available as mesh levels
+following the first one and the shadow index level, if enabled. Each LOD is simplified from the previous one,
+targeting @cb{.ini} lodTargetIndexCountThreshold @ce of its index count and
+@cb{.ini} lodTargetError @ce. The LODs differ only in the index buffer, which
+has the same type as the first level, and all share the vertex data of the
+first level, thus it's possible to upload the vertex data just once and switch
+between the index buffers. The chain ends early if the simplification can't
+reduce the index count any further.
+
+As the error of each LOD is needed for LOD selection at runtime, for every
+mesh with LODs generated @ref end() adds a @cb{.ini} [lod] @ce group to
+@ref configuration(), with a @cb{.ini} mesh @ce value containing the mesh ID
+and one @cb{.ini} error @ce value for each LOD containing the simplification error
+accumulated over the chain, relative to the mesh extents. The groups are
+removed on @ref begin(). The error is reported only with meshoptimizer 0.16
+and newer, it's zero on older versions.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-meshlets Meshlet generation
+
+If the @cb{.ini} buildMeshlets @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option" is
+enabled, each mesh added with @ref add(const MeshData&, Containers::StringView)
+gets [split into meshlets](https://github.com/zeux/meshoptimizer#mesh-shading)
+for use in mesh shading and cluster culling pipelines. The meshlets are
+available in the last mesh level, following the LODs, if any, as a
+@ref MeshPrimitive::Meshlets mesh, where each item is a meshlet with the
+following custom attributes, their names available through @ref AbstractImporter::meshAttributeName() on the importer
+returned from @ref end():
+
+-   `meshletVertices`, a @ref VertexFormat::UnsignedInt array of
+    @cb{.ini} meshletMaxVertices @ce items, indexing the vertices of the
+    first mesh level
+-   `meshletTriangles`, a @ref VertexFormat::UnsignedByte array of three times
+    @cb{.ini} meshletMaxTriangles @ce items, each triplet being a triangle
+    indexing `meshletVertices`
+-   `meshletVertexCount` and `meshletTriangleCount`, a
+    @ref VertexFormat::UnsignedInt with the count of vertices and triangles
+    actually used in given meshlet
+-   `meshletBoundingSphere`, a @ref VertexFormat::Vector4 with the bounding
+    sphere center in the first three components and radius in the last
+-   `meshletConeApex`, `meshletConeAxis` and `meshletConeCutoff`, a
+    @ref VertexFormat::Vector3, @ref VertexFormat::Vector3 and
+    @ref VertexFormat::Float describing the normal cone for backface culling
+
+Meshlet generation requires meshoptimizer 0.17 or newer and the mesh to have
+positions.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-encoding Vertex and index buffer compression
+
+The plugin can compress the mesh using meshoptimizer's
+[vertex and index buffer codecs](https://github.com/zeux/meshoptimizer#vertexindex-buffer-compression),
+which are designed to be decoded at several gigabytes per second. Using
+@ref convertToData(const MeshData&) or @ref convertToFile(const MeshData&, Containers::StringView),
+the mesh is first processed the same way as with @ref convert(const MeshData&)
+and the result is then encoded into a binary blob. Enabling the
+@cb{.ini} encode @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+makes @ref convert(const MeshData&) return the same blob as vertex data of a
+@ref MeshData with no attributes, the original vertex count and an
+implementation-specific primitive with value of @cpp 0x4d4f5054 @ce, which is
+the @cpp "MOPT" @ce signature the blob starts with.
+
+Passing a @ref MeshData with such a primitive to @ref convert(const MeshData&)
+decodes it back, no other processing is done in that case. This is meant to be
+used for example by importers reading the blob from a cache --- they can wrap
+the file contents in a non-owning @ref MeshData with the above primitive and
+no attributes without copying. The vertex count of the wrapper isn't used, as
+it's stored in the blob itself.
+
+The blob contains the primitive, index type and count, vertex count, stride and
+attribute layout, stored as little-endian. The vertex data themselves are in
+native endianness. Decoding validates all header fields, the data size, the
+attribute names, formats and offsets and the index range, and prints an error
+instead of asserting if any of them is invalid. Encoding requires the vertex stride to be a multiple of four bytes and
+at most 256 bytes and as the index codec works only on triangles, the output
+is always an indexed triangle mesh with the original index type.
+
 @section Trade-MeshOptimizerSceneConverter-configuration Plugin-specific configuration
 
 It's possible to tune various output options through @ref configuration(). See
@@ -177,6 +399,15 @@ class MAGNUM_MESHOPTIMIZERSCENECONVERTER_EXPORT MeshOptimizerSceneConverter: pub
 
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doConvertInPlace(MeshData& mesh) override;
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Optional<MeshData> doConvert(const MeshData& mesh) override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const MeshData& mesh) override;
+
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doBegin() override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doAdd(UnsignedInt id, const MeshData& mesh, Containers::StringView name) override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL void doAbort() override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Pointer<AbstractImporter> doEnd() override;
+
+        struct State;
+        Containers::Pointer<State> _state;
 };
 
 }}
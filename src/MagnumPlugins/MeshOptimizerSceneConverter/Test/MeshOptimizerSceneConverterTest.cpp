@@ -25,18 +25,26 @@
 
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once Debug is stream-free */
-#include <Magnum/Math/Vector3.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/FunctionsBatch.h>
+#include <Magnum/Math/Vector4.h>
 #include <Magnum/MeshTools/CompressIndices.h>
+#include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/MeshTools/Reference.h>
 #include <Magnum/Primitives/Circle.h>
 #include <Magnum/Primitives/Icosphere.h>
 #include <Magnum/Primitives/Square.h>
 #include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/MeshData.h>
 
@@ -77,6 +85,20 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
     void copyTriangleFanIndexed();
     template<class T> void copyNonContiguousIndexBuffer();
     void copyNegativeAttributeStride();
+    void copyReferenceVertexData();
+    void copyReferenceVertexDataVertexFetch();
+
+    void generateIndices();
+    void generateIndicesNonInterleaved();
+    void generateIndicesNegativeAttributeStride();
+    void generateIndicesManyAttributes();
+    void generateIndicesVertexTooLarge();
+
+    void spatialSortPoints();
+    void spatialSortPointsIndexed();
+    void spatialSortTriangleSoup();
+    void spatialSortTriangleSoupGenerateIndices();
+    void spatialSortNoPositions();
 
     void simplifyInPlace();
     void simplifyNoPositions();
@@ -84,6 +106,32 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
     template<class T> void simplifySloppy();
 
     void simplifyVerbose();
+    void simplifyAttributeWeights();
+
+    void report();
+    void reportMultiple();
+
+    void addMultiple();
+    void addMultipleThreads();
+    void addMultipleThreadsFailed();
+    void addMultipleThreadsAbort();
+
+    void levelsNotMultiple();
+
+    void generateShadowIndices();
+    void generateShadowIndicesNoPositions();
+
+    void generateLods();
+    void generateLodsNoPositions();
+
+    void buildMeshlets();
+    void buildMeshletsInvalidLimits();
+
+    void encodeDecode();
+    void encodeToData();
+    void encodeInvalidStride();
+    void encodeMultiple();
+    void decodeInvalid();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractSceneConverter> _manager{"nonexistent"};
@@ -97,6 +145,25 @@ const struct {
     {"sloppy", "simplifySloppy"}
 };
 
+const struct {
+    const char* name;
+    Int threads;
+} AddMultipleThreadsData[] {
+    {"2 threads", 2},
+    {"5 threads", 5},
+    {"hardware concurrency", 0}
+};
+
+const struct {
+    const char* name;
+    const char* option;
+    const char* value;
+} LevelsNotMultipleData[] {
+    {"LODs", "lodCount", "3"},
+    {"meshlets", "buildMeshlets", "true"},
+    {"shadow indices", "generateShadowIndices", "true"}
+};
+
 MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
     addTests({
         &MeshOptimizerSceneConverterTest::notTriangles,
@@ -140,7 +207,21 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::copyNonContiguousIndexBuffer<UnsignedByte>,
         &MeshOptimizerSceneConverterTest::copyNonContiguousIndexBuffer<UnsignedShort>,
         &MeshOptimizerSceneConverterTest::copyNonContiguousIndexBuffer<UnsignedInt>,
-        &MeshOptimizerSceneConverterTest::copyNegativeAttributeStride});
+        &MeshOptimizerSceneConverterTest::copyNegativeAttributeStride,
+        &MeshOptimizerSceneConverterTest::copyReferenceVertexData,
+        &MeshOptimizerSceneConverterTest::copyReferenceVertexDataVertexFetch,
+
+        &MeshOptimizerSceneConverterTest::generateIndices,
+        &MeshOptimizerSceneConverterTest::generateIndicesNonInterleaved,
+        &MeshOptimizerSceneConverterTest::generateIndicesNegativeAttributeStride,
+        &MeshOptimizerSceneConverterTest::generateIndicesManyAttributes,
+        &MeshOptimizerSceneConverterTest::generateIndicesVertexTooLarge,
+
+        &MeshOptimizerSceneConverterTest::spatialSortPoints,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsIndexed,
+        &MeshOptimizerSceneConverterTest::spatialSortTriangleSoup,
+        &MeshOptimizerSceneConverterTest::spatialSortTriangleSoupGenerateIndices,
+        &MeshOptimizerSceneConverterTest::spatialSortNoPositions});
 
     addInstancedTests({
         &MeshOptimizerSceneConverterTest::simplifyInPlace,
@@ -154,7 +235,37 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedByte>,
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedShort>,
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedInt>,
-        &MeshOptimizerSceneConverterTest::simplifyVerbose});
+        &MeshOptimizerSceneConverterTest::simplifyVerbose,
+        &MeshOptimizerSceneConverterTest::simplifyAttributeWeights,
+
+        &MeshOptimizerSceneConverterTest::report,
+        &MeshOptimizerSceneConverterTest::reportMultiple,
+
+        &MeshOptimizerSceneConverterTest::addMultiple});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::addMultipleThreads},
+        Containers::arraySize(AddMultipleThreadsData));
+
+    addTests({&MeshOptimizerSceneConverterTest::addMultipleThreadsFailed,
+              &MeshOptimizerSceneConverterTest::addMultipleThreadsAbort});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::levelsNotMultiple},
+        Containers::arraySize(LevelsNotMultipleData));
+
+    addTests({&MeshOptimizerSceneConverterTest::generateShadowIndices,
+              &MeshOptimizerSceneConverterTest::generateShadowIndicesNoPositions,
+
+              &MeshOptimizerSceneConverterTest::generateLods,
+              &MeshOptimizerSceneConverterTest::generateLodsNoPositions,
+
+              &MeshOptimizerSceneConverterTest::buildMeshlets,
+              &MeshOptimizerSceneConverterTest::buildMeshletsInvalidLimits,
+
+              &MeshOptimizerSceneConverterTest::encodeDecode,
+              &MeshOptimizerSceneConverterTest::encodeToData,
+              &MeshOptimizerSceneConverterTest::encodeInvalidStride,
+              &MeshOptimizerSceneConverterTest::encodeMultiple,
+              &MeshOptimizerSceneConverterTest::decodeInvalid});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -912,6 +1023,451 @@ void MeshOptimizerSceneConverterTest::copyNegativeAttributeStride() {
         }), TestSuite::Compare::Container);
 }
 
+void MeshOptimizerSceneConverterTest::copyReferenceVertexData() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("referenceVertexData", true);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Same as in copyNegativeAttributeStride(), with the negative stride
+       verifying that the positions get unpacked for the overdraw optimizer */
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 3};
+    const Vector3 positionsReversed[]{
+        {-1.0f,  1.0f, 0.0f},
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f,  1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f}
+    };
+    MeshData original{MeshPrimitive::Triangles, {}, indices,
+        MeshIndexData{indices},
+        {}, positionsReversed, {
+            MeshAttributeData{MeshAttribute::Position, Containers::stridedArrayView(positionsReversed).flipped<0>()},
+        }
+    };
+    Containers::Optional<MeshData> optimized = converter->convert(original);
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(optimized->indexCount(), 6);
+    CORRADE_COMPARE(optimized->vertexCount(), original.vertexCount());
+    CORRADE_COMPARE(optimized->attributeCount(), original.attributeCount());
+
+    /* The index buffer is a copy, the vertex data are referenced including
+       the original layout */
+    CORRADE_COMPARE(optimized->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(optimized->vertexDataFlags(), DataFlags{});
+    CORRADE_VERIFY(optimized->indexData().data() != static_cast<const void*>(indices));
+    CORRADE_COMPARE(optimized->vertexData().data(), static_cast<const void*>(positionsReversed));
+    CORRADE_COMPARE(optimized->attributeStride(MeshAttribute::Position), -Short(sizeof(Vector3)));
+
+    /* The input index buffer stays untouched */
+    CORRADE_COMPARE_AS(Containers::arrayView(indices), Containers::arrayView<UnsignedShort>({
+        0, 1, 2, 2, 1, 3
+    }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::copyReferenceVertexDataVertexFetch() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("referenceVertexData", true);
+
+    /* With vertex fetch optimization enabled the vertex data get copied as
+       usual */
+    const UnsignedShort indices[]{0, 1, 2, 2, 1, 3};
+    const Vector3 positions[]{
+        {-1.0f,  1.0f, 0.0f},
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f,  1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f}
+    };
+    MeshData original{MeshPrimitive::Triangles, {}, indices,
+        MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)},
+        }
+    };
+    Containers::Optional<MeshData> optimized = converter->convert(original);
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->indexCount(), 6);
+    CORRADE_COMPARE(optimized->vertexCount(), original.vertexCount());
+    CORRADE_COMPARE(optimized->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(optimized->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_VERIFY(optimized->vertexData().data() != static_cast<const void*>(positions));
+}
+
+void MeshOptimizerSceneConverterTest::generateIndices() {
+    /* Only the deduplication, so the vertex and index order stays
+       predictable */
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateIndices", true);
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    MeshData soup = MeshTools::duplicate(Primitives::icosphereSolid(1));
+    CORRADE_VERIFY(!soup.isIndexed());
+    CORRADE_COMPARE(soup.vertexCount(), 240);
+
+    Containers::Optional<MeshData> indexed = converter->convert(soup);
+    CORRADE_VERIFY(indexed);
+    CORRADE_COMPARE(indexed->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(indexed->isIndexed());
+    CORRADE_COMPARE(indexed->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(indexed->indexCount(), 240);
+    CORRADE_COMPARE(indexed->vertexCount(), 42);
+    CORRADE_COMPARE(indexed->attributeCount(), soup.attributeCount());
+    CORRADE_COMPARE(indexed->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(indexed->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    /* Expanding the result back should give the original */
+    MeshData expanded = MeshTools::duplicate(*indexed);
+    CORRADE_COMPARE_AS(expanded.attribute<Vector3>(MeshAttribute::Position),
+        soup.attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(expanded.attribute<Vector3>(MeshAttribute::Normal),
+        soup.attribute<Vector3>(MeshAttribute::Normal),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::generateIndicesNonInterleaved() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateIndices", true);
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Two triangles of a quad and one overlapping the second, with positions
+       and colors in separate arrays. The first vertex of the third triangle
+       has the same position as the first vertex but a different color, so it
+       shouldn't get merged. */
+    struct Vertices {
+        Vector2 positions[9];
+        Color3 colors[9];
+    } vertices{{
+        {-1.0f, -1.0f}, { 1.0f, -1.0f}, {-1.0f,  1.0f},
+        {-1.0f,  1.0f}, { 1.0f, -1.0f}, { 1.0f,  1.0f},
+        {-1.0f, -1.0f}, { 1.0f, -1.0f}, { 1.0f,  1.0f}
+    }, {
+        {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f},
+        {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}
+    }};
+    MeshData soup{MeshPrimitive::Triangles,
+        {}, Containers::ArrayView<const void>{&vertices, sizeof(vertices)}, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(vertices.positions)},
+        MeshAttributeData{MeshAttribute::Color, Containers::arrayView(vertices.colors)}
+    }};
+    CORRADE_VERIFY(!MeshTools::isInterleaved(soup));
+
+    Containers::Optional<MeshData> indexed = converter->convert(soup);
+    CORRADE_VERIFY(indexed);
+    CORRADE_VERIFY(MeshTools::isInterleaved(*indexed));
+    CORRADE_COMPARE_AS(indexed->indices<UnsignedInt>(), Containers::arrayView<UnsignedInt>({
+        0, 1, 2, 2, 1, 3, 4, 1, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(indexed->attribute<Vector2>(MeshAttribute::Position),
+        Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f}, { 1.0f, -1.0f}, {-1.0f,  1.0f}, { 1.0f,  1.0f},
+            {-1.0f, -1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(indexed->attribute<Color3>(MeshAttribute::Color),
+        Containers::arrayView<Color3>({
+            {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+            {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::generateIndicesNegativeAttributeStride() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateIndices", true);
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Can't be described as a meshoptimizer stream, so it's interleaved
+       first */
+    const Vector2 positionsReversed[]{
+        { 1.0f,  1.0f},
+        { 1.0f, -1.0f},
+        {-1.0f,  1.0f},
+        {-1.0f,  1.0f},
+        { 1.0f, -1.0f},
+        {-1.0f, -1.0f}
+    };
+    MeshData soup{MeshPrimitive::Triangles, {}, positionsReversed, {
+        MeshAttributeData{MeshAttribute::Position, Containers::stridedArrayView(positionsReversed).flipped<0>()}
+    }};
+
+    Containers::Optional<MeshData> indexed = converter->convert(soup);
+    CORRADE_VERIFY(indexed);
+    CORRADE_COMPARE_AS(indexed->indices<UnsignedInt>(), Containers::arrayView<UnsignedInt>({
+        0, 1, 2, 2, 1, 3
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(indexed->attributeStride(MeshAttribute::Position), sizeof(Vector2));
+    CORRADE_COMPARE_AS(indexed->attribute<Vector2>(MeshAttribute::Position),
+        Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f},
+            { 1.0f, -1.0f},
+            {-1.0f,  1.0f},
+            { 1.0f,  1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::generateIndicesManyAttributes() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateIndices", true);
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Two triangles of a quad with positions and 16 custom attributes in
+       separate arrays, which is more than meshoptimizer can take as separate
+       streams, so it's interleaved first. The fifth vertex has the same
+       position as the second but differs in the last attribute, so it
+       shouldn't get merged. */
+    struct Vertices {
+        Vector2 positions[6];
+        Float custom[16][6];
+    } vertices{{
+        {-1.0f, -1.0f}, { 1.0f, -1.0f}, {-1.0f,  1.0f},
+        {-1.0f,  1.0f}, { 1.0f, -1.0f}, { 1.0f,  1.0f}
+    }, {}};
+    Containers::Array<MeshAttributeData> attributes{17};
+    attributes[0] = MeshAttributeData{MeshAttribute::Position, Containers::arrayView(vertices.positions)};
+    for(UnsignedInt i = 0; i != 16; ++i) {
+        for(std::size_t j = 0; j != 6; ++j)
+            vertices.custom[i][j] = vertices.positions[j].x()*(i + 1);
+        attributes[i + 1] = MeshAttributeData{meshAttributeCustom(i), Containers::arrayView(vertices.custom[i])};
+    }
+    vertices.custom[15][4] = 100.0f;
+    MeshData soup{MeshPrimitive::Triangles,
+        {}, Containers::ArrayView<const void>{&vertices, sizeof(vertices)},
+        std::move(attributes)};
+    CORRADE_VERIFY(!MeshTools::isInterleaved(soup));
+
+    Containers::Optional<MeshData> indexed = converter->convert(soup);
+    CORRADE_VERIFY(indexed);
+    CORRADE_VERIFY(MeshTools::isInterleaved(*indexed));
+    CORRADE_COMPARE(indexed->attributeCount(), 17);
+    CORRADE_COMPARE_AS(indexed->indices<UnsignedInt>(), Containers::arrayView<UnsignedInt>({
+        0, 1, 2, 2, 3, 4
+    }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(indexed->attribute<Vector2>(MeshAttribute::Position),
+        Containers::arrayView<Vector2>({
+            {-1.0f, -1.0f}, { 1.0f, -1.0f}, {-1.0f,  1.0f}, { 1.0f, -1.0f},
+            { 1.0f,  1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(indexed->attribute<Float>(meshAttributeCustom(0)),
+        Containers::arrayView<Float>({
+            -1.0f, 1.0f, -1.0f, 1.0f, 1.0f
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(indexed->attribute<Float>(meshAttributeCustom(15)),
+        Containers::arrayView<Float>({
+            -16.0f, 16.0f, -16.0f, 100.0f, 16.0f
+        }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::generateIndicesVertexTooLarge() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateIndices", true);
+
+    /* A single attribute that's larger than what meshoptimizer can take as
+       a stream, and the interleaved vertex is then too large as well */
+    Containers::Array<char> vertexData{ValueInit, 3*4112};
+    MeshData soup{MeshPrimitive::Triangles, std::move(vertexData), {
+        MeshAttributeData{meshAttributeCustom(0), VertexFormat::Vector4, 0, 3, 4112, 257}
+    }};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(soup));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): can't generate indices for a mesh with a vertex stride of 4112 bytes, expected at most 4096\n");
+}
+
+/* Points on a line, so the Morton order is just the order along X */
+struct ShuffledPoint {
+    Vector3 position;
+    Color3 color;
+};
+
+const ShuffledPoint ShuffledPoints[]{
+    {{3.0f, 0.0f, 0.0f}, {0.3f, 0.0f, 0.0f}},
+    {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}},
+    {{2.0f, 0.0f, 0.0f}, {0.2f, 0.0f, 0.0f}},
+    {{1.0f, 0.0f, 0.0f}, {0.1f, 0.0f, 0.0f}}
+};
+
+void MeshOptimizerSceneConverterTest::spatialSortPoints() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    const auto points = Containers::stridedArrayView(ShuffledPoints);
+    MeshData mesh{MeshPrimitive::Points, {}, ShuffledPoints, {
+        MeshAttributeData{MeshAttribute::Position, points.slice(&ShuffledPoint::position)},
+        MeshAttributeData{MeshAttribute::Color, points.slice(&ShuffledPoint::color)}
+    }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> sorted;
+    {
+        Error redirectError{&out};
+        sorted = converter->convert(mesh);
+    }
+    if(out.str().find("requires meshoptimizer 0.15") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.15, can't test");
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Points);
+    CORRADE_VERIFY(!sorted->isIndexed());
+    CORRADE_COMPARE_AS(sorted->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {2.0f, 0.0f, 0.0f},
+            {3.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    /* The other attributes are reordered together with positions */
+    CORRADE_COMPARE_AS(sorted->attribute<Color3>(MeshAttribute::Color),
+        Containers::arrayView<Color3>({
+            {0.0f, 0.0f, 0.0f},
+            {0.1f, 0.0f, 0.0f},
+            {0.2f, 0.0f, 0.0f},
+            {0.3f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPointsIndexed() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    const UnsignedShort indices[]{0, 1, 2, 3, 3, 0};
+    const auto points = Containers::stridedArrayView(ShuffledPoints);
+    MeshData mesh{MeshPrimitive::Points,
+        {}, indices, MeshIndexData{indices},
+        {}, ShuffledPoints, {
+            MeshAttributeData{MeshAttribute::Position, points.slice(&ShuffledPoint::position)}
+        }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> sorted;
+    {
+        Error redirectError{&out};
+        sorted = converter->convert(mesh);
+    }
+    if(out.str().find("requires meshoptimizer 0.15") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.15, can't test");
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->indexType(), MeshIndexType::UnsignedShort);
+
+    /* The vertices are sorted and the indices point to the same positions as
+       before */
+    CORRADE_COMPARE_AS(sorted->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {2.0f, 0.0f, 0.0f},
+            {3.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(sorted->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({3, 0, 2, 1, 1, 3}),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortTriangleSoup() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    /* Three triangles along X, shuffled */
+    const Vector3 positions[]{
+        {2.0f, 0.0f, 0.0f}, {2.5f, 0.0f, 0.0f}, {2.0f, 0.5f, 0.0f},
+        {0.0f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.0f},
+        {1.0f, 0.0f, 0.0f}, {1.5f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f}
+    };
+    MeshData soup{MeshPrimitive::Triangles, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> sorted;
+    {
+        Error redirectError{&out};
+        sorted = converter->convert(soup);
+    }
+    if(out.str().find("requires meshoptimizer 0.15") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.15, can't test");
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(!sorted->isIndexed());
+
+    /* The triangles are reordered, their vertices not */
+    CORRADE_COMPARE_AS(sorted->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.0f},
+            {1.0f, 0.0f, 0.0f}, {1.5f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f},
+            {2.0f, 0.0f, 0.0f}, {2.5f, 0.0f, 0.0f}, {2.0f, 0.5f, 0.0f}
+        }), TestSuite::Compare::Container);
+
+    /* Encoding works only with indexed meshes */
+    {
+        std::ostringstream encodeOut;
+        Error redirectError{&encodeOut};
+        CORRADE_VERIFY(!converter->convertToData(soup));
+        CORRADE_COMPARE(encodeOut.str(), "Trade::MeshOptimizerSceneConverter::convertToData(): expected an indexed triangle mesh for encoding\n");
+    }
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortTriangleSoupGenerateIndices() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+    converter->configuration().setValue("generateIndices", true);
+    /* These would reorder the triangles and vertices again */
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Same as in spatialSortTriangleSoup() */
+    const Vector3 positions[]{
+        {2.0f, 0.0f, 0.0f}, {2.5f, 0.0f, 0.0f}, {2.0f, 0.5f, 0.0f},
+        {0.0f, 0.0f, 0.0f}, {0.5f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.0f},
+        {1.0f, 0.0f, 0.0f}, {1.5f, 0.0f, 0.0f}, {1.0f, 0.5f, 0.0f}
+    };
+    MeshData soup{MeshPrimitive::Triangles, {}, positions, {
+        MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+    }};
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> sorted;
+    {
+        Error redirectError{&out};
+        sorted = converter->convert(soup);
+    }
+    if(out.str().find("requires meshoptimizer 0.15") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.15, can't test");
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(sorted->isIndexed());
+
+    /* The mesh gets indexed, with all vertices unique, and then the
+       triangles are reordered in the index buffer */
+    CORRADE_COMPARE_AS(sorted->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(sorted->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({3, 4, 5, 6, 7, 8, 0, 1, 2}),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    MeshData mesh{MeshPrimitive::Points, 3};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    if(out.str().find("requires meshoptimizer 0.15") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.15, can't test");
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::convert(): spatialSort requires the mesh to have positions\n");
+}
+
 void MeshOptimizerSceneConverterTest::simplifyInPlace() {
     auto&& data = SimplifyErrorData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1132,6 +1688,741 @@ void MeshOptimizerSceneConverterTest::simplifyVerbose() {
     CORRADE_COMPARE(out.str(), expected);
 }
 
+void MeshOptimizerSceneConverterTest::simplifyAttributeWeights() {
+    /* A flat 4x4 quad grid with a checkerboard vertex color pattern. Based on
+       positions alone it collapses to the two outer triangles, with color
+       taken into account it shouldn't */
+    struct Vertex {
+        Vector3 position;
+        Color4 color;
+    } vertices[5*5];
+    UnsignedInt indices[4*4*6];
+    for(UnsignedInt y = 0; y != 5; ++y) for(UnsignedInt x = 0; x != 5; ++x)
+        vertices[y*5 + x] = {{Float(x), Float(y), 0.0f}, Color4{Float((x + y) % 2)}};
+    for(UnsignedInt y = 0; y != 4; ++y) for(UnsignedInt x = 0; x != 4; ++x) {
+        const UnsignedInt a = y*5 + x;
+        const UnsignedInt quad[]{a, a + 1, a + 6, a, a + 6, a + 5};
+        Utility::copy(Containers::arrayView(quad), Containers::arrayView(indices).slice((y*4 + x)*6, (y*4 + x + 1)*6));
+    }
+
+    const Containers::StridedArrayView1D<const Vertex> vertexView = vertices;
+    MeshData grid{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, vertices, {
+            MeshAttributeData{MeshAttribute::Position, vertexView.slice(&Vertex::position)},
+            MeshAttributeData{MeshAttribute::Color, vertexView.slice(&Vertex::color)}
+        }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("simplify", true);
+    converter->configuration().setValue("simplifyTargetIndexCountThreshold", 0.0f);
+
+    Containers::Optional<MeshData> positionsOnly = converter->convert(grid);
+    CORRADE_VERIFY(positionsOnly);
+    CORRADE_COMPARE_AS(positionsOnly->indexCount(), 96,
+        TestSuite::Compare::Less);
+
+    converter->configuration().setValue("simplifyColorWeight", 1.0f);
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> weighted;
+    {
+        Warning redirectWarning{&out};
+        weighted = converter->convert(grid);
+    }
+    CORRADE_VERIFY(weighted);
+    if(out.str().find("requires meshoptimizer 0.20") != std::string::npos) {
+        CORRADE_COMPARE(weighted->indexCount(), positionsOnly->indexCount());
+        CORRADE_SKIP("meshoptimizer older than 0.20, can't test");
+    }
+    CORRADE_COMPARE(out.str(), "");
+    CORRADE_COMPARE_AS(weighted->indexCount(), positionsOnly->indexCount(),
+        TestSuite::Compare::Greater);
+
+    /* All attributes are still preserved */
+    CORRADE_COMPARE(weighted->attributeCount(), 2);
+    CORRADE_VERIFY(weighted->hasAttribute(MeshAttribute::Color));
+}
+
+void MeshOptimizerSceneConverterTest::report() {
+    /* Same as simplifyVerbose(), except that the stats go to the
+       configuration */
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("report", true);
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("simplify", true);
+    converter->configuration().setValue("simplifyTargetIndexCountThreshold", 0.5f);
+    converter->configuration().setValue("simplifyTargetError", 0.25f);
+
+    /* A leftover group from some previous conversion, should get removed */
+    converter->configuration().addGroup("report")->setValue("mesh", 7);
+
+    std::ostringstream out;
+    Containers::Optional<MeshData> simplified;
+    {
+        Debug redirectDebug{&out};
+        simplified = converter->convert(Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates));
+    }
+    CORRADE_VERIFY(simplified);
+    /* Nothing printed as verbose output isn't enabled */
+    CORRADE_COMPARE(out.str(), "");
+
+    CORRADE_COMPARE(converter->configuration().groupCount("report"), 1);
+    Utility::ConfigurationGroup* report = converter->configuration().group("report");
+    CORRADE_VERIFY(report);
+    CORRADE_VERIFY(!report->hasValue("mesh"));
+
+    Utility::ConfigurationGroup* before = report->group("before");
+    Utility::ConfigurationGroup* after = report->group("after");
+    CORRADE_VERIFY(before);
+    CORRADE_VERIFY(after);
+    CORRADE_COMPARE(before->value<UnsignedInt>("vertexCount"), 23);
+    CORRADE_COMPARE(after->value<UnsignedInt>("vertexCount"), 13);
+    CORRADE_COMPARE(before->value<UnsignedInt>("indexCount"), 108);
+    CORRADE_COMPARE(after->value<UnsignedInt>("indexCount"), 54);
+    CORRADE_COMPARE(before->value<UnsignedInt>("verticesTransformed"), 23);
+    CORRADE_COMPARE(after->value<UnsignedInt>("verticesTransformed"), 13);
+    CORRADE_COMPARE(before->value<Float>("acmr"), 0.638889f);
+    CORRADE_COMPARE(after->value<Float>("acmr"), 0.722222f);
+    CORRADE_COMPARE(before->value<UnsignedInt>("bytesFetched"), 768);
+    CORRADE_COMPARE(after->value<UnsignedInt>("bytesFetched"), 448);
+    CORRADE_COMPARE(before->value<UnsignedInt>("pixelsShaded"), 127149);
+    CORRADE_COMPARE(after->value<UnsignedInt>("pixelsShaded"), 131437);
+    CORRADE_COMPARE(after->value<Float>("overdraw"), 1.0f);
+
+    /* Only the operations that were done are timed */
+    Utility::ConfigurationGroup* time = report->group("time");
+    CORRADE_VERIFY(time);
+    CORRADE_VERIFY(time->hasValue("simplify"));
+    CORRADE_COMPARE_AS(time->value<Float>("simplify"), 0.0f,
+        TestSuite::Compare::GreaterOrEqual);
+    CORRADE_VERIFY(!time->hasValue("optimizeVertexCache"));
+    CORRADE_COMPARE(time->valueCount(), 1);
+}
+
+void MeshOptimizerSceneConverterTest::reportMultiple() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("report", true);
+
+    /* A leftover group from some previous conversion, should get removed by
+       begin() */
+    converter->configuration().addGroup("report")->setValue("mesh", 7);
+
+    /* The first mesh has no positions, so there are no overdraw stats */
+    const UnsignedShort indices[]{0, 1, 2};
+    const Vector2 textureCoordinates[]{{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}};
+    MeshData noPositions{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, textureCoordinates, {
+            MeshAttributeData{MeshAttribute::TextureCoordinates, Containers::arrayView(textureCoordinates)}
+        }};
+    converter->configuration().setValue("optimizeOverdraw", false);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(noPositions));
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+    CORRADE_VERIFY(converter->end());
+
+    CORRADE_COMPARE(converter->configuration().groupCount("report"), 2);
+    std::vector<Utility::ConfigurationGroup*> reports = converter->configuration().groups("report");
+    CORRADE_COMPARE(reports[0]->value<UnsignedInt>("mesh"), 0);
+    CORRADE_COMPARE(reports[1]->value<UnsignedInt>("mesh"), 1);
+
+    CORRADE_VERIFY(reports[0]->group("after"));
+    CORRADE_VERIFY(reports[0]->group("after")->hasValue("acmr"));
+    CORRADE_VERIFY(!reports[0]->group("after")->hasValue("overdraw"));
+    CORRADE_VERIFY(reports[1]->group("after"));
+    CORRADE_COMPARE(reports[1]->group("after")->value<UnsignedInt>("vertexCount"), 42);
+    CORRADE_VERIFY(reports[1]->group("after")->hasValue("overdraw"));
+    CORRADE_VERIFY(reports[1]->group("time")->hasValue("optimizeVertexCache"));
+    CORRADE_VERIFY(reports[1]->group("time")->hasValue("optimizeVertexFetch"));
+}
+
+void MeshOptimizerSceneConverterTest::addMultiple() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1), "sphere"));
+    /* A non-indexed triangle strip, gets converted to an indexed mesh */
+    CORRADE_VERIFY(converter->add(Primitives::squareSolid(), "square"));
+
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(importer->meshName(0), "sphere");
+    CORRADE_COMPARE(importer->meshForName("square"), 1);
+    CORRADE_COMPARE(importer->meshForName("nonexistent"), -1);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(1), 1);
+
+    Containers::Optional<MeshData> sphere = importer->mesh(0);
+    CORRADE_VERIFY(sphere);
+    CORRADE_COMPARE(sphere->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(sphere->isIndexed());
+    CORRADE_COMPARE(sphere->indexCount(), 240);
+    CORRADE_COMPARE(sphere->vertexCount(), 42);
+
+    Containers::Optional<MeshData> square = importer->mesh("square");
+    CORRADE_VERIFY(square);
+    CORRADE_COMPARE(square->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(square->isIndexed());
+    CORRADE_COMPARE(square->indexCount(), 6);
+    CORRADE_COMPARE(square->vertexCount(), 4);
+}
+
+void MeshOptimizerSceneConverterTest::addMultipleThreads() {
+    auto&& data = AddMultipleThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    /* Process the same set of meshes on a single thread and then with
+       multiple threads. The output should be the same and in the same
+       order. */
+    Containers::Pointer<AbstractImporter> importers[2];
+    std::vector<Float> errors[2];
+    for(std::size_t i: {0, 1}) {
+        Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+        converter->configuration().setValue("threads", i ? data.threads : 1);
+        converter->configuration().setValue("lodCount", 2);
+        converter->configuration().setValue("lodTargetError", 1.0f);
+
+        CORRADE_VERIFY(converter->begin());
+        for(UnsignedInt subdivisions = 0; subdivisions != 4; ++subdivisions) {
+            CORRADE_ITERATION(subdivisions);
+            CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(subdivisions)));
+            CORRADE_VERIFY(converter->add(MeshTools::compressIndices(Primitives::uvSphereSolid(4 + subdivisions*4, 8 + subdivisions*4))));
+            CORRADE_VERIFY(converter->add(Primitives::circle3DSolid(8 + subdivisions*8)));
+        }
+
+        importers[i] = converter->end();
+        CORRADE_VERIFY(importers[i]);
+
+        for(Utility::ConfigurationGroup* lod: converter->configuration().groups("lod"))
+            for(Float error: lod->values<Float>("error"))
+                errors[i].push_back(error);
+    }
+
+    CORRADE_COMPARE(importers[1]->meshCount(), 12);
+    CORRADE_COMPARE(importers[1]->meshCount(), importers[0]->meshCount());
+    for(UnsignedInt i = 0; i != importers[0]->meshCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(importers[1]->meshLevelCount(i), importers[0]->meshLevelCount(i));
+        for(UnsignedInt level = 0; level != importers[0]->meshLevelCount(i); ++level) {
+            CORRADE_ITERATION(level);
+            Containers::Optional<MeshData> expected = importers[0]->mesh(i, level);
+            Containers::Optional<MeshData> actual = importers[1]->mesh(i, level);
+            CORRADE_VERIFY(expected);
+            CORRADE_VERIFY(actual);
+            CORRADE_COMPARE(actual->indexType(), expected->indexType());
+            CORRADE_COMPARE_AS(actual->indexData(), expected->indexData(),
+                TestSuite::Compare::Container);
+            CORRADE_COMPARE_AS(actual->vertexData(), expected->vertexData(),
+                TestSuite::Compare::Container);
+        }
+    }
+
+    CORRADE_COMPARE_AS(errors[1], errors[0], TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::addMultipleThreadsFailed() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", 2);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("lodCount", 1);
+
+    const UnsignedByte indexData[3]{};
+    MeshData noPositions{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+
+    /* The processing is asynchronous, so add() succeeds and the failure is
+       reported only from end() */
+    CORRADE_VERIFY(converter->add(noPositions));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->end());
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::add(): lodCount requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::addMultipleThreadsAbort() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", 2);
+    converter->configuration().setValue("lodCount", 3);
+
+    /* Queue more work than the workers can get through before abort() is
+       called. It shouldn't wait for all of it, which can't be easily
+       verified, but it should at least not hang or crash. */
+    CORRADE_VERIFY(converter->begin());
+    const MeshData mesh = Primitives::icosphereSolid(4);
+    for(std::size_t i = 0; i != 32; ++i)
+        CORRADE_VERIFY(converter->add(mesh));
+    converter->abort();
+
+    /* The converter should be usable again after */
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(Primitives::icosphereSolid(1)));
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 1);
+}
+
+void MeshOptimizerSceneConverterTest::levelsNotMultiple() {
+    auto&& data = LevelsNotMultipleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue(data.option, data.value);
+
+    MeshData mesh = MeshTools::owned(Primitives::icosphereSolid(0));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_VERIFY(!converter->convertInPlace(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): meshlets, LODs and shadow indices are produced as additional mesh levels, use begin(), add() and end() instead\n"
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): meshlets, LODs and shadow indices are produced as additional mesh levels, use begin(), add() and end() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::generateShadowIndices() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateShadowIndices", true);
+    /* So the shadow indices can be compared to the base ones one by one */
+    converter->configuration().setValue("optimizeVertexCache", false);
+
+    /* The texture coordinate seam duplicates the vertices along it, the
+       shadow indices shouldn't reference those */
+    MeshData sphere = MeshTools::compressIndices(
+        Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates),
+        MeshIndexType::UnsignedShort);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(sphere));
+
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    Containers::Optional<MeshData> base = importer->mesh(0);
+    Containers::Optional<MeshData> shadow = importer->mesh(0, 1);
+    CORRADE_VERIFY(base);
+    CORRADE_VERIFY(shadow);
+    CORRADE_COMPARE(shadow->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(shadow->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(shadow->indexCount(), base->indexCount());
+
+    /* The vertex data and attribute layout are shared with the base level */
+    CORRADE_COMPARE(shadow->vertexCount(), base->vertexCount());
+    CORRADE_COMPARE(shadow->vertexData().data(), base->vertexData().data());
+    CORRADE_COMPARE(shadow->attributeCount(), base->attributeCount());
+
+    /* Each triangle has the same positions as in the base level, but there's
+       fewer distinct vertices referenced */
+    const Containers::StridedArrayView1D<const Vector3> positions = base->attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const UnsignedShort> baseIndices = base->indices<UnsignedShort>();
+    const Containers::StridedArrayView1D<const UnsignedShort> shadowIndices = shadow->indices<UnsignedShort>();
+    Containers::Array<bool> baseUsed{ValueInit, base->vertexCount()};
+    Containers::Array<bool> shadowUsed{ValueInit, base->vertexCount()};
+    for(std::size_t i = 0; i != shadowIndices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(positions[shadowIndices[i]], positions[baseIndices[i]]);
+        baseUsed[baseIndices[i]] = true;
+        shadowUsed[shadowIndices[i]] = true;
+    }
+    std::size_t baseUsedCount = 0, shadowUsedCount = 0;
+    for(std::size_t i = 0; i != baseUsed.size(); ++i) {
+        if(baseUsed[i]) ++baseUsedCount;
+        if(shadowUsed[i]) ++shadowUsedCount;
+    }
+    CORRADE_COMPARE_AS(shadowUsedCount, baseUsedCount,
+        TestSuite::Compare::Less);
+}
+
+void MeshOptimizerSceneConverterTest::generateShadowIndicesNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("generateShadowIndices", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::add(): generateShadowIndices requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::generateLods() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodCount", 3);
+    converter->configuration().setValue("lodTargetIndexCountThreshold", 0.5f);
+    converter->configuration().setValue("lodTargetError", 1.0f);
+
+    /* A leftover group from some previous conversion, should get removed by
+       begin() */
+    converter->configuration().addGroup("lod")->setValue("mesh", 7);
+
+    const Vector3 positions[]{
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f},
+        { 0.0f,  1.0f, 0.0f}
+    };
+    const UnsignedInt indices[]{0, 1, 2};
+    MeshData triangle{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position, Containers::arrayView(positions)}
+        }};
+
+    MeshData sphere = Primitives::uvSphereSolid(16, 32);
+    CORRADE_COMPARE(sphere.indexType(), MeshIndexType::UnsignedInt);
+
+    CORRADE_VERIFY(converter->begin());
+    CORRADE_VERIFY(converter->add(triangle));
+    CORRADE_VERIFY(converter->add(sphere));
+
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshCount(), 2);
+
+    /* A single triangle can't be simplified any further, so there's just the
+       base level */
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+
+    /* The sphere can */
+    CORRADE_COMPARE(importer->meshLevelCount(1), 4);
+    Containers::Optional<MeshData> base = importer->mesh(1);
+    CORRADE_VERIFY(base);
+    UnsignedInt previousIndexCount = base->indexCount();
+    for(UnsignedInt i = 1; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<MeshData> lod = importer->mesh(1, i);
+        CORRADE_VERIFY(lod);
+        CORRADE_COMPARE(lod->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE(lod->indexType(), MeshIndexType::UnsignedInt);
+        CORRADE_COMPARE_AS(lod->indexCount(), previousIndexCount,
+            TestSuite::Compare::Less);
+        CORRADE_COMPARE(lod->indexCount() % 3, 0);
+
+        /* The vertex data and attribute layout are shared with the base
+           level */
+        CORRADE_COMPARE(lod->vertexCount(), base->vertexCount());
+        CORRADE_COMPARE(lod->vertexData().data(), base->vertexData().data());
+        CORRADE_COMPARE(lod->attributeCount(), base->attributeCount());
+        CORRADE_COMPARE(lod->attributeOffset(MeshAttribute::Normal), base->attributeOffset(MeshAttribute::Normal));
+        CORRADE_COMPARE_AS(Math::max(lod->indices<UnsignedInt>()), base->vertexCount(),
+            TestSuite::Compare::Less);
+
+        previousIndexCount = lod->indexCount();
+    }
+
+    /* The errors are reported for just the second mesh, the leftover group
+       is gone */
+    CORRADE_COMPARE(converter->configuration().groupCount("lod"), 1);
+    Utility::ConfigurationGroup* lod = converter->configuration().group("lod");
+    CORRADE_VERIFY(lod);
+    CORRADE_COMPARE(lod->value<UnsignedInt>("mesh"), 1);
+    std::vector<Float> errors = lod->values<Float>("error");
+    CORRADE_COMPARE(errors.size(), 3);
+    /* The error is accumulated over the chain */
+    CORRADE_COMPARE_AS(errors[1], errors[0], TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(errors[2], errors[1], TestSuite::Compare::GreaterOrEqual);
+}
+
+void MeshOptimizerSceneConverterTest::generateLodsNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("lodCount", 1);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+
+    CORRADE_VERIFY(converter->begin());
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->add(mesh));
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::add(): lodCount requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::buildMeshlets() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+    converter->configuration().setValue("meshletMaxVertices", 16);
+    converter->configuration().setValue("meshletMaxTriangles", 16);
+
+    MeshData sphere = Primitives::icosphereSolid(2);
+    CORRADE_COMPARE(sphere.vertexCount(), 162);
+    CORRADE_COMPARE(sphere.indexCount(), 960);
+
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        const bool began = converter->begin();
+        if(!began && out.str().find("requires meshoptimizer 0.17") != std::string::npos)
+            CORRADE_SKIP("meshoptimizer older than 0.17, can't test");
+        CORRADE_VERIFY(began);
+    }
+    CORRADE_VERIFY(converter->add(sphere));
+
+    Containers::Pointer<AbstractImporter> importer = converter->end();
+    CORRADE_VERIFY(importer);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    /* The first level is the optimized mesh */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->vertexCount(), 162);
+
+    const MeshAttribute verticesAttribute = importer->meshAttributeForName("meshletVertices");
+    const MeshAttribute trianglesAttribute = importer->meshAttributeForName("meshletTriangles");
+    const MeshAttribute vertexCountAttribute = importer->meshAttributeForName("meshletVertexCount");
+    const MeshAttribute triangleCountAttribute = importer->meshAttributeForName("meshletTriangleCount");
+    const MeshAttribute boundingSphereAttribute = importer->meshAttributeForName("meshletBoundingSphere");
+    CORRADE_COMPARE(verticesAttribute, meshAttributeCustom(0));
+    CORRADE_COMPARE(importer->meshAttributeName(boundingSphereAttribute), "meshletBoundingSphere");
+    CORRADE_COMPARE(importer->meshAttributeName(meshAttributeCustom(7)), "meshletConeCutoff");
+    CORRADE_COMPARE(importer->meshAttributeName(meshAttributeCustom(8)), "");
+
+    Containers::Optional<MeshData> meshlets = importer->mesh(0, 1);
+    CORRADE_VERIFY(meshlets);
+    CORRADE_COMPARE(meshlets->primitive(), MeshPrimitive::Meshlets);
+    CORRADE_COMPARE(meshlets->attributeCount(), 8);
+    CORRADE_COMPARE(meshlets->attributeFormat(verticesAttribute), VertexFormat::UnsignedInt);
+    CORRADE_COMPARE(meshlets->attributeArraySize(verticesAttribute), 16);
+    CORRADE_COMPARE(meshlets->attributeFormat(trianglesAttribute), VertexFormat::UnsignedByte);
+    CORRADE_COMPARE(meshlets->attributeArraySize(trianglesAttribute), 48);
+    CORRADE_COMPARE(meshlets->attributeFormat(boundingSphereAttribute), VertexFormat::Vector4);
+    /* At least 320/16 meshlets */
+    CORRADE_COMPARE_AS(meshlets->vertexCount(), 20,
+        TestSuite::Compare::GreaterOrEqual);
+
+    /* All triangles should be present exactly once and reference valid
+       vertices */
+    const Containers::StridedArrayView2D<const UnsignedInt> vertices = meshlets->attribute<UnsignedInt[]>(verticesAttribute);
+    const Containers::StridedArrayView2D<const UnsignedByte> triangles = meshlets->attribute<UnsignedByte[]>(trianglesAttribute);
+    const Containers::StridedArrayView1D<const UnsignedInt> vertexCounts = meshlets->attribute<UnsignedInt>(vertexCountAttribute);
+    const Containers::StridedArrayView1D<const UnsignedInt> triangleCounts = meshlets->attribute<UnsignedInt>(triangleCountAttribute);
+    const Containers::StridedArrayView1D<const Vector4> boundingSpheres = meshlets->attribute<Vector4>(boundingSphereAttribute);
+    UnsignedInt triangleCount = 0;
+    for(std::size_t i = 0; i != meshlets->vertexCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS(vertexCounts[i], 16, TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(triangleCounts[i], 16, TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(boundingSpheres[i].w(), 0.0f, TestSuite::Compare::Greater);
+        for(std::size_t j = 0; j != vertexCounts[i]; ++j)
+            CORRADE_COMPARE_AS(vertices[i][j], 162, TestSuite::Compare::Less);
+        for(std::size_t j = 0; j != triangleCounts[i]*3; ++j)
+            CORRADE_COMPARE_AS(triangles[i][j], vertexCounts[i], TestSuite::Compare::Less);
+        triangleCount += triangleCounts[i];
+    }
+    CORRADE_COMPARE(triangleCount, 320);
+}
+
+void MeshOptimizerSceneConverterTest::buildMeshletsInvalidLimits() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+    converter->configuration().setValue("meshletMaxVertices", 64);
+    converter->configuration().setValue("meshletMaxTriangles", 126);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->begin());
+    if(out.str().find("requires meshoptimizer 0.17") != std::string::npos)
+        CORRADE_SKIP("meshoptimizer older than 0.17, can't test");
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::begin(): expected meshletMaxVertices to be between 3 and 255 and meshletMaxTriangles to be a multiple of 4 between 4 and 512, got 64 and 126\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeDecode() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* 16-bit indices to verify the original type is preserved */
+    MeshData icosphere = MeshTools::compressIndices(Primitives::icosphereSolid(3));
+    CORRADE_COMPARE(icosphere.indexType(), MeshIndexType::UnsignedShort);
+
+    Containers::Optional<MeshData> expected = converter->convert(icosphere);
+    CORRADE_VERIFY(expected);
+
+    converter->configuration().setValue("encode", true);
+    Containers::Optional<MeshData> encoded = converter->convert(icosphere);
+    CORRADE_VERIFY(encoded);
+    CORRADE_COMPARE(encoded->primitive(), meshPrimitiveWrap(0x4d4f5054));
+    CORRADE_VERIFY(!encoded->isIndexed());
+    CORRADE_COMPARE(encoded->attributeCount(), 0);
+    CORRADE_COMPARE(encoded->vertexCount(), expected->vertexCount());
+    CORRADE_COMPARE(Containers::StringView{encoded->vertexData().prefix(4)}, "MOPT");
+    CORRADE_COMPARE_AS(encoded->vertexData().size(),
+        expected->indexData().size() + expected->vertexData().size(),
+        TestSuite::Compare::Less);
+
+    /* Decoding gives back the same data as without encoding */
+    Containers::Optional<MeshData> decoded = converter->convert(*encoded);
+    CORRADE_VERIFY(decoded);
+    CORRADE_COMPARE(decoded->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(decoded->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(decoded->indexData(), expected->indexData(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(decoded->vertexCount(), expected->vertexCount());
+    CORRADE_COMPARE(decoded->attributeCount(), expected->attributeCount());
+    for(UnsignedInt i = 0; i != expected->attributeCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(decoded->attributeName(i), expected->attributeName(i));
+        CORRADE_COMPARE(decoded->attributeFormat(i), expected->attributeFormat(i));
+        CORRADE_COMPARE(decoded->attributeOffset(i), expected->attributeOffset(i));
+        CORRADE_COMPARE(decoded->attributeStride(i), expected->attributeStride(i));
+    }
+    CORRADE_COMPARE_AS(decoded->vertexData(), expected->vertexData(),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::encodeToData() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    MeshData icosphere = Primitives::icosphereSolid(2);
+
+    /* Encoding is done always, regardless of the option */
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(icosphere);
+    CORRADE_VERIFY(data);
+
+    converter->configuration().setValue("encode", true);
+    Containers::Optional<MeshData> encoded = converter->convert(icosphere);
+    CORRADE_VERIFY(encoded);
+    CORRADE_COMPARE_AS(*data, encoded->vertexData(),
+        TestSuite::Compare::Container);
+
+    /* Decoding from a non-owning wrapper, as an importer would do, with the
+       option not affecting decoding either */
+    converter->configuration().setValue("encode", false);
+    Containers::Optional<MeshData> decoded = converter->convert(MeshData{meshPrimitiveWrap(0x4d4f5054), {}, *data, {}, 0});
+    CORRADE_VERIFY(decoded);
+    CORRADE_COMPARE(decoded->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(decoded->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(decoded->indexCount(), 960);
+    CORRADE_COMPARE(decoded->vertexCount(), 162);
+    CORRADE_VERIFY(decoded->hasAttribute(MeshAttribute::Normal));
+}
+
+void MeshOptimizerSceneConverterTest::encodeInvalidStride() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("encode", true);
+
+    MeshData icosphere = MeshTools::interleave(
+        Primitives::icosphereSolid(1),
+        {MeshAttributeData{1}});
+    CORRADE_COMPARE(icosphere.attributeStride(MeshAttribute::Position), 25);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(icosphere));
+    CORRADE_VERIFY(!converter->convertToData(icosphere));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): expected vertex stride to be a multiple of four and at most 256 bytes for encoding, got 25\n"
+        "Trade::MeshOptimizerSceneConverter::convertToData(): expected vertex stride to be a multiple of four and at most 256 bytes for encoding, got 25\n");
+}
+
+void MeshOptimizerSceneConverterTest::encodeMultiple() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("encode", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->begin());
+    CORRADE_COMPARE(out.str(), "Trade::MeshOptimizerSceneConverter::begin(): encoding is supported only with convert() and convertToData()\n");
+}
+
+void MeshOptimizerSceneConverterTest::decodeInvalid() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    Containers::Optional<Containers::Array<char>> data = converter->convertToData(Primitives::icosphereSolid(1));
+    CORRADE_VERIFY(data);
+
+    auto decode = [&](Containers::ArrayView<const char> blob) {
+        return converter->convert(MeshData{meshPrimitiveWrap(0x4d4f5054), {}, blob, {}, 0});
+    };
+
+    Containers::Array<char> tooLong{ValueInit, data->size() + 1};
+    Utility::copy(*data, tooLong.prefix(data->size()));
+
+    Containers::Array<char> invalidSignature{NoInit, data->size()};
+    Utility::copy(*data, invalidSignature);
+    invalidSignature[0] = 'N';
+
+    /* Index type is the fourth 32-bit value in the header */
+    Containers::Array<char> invalidIndexType{NoInit, data->size()};
+    Utility::copy(*data, invalidIndexType);
+    invalidIndexType[12] = invalidIndexType[13] = invalidIndexType[14] = invalidIndexType[15] = 0;
+
+    /* Copy of the data with a little-endian value of given size patched at
+       given offset. The header is ten 32-bit values, the first attribute
+       after it is a 16-bit name, 16-bit array size, 32-bit format and 32-bit
+       offset. */
+    auto patched = [&](std::size_t offset, UnsignedInt value, std::size_t size) {
+        Containers::Array<char> out{NoInit, data->size()};
+        Utility::copy(*data, out);
+        for(std::size_t i = 0; i != size; ++i)
+            out[offset + i] = char((value >> (8*i)) & 0xff);
+        return out;
+    };
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!decode(data->prefix(39)));
+    CORRADE_VERIFY(!decode(tooLong));
+    CORRADE_VERIFY(!decode(invalidSignature));
+    CORRADE_VERIFY(!decode(invalidIndexType));
+    CORRADE_VERIFY(!decode(patched(8, UnsignedInt(MeshPrimitive::Lines), 4)));
+    CORRADE_VERIFY(!decode(patched(24, 26, 4)));
+    CORRADE_VERIFY(!decode(patched(24, 260, 4)));
+    CORRADE_VERIFY(!decode(patched(40, 0, 2)));
+    CORRADE_VERIFY(!decode(patched(40, 0x7fff, 2)));
+    CORRADE_VERIFY(!decode(patched(42, 2, 2)));
+    CORRADE_VERIFY(!decode(patched(44, 0, 4)));
+    CORRADE_VERIFY(!decode(patched(44, 0xffff, 4)));
+    CORRADE_VERIFY(!decode(patched(44, UnsignedInt(VertexFormat::UnsignedInt), 4)));
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "Trade::MeshOptimizerSceneConverter::convert(): expected at least 40 bytes of encoded data but got 39\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): expected {} bytes of encoded data but got {}\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded data signature or version\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded index type or count\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded primitive 0x{:x}\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded vertex stride 26\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded vertex stride 260\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 name 0\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 name 32767\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 array size 2 for Trade::MeshAttribute::Position of VertexFormat::Vector3\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 format 0x0\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 format 0xffff\n"
+        "Trade::MeshOptimizerSceneConverter::convert(): invalid encoded attribute 0 format VertexFormat::UnsignedInt for Trade::MeshAttribute::Position\n",
+        data->size(), data->size() + 1, UnsignedInt(MeshPrimitive::Lines)));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::MeshOptimizerSceneConverterTest)
@@ -0,0 +1,114 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/Implementation/Test/MeshImporterBenchmark.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct OpenGexImporterBenchmark: MeshImporterBenchmark {
+    explicit OpenGexImporterBenchmark();
+
+    Containers::StringView instanceName(std::size_t id) const override;
+};
+
+const struct {
+    const char* name;
+    bool normalsTextureCoordinates;
+} FileData[]{
+    {"positions", false},
+    {"positions, normals, texture coordinates", true}
+};
+
+void appendString(Containers::Array<char>& out, Containers::StringView string) {
+    arrayAppend(out, Containers::ArrayView<const char>{string.data(), string.size()});
+}
+
+/* A triangle strip expressed as an indexed triangle list */
+Containers::Array<char> generateFile(const UnsignedInt faceCount, const bool normalsTextureCoordinates) {
+    const UnsignedInt vertexCount = faceCount + 2;
+
+    Containers::Array<char> out;
+    appendString(out,
+        "GeometryObject {\n"
+        "    Mesh (primitive = \"triangles\") {\n"
+        "        VertexArray (attrib = \"position\") { float[3] {\n");
+    for(UnsignedInt i = 0; i != vertexCount; ++i)
+        appendString(out, Utility::format("{}{{{}, {}, {}}}", i ? ", " : "", Float(i), Float(i%7), Float(i%13)));
+    appendString(out, "\n        }}\n");
+
+    if(normalsTextureCoordinates) {
+        appendString(out, "        VertexArray (attrib = \"normal\") { float[3] {\n");
+        for(UnsignedInt i = 0; i != vertexCount; ++i)
+            appendString(out, Utility::format("{}{{0.0, {}, {}}}", i ? ", " : "", Float(i%2), Float((i + 1)%2)));
+        appendString(out, "\n        }}\n");
+
+        appendString(out, "        VertexArray (attrib = \"texcoord\") { float[2] {\n");
+        for(UnsignedInt i = 0; i != vertexCount; ++i)
+            appendString(out, Utility::format("{}{{{}, {}}}", i ? ", " : "", Float(i%2), Float(i%3)*0.5f));
+        appendString(out, "\n        }}\n");
+    }
+
+    appendString(out, "        IndexArray { unsigned_int32[3] {\n");
+    for(UnsignedInt i = 0; i != faceCount; ++i)
+        appendString(out, Utility::format("{}{{{}, {}, {}}}", i ? ", " : "", i, i + 1, i + 2));
+    appendString(out,
+        "\n        }}\n"
+        "    }\n"
+        "}\n");
+
+    return out;
+}
+
+OpenGexImporterBenchmark::OpenGexImporterBenchmark(): MeshImporterBenchmark{"OpenGexImporter", Containers::arraySize(FileData)} {
+    for(std::size_t i = 0; i != Containers::arraySize(FileData); ++i)
+        _files[i] = generateFile(_faceCount, FileData[i].normalsTextureCoordinates);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. It also pulls in the AnyImageImporter dependency. */
+    #ifdef OPENGEXIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(OPENGEXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* Reset the plugin dir after so it doesn't load anything else from the
+       filesystem */
+    #ifndef CORRADE_PLUGINMANAGER_NO_DYNAMIC_PLUGIN_SUPPORT
+    _manager.setPluginDirectory({});
+    #endif
+}
+
+Containers::StringView OpenGexImporterBenchmark::instanceName(const std::size_t id) const {
+    return FileData[id].name;
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenGexImporterBenchmark)
@@ -26,15 +26,18 @@
 
 #include "StanfordImporter.h"
 
+#include <memory>
 #include <unordered_map>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Containers/StringStlHash.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once <string> is gone here */
 #include <Corrade/Utility/EndiannessBatch.h>
-#include <Corrade/Utility/String.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/MeshTools/Combine.h>
@@ -43,9 +46,12 @@
 
 namespace Magnum { namespace Trade {
 
-struct StanfordImporter::State {
-    Containers::Array<char> data;
-    std::size_t headerSize;
+namespace {
+
+/* Everything parsed from the file header. Kept separately from the file data
+   so it can be cached and reused for files that have the same header. */
+struct Header {
+    std::size_t headerSize{};
     Containers::Array<MeshAttributeData> attributeData;
     Containers::Array<MeshAttributeData> faceAttributeData;
     UnsignedInt vertexStride{}, vertexCount{}, faceIndicesOffset{}, faceSkip{}, faceCount{};
@@ -56,11 +62,33 @@ struct StanfordImporter::State {
     Containers::Array<std::string> attributeNames;
 };
 
+}
+
+struct StanfordImporter::State {
+    Containers::Array<char> data;
+    /* Shared with the header cache, which makes a cache hit not allocate */
+    std::shared_ptr<const Header> header;
+};
+
+struct StanfordImporter::HeaderCache {
+    struct Entry {
+        std::size_t hash;
+        Containers::String headerData;
+        Containers::String objectIdAttribute;
+        std::shared_ptr<const Header> header;
+    };
+
+    Containers::Array<Entry> entries;
+    /* Entry that gets replaced next once the cache is full */
+    std::size_t next{};
+};
+
 StanfordImporter::StanfordImporter() {
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("perFaceToPerVertex", true);
     configuration().setValue("triangleFastPath", true);
     configuration().setValue("objectIdAttribute", "object_id");
+    configuration().setValue("headerCacheSize", 8);
 }
 
 StanfordImporter::StanfordImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -80,7 +108,7 @@ enum class PropertyType {
     Face
 };
 
-MeshIndexType parseIndexType(const std::string& type) {
+MeshIndexType parseIndexType(const Containers::StringView type) {
     if(type == "uchar"  || type == "uint8" ||
        type == "char"   || type == "int8")
         return MeshIndexType::UnsignedByte;
@@ -94,7 +122,7 @@ MeshIndexType parseIndexType(const std::string& type) {
     return {};
 }
 
-VertexFormat parseAttributeType(const std::string& type) {
+VertexFormat parseAttributeType(const Containers::StringView type) {
     if(type == "uchar"  || type == "uint8")
         return VertexFormat::UnsignedByte;
     if(type == "char"   || type == "int8")
@@ -138,17 +166,63 @@ template<class T> T extractIndexValue(const char* buffer, const MeshIndexType ty
     }
 }
 
-std::string extractLine(Containers::ArrayView<const char>& in) {
+Containers::StringView extractLine(Containers::StringView& in) {
     for(const char& i: in) if(i == '\n') {
-        std::size_t end = &i - in;
-        auto out = in.prefix(end);
+        const std::size_t end = &i - in.data();
+        const Containers::StringView out = in.prefix(end);
         in = in.exceptPrefix(end + 1);
-        return {out.begin(), out.end()};
+        return out;
     }
 
-    auto out = in;
+    const Containers::StringView out = in;
     in = {};
-    return {out.begin(), out.end()};
+    return out;
+}
+
+/* Splits the line on whitespace into the tokens array, returns token count.
+   If the line has more tokens than fit, returns the array size plus one. */
+template<std::size_t size> std::size_t splitTokens(Containers::StringView line, Containers::StringView(&tokens)[size]) {
+    std::size_t count = 0;
+    for(;;) {
+        line = line.trimmedPrefix();
+        if(line.isEmpty()) return count;
+        if(count == size) return size + 1;
+
+        std::size_t end = 0;
+        while(end != line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r' && line[end] != '\n' && line[end] != '\f' && line[end] != '\v')
+            ++end;
+        tokens[count++] = line.prefix(end);
+        line = line.exceptPrefix(end);
+    }
+}
+
+/* Unlike std::stoi() doesn't allocate, doesn't throw and rejects trailing
+   garbage */
+bool parseCount(const Containers::StringView string, UnsignedInt& out) {
+    if(string.isEmpty() || string.size() > 10) return false;
+
+    UnsignedLong value = 0;
+    for(const char c: string) {
+        if(c < '0' || c > '9') return false;
+        value = value*10 + (c - '0');
+    }
+    if(value > ~UnsignedInt{}) return false;
+
+    out = value;
+    return true;
+}
+
+/* Size of the header including the end_header line, or 0 if there's no such
+   line */
+std::size_t findHeaderSize(const Containers::StringView data) {
+    Containers::StringView in = data;
+    Containers::StringView tokens[1];
+    while(!in.isEmpty()) {
+        if(splitTokens(extractLine(in), tokens) && tokens[0] == "end_header")
+            return data.size() - in.size();
+    }
+
+    return 0;
 }
 
 template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<size, VertexFormat>& formats, const Math::Vector<size, UnsignedInt>& offsets, const char* name) {
@@ -170,62 +244,36 @@ template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<
     return true;
 }
 
-}
-
-void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.isEmpty()) {
-        Error{} << "Trade::StanfordImporter::openData(): the file is empty";
-        return;
-    }
-
-    /* Take over the existing array or copy the data if we can't */
-    Containers::Array<char> dataCopy;
-    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
-        dataCopy = std::move(data);
-    } else {
-        dataCopy = Containers::Array<char>{NoInit, data.size()};
-        Utility::copy(data, dataCopy);
-    }
-
-    /* Initialize the state */
-    auto state = Containers::pointer<State>();
-    Containers::ArrayView<const char> in = dataCopy;
-
+bool parseHeader(Containers::StringView& in, const Containers::StringView objectIdAttribute, Header& header) {
     /* Check file signature */
     {
-        std::string header = Utility::String::rtrim(extractLine(in));
-        if(header != "ply") {
-            Error{} << "Trade::StanfordImporter::openData(): invalid file signature" << header;
-            return;
+        const Containers::StringView signature = extractLine(in).trimmedSuffix();
+        if(signature != "ply") {
+            Error{} << "Trade::StanfordImporter::openData(): invalid file signature" << signature;
+            return false;
         }
     }
 
     /* Parse format line */
     Containers::Optional<bool> fileFormatNeedsEndianSwapping;
     {
-        while(in) {
-            const std::string line = extractLine(in);
-            std::vector<std::string> tokens = Utility::String::splitWithoutEmptyParts(line);
+        while(!in.isEmpty()) {
+            const Containers::StringView line = extractLine(in);
+            Containers::StringView tokens[5];
+            const std::size_t tokenCount = splitTokens(line, tokens);
 
             /* Skip empty lines and comments */
-            if(tokens.empty() || tokens.front() == "comment")
+            if(!tokenCount || tokens[0] == "comment")
                 continue;
 
             if(tokens[0] != "format") {
                 Error{} << "Trade::StanfordImporter::openData(): expected format line, got" << line;
-                return;
+                return false;
             }
 
-            if(tokens.size() != 3) {
+            if(tokenCount != 3) {
                 Error() << "Trade::StanfordImporter::openData(): invalid format line" << line;
-                return;
+                return false;
             }
 
             if(tokens[2] == "1.0") {
@@ -239,16 +287,16 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             }
 
             Error{} << "Trade::StanfordImporter::openData(): unsupported file format" << tokens[1] << tokens[2];
-            return;
+            return false;
         }
     }
 
     /* Check format line consistency */
     if(!fileFormatNeedsEndianSwapping) {
         Error{} << "Trade::StanfordImporter::openData(): missing format line";
-        return;
+        return false;
     }
-    state->fileFormatNeedsEndianSwapping = *fileFormatNeedsEndianSwapping;
+    header.fileFormatNeedsEndianSwapping = *fileFormatNeedsEndianSwapping;
 
     /* Parse rest of the header */
     Math::Vector3<VertexFormat> positionFormats;
@@ -267,46 +315,53 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
     {
         std::size_t vertexComponentOffset{};
         PropertyType propertyType{};
-        while(in) {
-            const std::string line = extractLine(in);
-            std::vector<std::string> tokens = Utility::String::splitWithoutEmptyParts(line);
+        while(!in.isEmpty()) {
+            const Containers::StringView line = extractLine(in);
+            Containers::StringView tokens[5];
+            const std::size_t tokenCount = splitTokens(line, tokens);
 
             /* Skip empty lines and comments */
-            if(tokens.empty() || tokens.front() == "comment")
+            if(!tokenCount || tokens[0] == "comment")
                 continue;
 
             /* Elements */
             if(tokens[0] == "element") {
                 /* Vertex elements */
-                if(tokens.size() == 3 && tokens[1] == "vertex") {
-                    state->vertexCount = std::stoi(tokens[2]);
+                if(tokenCount == 3 && tokens[1] == "vertex") {
+                    if(!parseCount(tokens[2], header.vertexCount)) {
+                        Error{} << "Trade::StanfordImporter::openData(): invalid element count" << tokens[2];
+                        return false;
+                    }
                     propertyType = PropertyType::Vertex;
 
                 /* Face elements */
-                } else if(tokens.size() == 3 &&tokens[1] == "face") {
-                    state->faceCount = std::stoi(tokens[2]);
+                } else if(tokenCount == 3 &&tokens[1] == "face") {
+                    if(!parseCount(tokens[2], header.faceCount)) {
+                        Error{} << "Trade::StanfordImporter::openData(): invalid element count" << tokens[2];
+                        return false;
+                    }
                     propertyType = PropertyType::Face;
 
                 /* Something else */
                 } else {
                     Error{} << "Trade::StanfordImporter::openData(): unknown element" << tokens[1];
-                    return;
+                    return false;
                 }
 
             /* Element properties */
             } else if(tokens[0] == "property") {
                 /* Vertex element properties */
                 if(propertyType == PropertyType::Vertex) {
-                    if(tokens.size() != 3) {
+                    if(tokenCount != 3) {
                         Error{} << "Trade::StanfordImporter::openData(): invalid vertex property line" << line;
-                        return;
+                        return false;
                     }
 
                     /* Component type */
                     const VertexFormat componentFormat = parseAttributeType(tokens[1]);
                     if(componentFormat == VertexFormat{}) {
                         Error{} << "Trade::StanfordImporter::openData(): invalid vertex component type" << tokens[1];
-                        return;
+                        return false;
                     }
 
                     /* Component */
@@ -350,20 +405,20 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                     } else if(tokens[2] == "alpha") {
                         colorOffsets.w() = vertexComponentOffset;
                         colorFormats.w() = componentFormat;
-                    } else if(tokens[2] == configuration().value("objectIdAttribute")) {
+                    } else if(tokens[2] == objectIdAttribute) {
                         objectIdOffset = vertexComponentOffset;
                         objectIdFormat = componentFormat;
 
                     /* Unknown component, add to the attribute list. Stride is
                        not known yet, using 0 until it's updated later. */
                     } else {
-                        auto inserted = state->attributeNameMap.emplace(tokens[2],
-                            meshAttributeCustom(state->attributeNames.size()));
-                        arrayAppend(state->attributeNames, tokens[2]);
-                        arrayAppend(state->attributeData, MeshAttributeData{
+                        auto inserted = header.attributeNameMap.emplace(std::string{tokens[2].data(), tokens[2].size()},
+                            meshAttributeCustom(header.attributeNames.size()));
+                        arrayAppend(header.attributeNames, InPlaceInit, tokens[2].data(), tokens[2].size());
+                        arrayAppend(header.attributeData, MeshAttributeData{
                             inserted.first->second,
                             componentFormat,
-                            vertexComponentOffset, state->vertexCount, 0});
+                            vertexComponentOffset, header.vertexCount, 0});
                     }
 
                     /* Add size of current component to total offset */
@@ -374,28 +429,28 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                     /* Face vertex indices. The vertex_indices name is usual,
                        Assimp exports with vertex_index, reference from
                        http://paulbourke.net/dataformats/ply/ mentions both. */
-                    if(tokens.size() == 5 && tokens[1] == "list" && (tokens[4] == "vertex_indices" || tokens[4] == "vertex_index")) {
-                        state->faceIndicesOffset = state->faceSkip;
-                        state->faceSkip = 0;
+                    if(tokenCount == 5 && tokens[1] == "list" && (tokens[4] == "vertex_indices" || tokens[4] == "vertex_index")) {
+                        header.faceIndicesOffset = header.faceSkip;
+                        header.faceSkip = 0;
 
                         /* Face size type */
-                        if((state->faceSizeType = parseIndexType(tokens[2])) == MeshIndexType{}) {
+                        if((header.faceSizeType = parseIndexType(tokens[2])) == MeshIndexType{}) {
                             Error{} << "Trade::StanfordImporter::openData(): invalid face size type" << tokens[2];
-                            return;
+                            return false;
                         }
 
                         /* Face index type */
-                        if((state->faceIndexType = parseIndexType(tokens[3])) == MeshIndexType{}) {
+                        if((header.faceIndexType = parseIndexType(tokens[3])) == MeshIndexType{}) {
                             Error{} << "Trade::StanfordImporter::openData(): invalid face index type" << tokens[3];
-                            return;
+                            return false;
                         }
 
                     /* Per-face component */
-                    } else if(tokens.size() == 3) {
+                    } else if(tokenCount == 3) {
                        const VertexFormat componentFormat = parseAttributeType(tokens[1]);
                         if(componentFormat == VertexFormat{}) {
                             Error{} << "Trade::StanfordImporter::openData(): invalid face component type" << tokens[1];
-                            return;
+                            return false;
                         }
 
                         /* Before indices are found, faceIndicesOffset is zero.
@@ -404,7 +459,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                            is always offset from the beginning of the face,
                            which is what we need. */
                         const UnsignedInt faceComponentOffset =
-                            state->faceIndicesOffset + state->faceSkip;
+                            header.faceIndicesOffset + header.faceSkip;
 
                         /* Per-face normals and colors make sense, OTOH
                            positions or texture coordinates don't, so not
@@ -433,7 +488,7 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                         } else if(tokens[2] == "alpha") {
                             colorOffsets.w() = faceComponentOffset;
                             colorFormats.w() = componentFormat;
-                        } else if(tokens[2] == configuration().value("objectIdAttribute")) {
+                        } else if(tokens[2] == objectIdAttribute) {
                             perFaceObjectIds = true;
                             objectIdOffset = faceComponentOffset;
                             objectIdFormat = componentFormat;
@@ -442,26 +497,26 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
                            Stride and actual triangle face count is not known yet,
                            using 0 until it's updated later. */
                         } else {
-                            auto inserted = state->attributeNameMap.emplace(tokens[2],
-                                meshAttributeCustom(state->attributeNames.size()));
-                            arrayAppend(state->attributeNames, tokens[2]);
-                            arrayAppend(state->faceAttributeData, MeshAttributeData{
+                            auto inserted = header.attributeNameMap.emplace(std::string{tokens[2].data(), tokens[2].size()},
+                                meshAttributeCustom(header.attributeNames.size()));
+                            arrayAppend(header.attributeNames, InPlaceInit, tokens[2].data(), tokens[2].size());
+                            arrayAppend(header.faceAttributeData, MeshAttributeData{
                                 inserted.first->second,
                                 componentFormat, faceComponentOffset, 0, 0});
                         }
 
-                        state->faceSkip += vertexFormatSize(componentFormat);
+                        header.faceSkip += vertexFormatSize(componentFormat);
 
                     /* Fail on unknown lines */
                     } else {
                         Error{} << "Trade::StanfordImporter::openData(): invalid face property line" << line;
-                        return;
+                        return false;
                     }
 
                 /* Unexpected property line */
                 } else if(propertyType == PropertyType{}) {
                     Error{} << "Trade::StanfordImporter::openData(): unexpected property line";
-                    return;
+                    return false;
                 }
 
             /* Header end */
@@ -471,30 +526,30 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             /* Something else */
             } else {
                 Error{} << "Trade::StanfordImporter::openData(): unknown line" << line;
-                return;
+                return false;
             }
         }
 
-        state->vertexStride = vertexComponentOffset;
+        header.vertexStride = vertexComponentOffset;
     }
 
     /* Check header consistency */
-    if(state->faceSizeType == MeshIndexType{} || state->faceIndexType == MeshIndexType{}) {
+    if(header.faceSizeType == MeshIndexType{} || header.faceIndexType == MeshIndexType{}) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete face specification";
-        return;
+        return false;
     }
 
     /* Stride is known now, update it in custom attributes. Triangle face count
        is not known yet, that'll get updated after parsing all faces. */
-    for(MeshAttributeData& attribute: state->attributeData) {
+    for(MeshAttributeData& attribute: header.attributeData) {
         attribute = MeshAttributeData{
             attribute.name(), attribute.format(),
-            attribute.offset({}), state->vertexCount, std::ptrdiff_t(state->vertexStride)};
+            attribute.offset({}), header.vertexCount, std::ptrdiff_t(header.vertexStride)};
     }
-    for(MeshAttributeData& attribute: state->faceAttributeData) {
+    for(MeshAttributeData& attribute: header.faceAttributeData) {
         attribute = MeshAttributeData{
             attribute.name(), attribute.format(),
-            attribute.offset({}), 0, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip)};
+            attribute.offset({}), 0, std::ptrdiff_t(header.faceIndicesOffset + header.faceSkip)};
     }
 
     /* Wrap up positions */
@@ -503,10 +558,10 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
            the same type and are right after each other */
         if((positionOffsets >= Vector3ui{~UnsignedInt{}}).all()) {
             Error{} << "Trade::StanfordImporter::openData(): no position components present";
-            return;
+            return false;
         }
         if(!checkVectorAttributeValidity(positionFormats, positionOffsets, "position"))
-            return;
+            return false;
 
         /* Ensure the type is one of allowed */
         if(positionFormats.x() != VertexFormat::Float &&
@@ -515,14 +570,14 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
            positionFormats.x() != VertexFormat::UnsignedShort &&
            positionFormats.x() != VertexFormat::Short) {
             Error{} << "Trade::StanfordImporter::openData(): unsupported position component type" << positionFormats.x();
-            return;
+            return false;
         }
 
         /* Add the attribute */
-        arrayAppend(state->attributeData, InPlaceInit,
+        arrayAppend(header.attributeData, InPlaceInit,
             MeshAttribute::Position,
             vertexFormat(positionFormats.x(), 3, false),
-            positionOffsets.x(), state->vertexCount, std::ptrdiff_t(state->vertexStride));
+            positionOffsets.x(), header.vertexCount, std::ptrdiff_t(header.vertexStride));
     }
 
     /* Wrap up normals, if any */
@@ -530,28 +585,28 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
         /* Check that all components have the same type and right after each
            other */
         if(!checkVectorAttributeValidity(normalFormats, normalOffsets, "normal"))
-            return;
+            return false;
 
         /* Ensure the type is one of allowed */
         if(normalFormats.x() != VertexFormat::Float &&
            normalFormats.x() != VertexFormat::Byte &&
            normalFormats.x() != VertexFormat::Short) {
             Error{} << "Trade::StanfordImporter::openData(): unsupported normal component type" << normalFormats.x();
-            return;
+            return false;
         }
 
         /* Add the attribute. If it is per-face, actual triangle face count is
            not known yet, using 0 until after all faces are parsed. */
-        if(!perFaceNormals) arrayAppend(state->attributeData,
+        if(!perFaceNormals) arrayAppend(header.attributeData,
             InPlaceInit, MeshAttribute::Normal,
             /* We want integer types normalized */
             vertexFormat(normalFormats.x(), 3, normalFormats.x() != VertexFormat::Float),
-            normalOffsets.x(), state->vertexCount, std::ptrdiff_t(state->vertexStride));
-        else arrayAppend(state->faceAttributeData,
+            normalOffsets.x(), header.vertexCount, std::ptrdiff_t(header.vertexStride));
+        else arrayAppend(header.faceAttributeData,
             InPlaceInit, MeshAttribute::Normal,
             /* We want integer types normalized */
             vertexFormat(normalFormats.x(), 3, normalFormats.x() != VertexFormat::Float),
-            normalOffsets.x(), 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
+            normalOffsets.x(), 0u, std::ptrdiff_t(header.faceIndicesOffset + header.faceSkip));
     }
 
     /* Wrap up texture coordinates, if any */
@@ -559,22 +614,22 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
         /* Check that all components have the same type and right after each
            other */
         if(!checkVectorAttributeValidity(textureCoordinateFormats, textureCoordinateOffsets, "texture coordinate"))
-            return;
+            return false;
 
         /* Ensure the type is one of allowed */
         if(textureCoordinateFormats.x() != VertexFormat::Float &&
            textureCoordinateFormats.x() != VertexFormat::UnsignedByte &&
            textureCoordinateFormats.x() != VertexFormat::UnsignedShort) {
             Error{} << "Trade::StanfordImporter::openData(): unsupported texture coordinate component type" << textureCoordinateFormats.x();
-            return;
+            return false;
         }
 
         /* Add the attribute */
-        arrayAppend(state->attributeData, InPlaceInit,
+        arrayAppend(header.attributeData, InPlaceInit,
             MeshAttribute::TextureCoordinates,
             /* We want integer types normalized */
             vertexFormat(textureCoordinateFormats.x(), 2, textureCoordinateFormats.x() != VertexFormat::Float),
-            textureCoordinateOffsets.x(), state->vertexCount, std::ptrdiff_t(state->vertexStride));
+            textureCoordinateOffsets.x(), header.vertexCount, std::ptrdiff_t(header.vertexStride));
     }
 
     /* Wrap up colors, if any */
@@ -583,10 +638,10 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
            other. Alpha is optional. */
         if(colorFormats.w() == VertexFormat{}) {
             if(!checkVectorAttributeValidity(colorFormats.xyz(), colorOffsets.xyz(), "color"))
-                return;
+                return false;
         } else {
             if(!checkVectorAttributeValidity(colorFormats, colorOffsets, "color"))
-                return;
+                return false;
         }
 
         /* Ensure the type is one of allowed */
@@ -594,21 +649,21 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
            colorFormats.x() != VertexFormat::UnsignedByte &&
            colorFormats.x() != VertexFormat::UnsignedShort) {
             Error{} << "Trade::StanfordImporter::openData(): unsupported color component type" << colorFormats.x();
-            return;
+            return false;
         }
 
         /* Add the attribute. If it is per-face, actual triangle face count is
            not known yet, using 0 until after all faces are parsed. */
-        if(!perFaceColors) arrayAppend(state->attributeData,
+        if(!perFaceColors) arrayAppend(header.attributeData,
             InPlaceInit, MeshAttribute::Color,
             /* We want integer types normalized, 3 or 4 components */
             vertexFormat(colorFormats.x(), colorFormats.w() == VertexFormat{} ? 3 : 4, colorFormats.x() != VertexFormat::Float),
-            colorOffsets.x(), state->vertexCount, std::ptrdiff_t(state->vertexStride));
-        else arrayAppend(state->faceAttributeData,
+            colorOffsets.x(), header.vertexCount, std::ptrdiff_t(header.vertexStride));
+        else arrayAppend(header.faceAttributeData,
             InPlaceInit, MeshAttribute::Color,
             /* We want integer types normalized, 3 or 4 components */
             vertexFormat(colorFormats.x(), colorFormats.w() == VertexFormat{} ? 3 : 4, colorFormats.x() != VertexFormat::Float),
-            colorOffsets.x(), 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
+            colorOffsets.x(), 0u, std::ptrdiff_t(header.faceIndicesOffset + header.faceSkip));
     }
 
     /* Wrap up object IDs, if any */
@@ -624,28 +679,116 @@ void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlag
             format = VertexFormat::UnsignedByte;
         else {
             Error{} << "Trade::StanfordImporter::openData(): unsupported object ID type" << objectIdFormat;
-            return;
+            return false;
         }
 
         /* Add the attribute. If it is per-face, actual triangle face count is
            not known yet, using 0 until after all faces are parsed. */
-        if(!perFaceObjectIds) arrayAppend(state->attributeData,
+        if(!perFaceObjectIds) arrayAppend(header.attributeData,
             InPlaceInit, MeshAttribute::ObjectId, format,
-            objectIdOffset, state->vertexCount, std::ptrdiff_t(state->vertexStride));
-        else arrayAppend(state->faceAttributeData,
+            objectIdOffset, header.vertexCount, std::ptrdiff_t(header.vertexStride));
+        else arrayAppend(header.faceAttributeData,
             InPlaceInit, MeshAttribute::ObjectId, format,
-            objectIdOffset, 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
+            objectIdOffset, 0u, std::ptrdiff_t(header.faceIndicesOffset + header.faceSkip));
+    }
+
+    return true;
+}
+
+}
+
+void StanfordImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
+    /* Because here we're copying the data and using the _in to check if file
+       is opened, having them nullptr would mean openData() would fail without
+       any error message. It's not possible to do this check on the importer
+       side, because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is much
+       larger). This way it'll also work nicely with a future openMemory(). */
+    if(data.isEmpty()) {
+        Error{} << "Trade::StanfordImporter::openData(): the file is empty";
+        return;
+    }
+
+    /* Take over the existing array or copy the data if we can't */
+    Containers::Array<char> dataCopy;
+    if(dataFlags & (DataFlag::Owned|DataFlag::ExternallyOwned)) {
+        dataCopy = std::move(data);
+    } else {
+        dataCopy = Containers::Array<char>{NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+    }
+
+    /* Initialize the state */
+    auto state = Containers::pointer<State>();
+    const Containers::StringView objectIdAttribute = configuration().value<Containers::StringView>("objectIdAttribute");
+
+    /* If a file with the same header was opened before, reuse the parsed
+       header instead of parsing and validating it again. The header data are
+       compared in full on a hash match, so a hash collision can't result in a
+       wrong layout being used. */
+    const std::size_t headerCacheSize = configuration().value<UnsignedInt>("headerCacheSize");
+    const Containers::StringView dataView{dataCopy.data(), dataCopy.size()};
+    Containers::StringView headerData;
+    std::size_t headerHash{};
+    const HeaderCache::Entry* cached = nullptr;
+    if(headerCacheSize) {
+        if(!_headerCache) _headerCache = Containers::pointer<HeaderCache>();
+
+        headerData = dataView.prefix(findHeaderSize(dataView));
+        if(!headerData.isEmpty()) {
+            headerHash = std::hash<Containers::StringView>{}(headerData);
+            for(const HeaderCache::Entry& entry: _headerCache->entries) {
+                if(entry.hash == headerHash && entry.objectIdAttribute == objectIdAttribute && entry.headerData == headerData) {
+                    cached = &entry;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(cached) state->header = cached->header;
+    else {
+        std::shared_ptr<Header> header = std::make_shared<Header>();
+        Containers::StringView in = dataView;
+        if(!parseHeader(in, objectIdAttribute, *header)) return;
+
+        /* Remember header size so we can directly access the binary data in
+           doMesh() */
+        header->headerSize = dataCopy.size() - in.size();
+        state->header = header;
+
+        /* Put the parsed header into the cache, replacing the oldest entry if
+           it's full */
+        if(!headerData.isEmpty() && headerData.size() == header->headerSize) {
+            HeaderCache& cache = *_headerCache;
+            HeaderCache::Entry entry;
+            entry.hash = headerHash;
+            entry.headerData = Containers::String{headerData};
+            entry.objectIdAttribute = Containers::String{objectIdAttribute};
+            entry.header = state->header;
+
+            if(cache.entries.size() > headerCacheSize)
+                arrayResize(cache.entries, headerCacheSize);
+            if(cache.entries.size() < headerCacheSize)
+                arrayAppend(cache.entries, std::move(entry));
+            else {
+                cache.next %= headerCacheSize;
+                cache.entries[cache.next] = std::move(entry);
+                cache.next = (cache.next + 1) % headerCacheSize;
+            }
+        }
     }
 
-    if(in.size() < state->vertexStride*state->vertexCount) {
+    /* The product has to be calculated in 64 bits, otherwise a large vertex
+       count could wrap around and pass this check */
+    if(dataCopy.size() - state->header->headerSize < std::size_t(state->header->vertexStride)*state->header->vertexCount) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
         return;
     }
 
-    /* All good, move the data to the state struct and save it. Remember header
-       size so we can directly access the binary data in doMesh(). */
+    /* All good, move the data to the state struct and save it */
     state->data = std::move(dataCopy);
-    state->headerSize = state->data.size() - in.size();
     _state = std::move(state);
 }
 
@@ -662,55 +805,55 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
     const bool parsePerFaceAttributes = level == 1 ||
         configuration().value<bool>("perFaceToPerVertex");
 
-    Containers::ArrayView<const char> in = _state->data.exceptPrefix(_state->headerSize);
+    Containers::ArrayView<const char> in = _state->data.exceptPrefix(_state->header->headerSize);
 
     /* Copy all vertex data */
     Containers::Array<char> vertexData;
     if(level == 0) {
         vertexData = Containers::Array<char>{NoInit,
-        _state->vertexStride*_state->vertexCount};
+        std::size_t(_state->header->vertexStride)*_state->header->vertexCount};
         Utility::copy(in.prefix(vertexData.size()), vertexData);
     }
-    in = in.exceptPrefix(_state->vertexStride*_state->vertexCount);
+    in = in.exceptPrefix(std::size_t(_state->header->vertexStride)*_state->header->vertexCount);
 
     /* Parse faces, keeping the original index type */
     Containers::Array<char> faceData;
     Containers::Array<char> indexData;
-    const UnsignedInt faceIndexTypeSize = meshIndexTypeSize(_state->faceIndexType);
-    const UnsignedInt faceSizeTypeSize = meshIndexTypeSize(_state->faceSizeType);
-    UnsignedInt triangleFaceCount = _state->faceCount;
+    const UnsignedInt faceIndexTypeSize = meshIndexTypeSize(_state->header->faceIndexType);
+    const UnsignedInt faceSizeTypeSize = meshIndexTypeSize(_state->header->faceSizeType);
+    UnsignedInt triangleFaceCount = _state->header->faceCount;
 
     /* Fast path -- if all faces are triangles, we can just copy all indices
        and per-face data directly without parsing anything */
-    if(configuration().value<bool>("triangleFastPath") && in.size() == _state->faceCount*(_state->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->faceSkip)) {
+    if(configuration().value<bool>("triangleFastPath") && in.size() == std::size_t(_state->header->faceCount)*(_state->header->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->header->faceSkip)) {
         if(level == 0) {
             indexData = Containers::Array<char>{NoInit,
-                _state->faceCount*3*faceIndexTypeSize};
+                std::size_t(_state->header->faceCount)*3*faceIndexTypeSize};
             Containers::StridedArrayView2D<const char> src{in,
-                in + _state->faceIndicesOffset + faceSizeTypeSize,
-                {_state->faceCount, 3*faceIndexTypeSize},
-                {std::ptrdiff_t(_state->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->faceSkip), 1}};
+                in + _state->header->faceIndicesOffset + faceSizeTypeSize,
+                {_state->header->faceCount, 3*faceIndexTypeSize},
+                {std::ptrdiff_t(_state->header->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->header->faceSkip), 1}};
             Containers::StridedArrayView2D<char> dst{indexData,
-                {_state->faceCount, 3*faceIndexTypeSize}};
+                {_state->header->faceCount, 3*faceIndexTypeSize}};
             Utility::copy(src, dst);
         }
 
         if(parsePerFaceAttributes) {
             faceData = Containers::Array<char>{NoInit,
-                _state->faceCount*(_state->faceIndicesOffset + _state->faceSkip)};
+                std::size_t(_state->header->faceCount)*(_state->header->faceIndicesOffset + _state->header->faceSkip)};
             Containers::StridedArrayView2D<const char> src{in,
-                {_state->faceCount, _state->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->faceSkip}};
+                {_state->header->faceCount, _state->header->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + _state->header->faceSkip}};
             Containers::StridedArrayView2D<char> dst{faceData,
-                {_state->faceCount, _state->faceIndicesOffset + _state->faceSkip}};
+                {_state->header->faceCount, _state->header->faceIndicesOffset + _state->header->faceSkip}};
             /* Separately copy the part before indices, and the part after.
                Transpose the sliced array so first dimension is faces and
                second bytes to avoid copying it byte-by-byte. */
             Utility::copy(
-                src.prefix({_state->faceCount, _state->faceIndicesOffset}),
-                dst.prefix({_state->faceCount, _state->faceIndicesOffset}));
+                src.prefix({_state->header->faceCount, _state->header->faceIndicesOffset}),
+                dst.prefix({_state->header->faceCount, _state->header->faceIndicesOffset}));
             Utility::copy(
-                src.exceptPrefix({0, _state->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize}),
-                dst.exceptPrefix({0, _state->faceIndicesOffset}));
+                src.exceptPrefix({0, _state->header->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize}),
+                dst.exceptPrefix({0, _state->header->faceIndicesOffset}));
         }
 
     /* Otherwise reserve optimistically amount for all-triangle faces, and let
@@ -719,38 +862,38 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
        (assuming no stray data at EOF) */
     } else {
         if(parsePerFaceAttributes) Containers::arrayReserve<ArrayAllocator>(faceData,
-            _state->faceCount*(_state->faceIndicesOffset + _state->faceSkip));
+            _state->header->faceCount*(_state->header->faceIndicesOffset + _state->header->faceSkip));
         Containers::arrayReserve<ArrayAllocator>(indexData,
-            _state->faceCount*3*faceIndexTypeSize);
-        for(std::size_t i = 0; i != _state->faceCount; ++i) {
-            if(in.size() < _state->faceIndicesOffset + faceSizeTypeSize) {
+            _state->header->faceCount*3*faceIndexTypeSize);
+        for(std::size_t i = 0; i != _state->header->faceCount; ++i) {
+            if(in.size() < _state->header->faceIndicesOffset + faceSizeTypeSize) {
                 Error() << "Trade::StanfordImporter::mesh(): incomplete index data";
                 return Containers::NullOpt;
             }
 
             /* Copy all face attributes that are before the index */
-            const Containers::ArrayView<const char> faceDataBeforeIndices = in.prefix(_state->faceIndicesOffset);
-            in = in.exceptPrefix(_state->faceIndicesOffset);
+            const Containers::ArrayView<const char> faceDataBeforeIndices = in.prefix(_state->header->faceIndicesOffset);
+            in = in.exceptPrefix(_state->header->faceIndicesOffset);
 
             /* Get face size */
             const Containers::ArrayView<const char> faceSizeData = in.prefix(faceSizeTypeSize);
             in = in.exceptPrefix(faceSizeTypeSize);
-            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faceSizeData, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faceSizeData, _state->header->faceSizeType, _state->header->fileFormatNeedsEndianSwapping);
             if(faceSize < 3 || faceSize > 4) {
                 Error() << "Trade::StanfordImporter::mesh(): unsupported face size" << faceSize;
                 return Containers::NullOpt;
             }
 
             /* Parse face indices */
-            if(in.size() < faceIndexTypeSize*faceSize + _state->faceSkip) {
+            if(in.size() < faceIndexTypeSize*faceSize + _state->header->faceSkip) {
                 Error() << "Trade::StanfordImporter::mesh(): incomplete face data";
                 return Containers::NullOpt;
             }
 
             const Containers::ArrayView<const char> faceIndexData = in.prefix(faceIndexTypeSize*faceSize);
             in = in.exceptPrefix(faceIndexTypeSize*faceSize);
-            const Containers::ArrayView<const char> faceDataAfterIndices = in.prefix(_state->faceSkip);
-            in = in.exceptPrefix(_state->faceSkip);
+            const Containers::ArrayView<const char> faceDataAfterIndices = in.prefix(_state->header->faceSkip);
+            in = in.exceptPrefix(_state->header->faceSkip);
 
             /* Append either the triangle or the first triangle of the quad */
             Containers::arrayAppend<ArrayAllocator>(indexData,
@@ -788,31 +931,31 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
     Containers::Array<MeshAttributeData> vertexAttributeData;
     Containers::Array<MeshAttributeData> faceAttributeData;
     if(level == 0) {
-        vertexAttributeData = Containers::Array<MeshAttributeData>{_state->attributeData.size()};
+        vertexAttributeData = Containers::Array<MeshAttributeData>{_state->header->attributeData.size()};
         for(std::size_t i = 0; i != vertexAttributeData.size(); ++i) {
             vertexAttributeData[i] = MeshAttributeData{
-                _state->attributeData[i].name(),
-                _state->attributeData[i].format(),
-                _state->attributeData[i].data(vertexData)};
+                _state->header->attributeData[i].name(),
+                _state->header->attributeData[i].format(),
+                _state->header->attributeData[i].data(vertexData)};
         }
     }
 
     if(parsePerFaceAttributes) {
-        faceAttributeData = Containers::Array<MeshAttributeData>{_state->faceAttributeData.size()};
+        faceAttributeData = Containers::Array<MeshAttributeData>{_state->header->faceAttributeData.size()};
         for(std::size_t i = 0; i != faceAttributeData.size(); ++i) {
             faceAttributeData[i] = MeshAttributeData{
-                _state->faceAttributeData[i].name(),
-                _state->faceAttributeData[i].format(),
+                _state->header->faceAttributeData[i].name(),
+                _state->header->faceAttributeData[i].format(),
                 Containers::StridedArrayView1D<const void>{
                     faceData,
-                    _state->faceAttributeData[i].data(faceData).data(),
+                    _state->header->faceAttributeData[i].data(faceData).data(),
                     triangleFaceCount,
-                    _state->faceAttributeData[i].stride()}};
+                    _state->header->faceAttributeData[i].stride()}};
         }
     }
 
     /* Endian-swap the data, if needed */
-    if(_state->fileFormatNeedsEndianSwapping) {
+    if(_state->header->fileFormatNeedsEndianSwapping) {
         for(const auto& attributeData: {
             Containers::arrayView(vertexAttributeData),
             Containers::arrayView(faceAttributeData)}) {
@@ -858,7 +1001,7 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 
         /** @todo in this case it'll assert if indices are out of bounds, check
             for it at runtime somehow */
-        MeshIndexData indices{_state->faceIndexType, indexData};
+        MeshIndexData indices{_state->header->faceIndexType, indexData};
         MeshData perVertex{MeshPrimitive::Triangles,
             std::move(indexData), indices,
             std::move(vertexData), std::move(vertexAttributeData)};
@@ -868,7 +1011,7 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
     }
 
     if(level == 0) {
-        MeshIndexData indices{_state->faceIndexType, indexData};
+        MeshIndexData indices{_state->header->faceIndexType, indexData};
         return MeshData{MeshPrimitive::Triangles,
             std::move(indexData), indices,
             std::move(vertexData), std::move(vertexAttributeData)};
@@ -879,12 +1022,14 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
 }
 
 MeshAttribute StanfordImporter::doMeshAttributeForName(const Containers::StringView name) {
-    return _state ? _state->attributeNameMap[name] : MeshAttribute{};
+    if(!_state) return {};
+    const auto found = _state->header->attributeNameMap.find(name);
+    return found == _state->header->attributeNameMap.end() ? MeshAttribute{} : found->second;
 }
 
 Containers::String StanfordImporter::doMeshAttributeName(UnsignedShort name) {
-    return _state && name < _state->attributeNames.size() ?
-        _state->attributeNames[name] : "";
+    return _state && name < _state->header->attributeNames.size() ?
+        _state->header->attributeNames[name] : "";
 }
 
 }}
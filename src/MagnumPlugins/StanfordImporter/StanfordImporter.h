@@ -182,6 +182,19 @@ using @ref meshAttributeName() and @ref meshAttributeForName(). Attributes with
 unknown types cause the import to fail, as the format relies on knowing the
 type size.
 
+@subsection Trade-StanfordImporter-behavior-header-cache Header cache
+
+The importer remembers parsed headers of recently opened files and when a file
+with a byte-for-byte identical header is opened again, it reuses the
+previously parsed and validated vertex and face layout instead of parsing the
+header again. The layout is shared with the cache and not copied, so opening
+such a file doesn't allocate anything for the header. This is useful when opening many files of the same schema with a
+single importer instance. The number of remembered headers can be changed, or
+the cache disabled altogether, with the @cb{.ini} headerCacheSize @ce
+@ref Trade-StanfordImporter-configuration "configuration option". The cache is
+kept for the whole lifetime of the importer instance, independently of
+@ref close().
+
 @section Trade-StanfordImporter-configuration Plugin-specific configuration
 
 It's possible to tune various import options through @ref configuration(). See
@@ -216,7 +229,9 @@ class MAGNUM_STANFORDIMPORTER_EXPORT StanfordImporter: public AbstractImporter {
         MAGNUM_STANFORDIMPORTER_LOCAL Containers::String doMeshAttributeName(UnsignedShort name) override;
 
         struct State;
+        struct HeaderCache;
         Containers::Pointer<State> _state;
+        Containers::Pointer<HeaderCache> _headerCache;
 };
 
 }}
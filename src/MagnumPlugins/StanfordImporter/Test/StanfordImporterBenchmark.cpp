@@ -0,0 +1,128 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/Implementation/Test/MeshImporterBenchmark.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct StanfordImporterBenchmark: MeshImporterBenchmark {
+    explicit StanfordImporterBenchmark();
+
+    Containers::StringView instanceName(std::size_t id) const override;
+};
+
+const struct {
+    const char* name;
+    bool bigEndian;
+    bool mixedQuads;
+    bool perFaceNormals;
+} FileData[]{
+    {"triangles", false, false, false},
+    {"triangles, big-endian", true, false, false},
+    {"mixed triangles and quads", false, true, false},
+    {"per-face normals", false, false, true}
+};
+
+template<class T> void append(Containers::Array<char>& out, T value, bool bigEndian) {
+    value = bigEndian ? Utility::Endianness::bigEndian(value) :
+        Utility::Endianness::littleEndian(value);
+    arrayAppend(out, Containers::ArrayView<const char>{reinterpret_cast<const char*>(&value), sizeof(T)});
+}
+
+/* A triangle strip expressed as a face list, every other face extended to a
+   quad if mixedQuads is set */
+Containers::Array<char> generateFile(const UnsignedInt faceCount, const bool bigEndian, const bool mixedQuads, const bool perFaceNormals) {
+    const UnsignedInt vertexCount = faceCount + 3;
+
+    Containers::Array<char> out;
+    const Containers::String header = Utility::format(
+        "ply\n"
+        "format {} 1.0\n"
+        "element vertex {}\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face {}\n"
+        "{}"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n",
+        bigEndian ? "binary_big_endian" : "binary_little_endian",
+        vertexCount, faceCount,
+        perFaceNormals ?
+            "property float nx\n"
+            "property float ny\n"
+            "property float nz\n" : "");
+    arrayAppend(out, Containers::ArrayView<const char>{header.data(), header.size()});
+
+    for(UnsignedInt i = 0; i != vertexCount; ++i) {
+        append(out, Float(i), bigEndian);
+        append(out, Float(i%7), bigEndian);
+        append(out, Float(i%13), bigEndian);
+    }
+
+    for(UnsignedInt i = 0; i != faceCount; ++i) {
+        if(perFaceNormals) {
+            append(out, 0.0f, bigEndian);
+            append(out, Float(i%2), bigEndian);
+            append(out, Float((i + 1)%2), bigEndian);
+        }
+
+        const UnsignedByte size = mixedQuads && i%2 ? 4 : 3;
+        arrayAppend(out, char(size));
+        for(UnsignedInt j = 0; j != size; ++j)
+            append(out, i + j, bigEndian);
+    }
+
+    return out;
+}
+
+StanfordImporterBenchmark::StanfordImporterBenchmark(): MeshImporterBenchmark{"StanfordImporter", Containers::arraySize(FileData)} {
+    for(std::size_t i = 0; i != Containers::arraySize(FileData); ++i)
+        _files[i] = generateFile(_faceCount, FileData[i].bigEndian, FileData[i].mixedQuads, FileData[i].perFaceNormals);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STANFORDIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+Containers::StringView StanfordImporterBenchmark::instanceName(const std::size_t id) const {
+    return FileData[id].name;
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::StanfordImporterBenchmark)
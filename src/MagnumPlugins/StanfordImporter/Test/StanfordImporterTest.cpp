@@ -64,6 +64,9 @@ struct StanfordImporterTest: TestSuite::Tester {
     void triangleFastPath();
     void triangleFastPathPerFaceToPerVertex();
 
+    void headerCache();
+    void headerCacheObjectIdAttribute();
+
     void openMemory();
     void openTwice();
     void importTwice();
@@ -86,6 +89,7 @@ constexpr struct {
 
     {"unknown-line", "unknown line heh", true},
     {"unknown-element", "unknown element edge", true},
+    {"invalid-element-count", "invalid element count 5x", true},
 
     {"unexpected-property", "unexpected property line", true},
     {"invalid-vertex-property", "invalid vertex property line property float x extradata", true},
@@ -96,6 +100,7 @@ constexpr struct {
     {"invalid-face-index-type", "invalid face index type float", true},
 
     {"incomplete-face-specification", "incomplete face specification", true},
+    {"invalid-vertex-count-overflow", "incomplete vertex data", true},
 
     {"positions-missing", "no position components present", true},
     {"positions-not-same-type", "expecting all position components to be present and have the same type but got Vector(VertexFormat::UnsignedShort, VertexFormat::UnsignedByte, VertexFormat::UnsignedShort)", true},
@@ -253,6 +258,15 @@ constexpr struct {
     {"disabled", false}
 };
 
+constexpr struct {
+    const char* name;
+    UnsignedInt size;
+} HeaderCacheData[]{
+    {"", 8},
+    {"single entry", 1},
+    {"disabled", 0}
+};
+
 /* Shared among all plugins that implement data copying optimizations */
 const struct {
     const char* name;
@@ -299,6 +313,11 @@ StanfordImporterTest::StanfordImporterTest() {
                        &StanfordImporterTest::triangleFastPathPerFaceToPerVertex},
         Containers::arraySize(FastTrianglePathData));
 
+    addInstancedTests({&StanfordImporterTest::headerCache},
+        Containers::arraySize(HeaderCacheData));
+
+    addTests({&StanfordImporterTest::headerCacheObjectIdAttribute});
+
     addInstancedTests({&StanfordImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -1021,6 +1040,74 @@ void StanfordImporterTest::triangleFastPathPerFaceToPerVertex() {
         }), TestSuite::Compare::Container);
 }
 
+void StanfordImporterTest::headerCache() {
+    auto&& data = HeaderCacheData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("headerCacheSize", data.size);
+
+    /* Alternating between two different headers, with the single-entry cache
+       each open replaces the previous entry */
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "custom-components.ply")));
+        CORRADE_COMPARE(importer->meshAttributeForName("weight"), meshAttributeCustom(1));
+        CORRADE_COMPARE(importer->meshAttributeName(meshAttributeCustom(3)), "id");
+        {
+            Containers::Optional<MeshData> mesh = importer->mesh(0);
+            CORRADE_VERIFY(mesh);
+            CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3us);
+            CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+                Containers::arrayView(Indices),
+                TestSuite::Compare::Container);
+        }
+
+        CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "positions-float-indices-uint.ply")));
+        CORRADE_COMPARE(importer->meshAttributeForName("weight"), MeshAttribute{});
+        {
+            Containers::Optional<MeshData> mesh = importer->mesh(0);
+            CORRADE_VERIFY(mesh);
+            CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+                Containers::arrayView(Positions),
+                TestSuite::Compare::Container);
+        }
+    }
+
+    /* A file with a cached header but incomplete data should still fail */
+    Containers::Optional<Containers::Array<char>> file = Utility::Path::read(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "positions-float-indices-uint.ply"));
+    CORRADE_VERIFY(file);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(file->prefix(0x103)));
+    CORRADE_COMPARE(out.str(), "Trade::StanfordImporter::openData(): incomplete vertex data\n");
+}
+
+void StanfordImporterTest::headerCacheObjectIdAttribute() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("objectIdAttribute", "OBJECTID");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "positions-uchar-normals-char-objectid-short-indices-ushort.ply")));
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->hasAttribute(MeshAttribute::ObjectId));
+    }
+
+    /* The same header parsed with a different object ID attribute name
+       shouldn't reuse the cached layout */
+    importer->configuration().setValue("objectIdAttribute", "object_id");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STANFORDIMPORTER_TEST_DIR, "positions-uchar-normals-char-objectid-short-indices-ushort.ply")));
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(!mesh->hasAttribute(MeshAttribute::ObjectId));
+        CORRADE_COMPARE(importer->meshAttributeName(meshAttributeCustom(0)), "OBJECTID");
+    }
+}
+
 void StanfordImporterTest::openMemory() {
     /* Same as (a subset of) parse() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */
@@ -25,15 +25,28 @@
 
 #include "StanfordSceneConverter.h"
 
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/EndiannessBatch.h>
 #include <Corrade/Utility/FormatStl.h> /** @todo remove once <string> is gone here */
+#include <Magnum/Math/Functions.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
 #include <Magnum/Trade/MeshData.h>
 
+#ifdef CORRADE_TARGET_WINDOWS
+#include <Corrade/Utility/Unicode.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
 using namespace Containers::Literals;
@@ -42,15 +55,37 @@ StanfordSceneConverter::StanfordSceneConverter(PluginManager::AbstractManager& m
 
 StanfordSceneConverter::~StanfordSceneConverter() = default;
 
-SceneConverterFeatures StanfordSceneConverter::doFeatures() const { return SceneConverterFeature::ConvertMeshToData; }
+SceneConverterFeatures StanfordSceneConverter::doFeatures() const {
+    return SceneConverterFeature::ConvertMeshToData|
+           SceneConverterFeature::ConvertMeshToFile;
+}
 
-Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
-    /* Convert to an indexed triangle mesh if it's a strip/fan */
+namespace {
+
+/* Everything needed to write the vertex and face data, calculated once from
+   the input mesh and configuration and then shared by all chunks and all
+   threads */
+struct Layout {
     MeshData triangles{MeshPrimitive::Triangles, 0};
+    std::string header;
+    /* Offset of each attribute in the output vertex. Attributes that can't be
+       written because the type is not supported by PLY or the name is
+       unknown have it set to ~std::size_t{}. */
+    Containers::Array<std::size_t> offsets;
+    std::size_t vertexSize;
+    std::size_t indexTypeSize;
+    std::size_t faceCount;
+    bool endianSwapNeeded;
+    bool ascii;
+};
+
+bool prepareLayout(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const char* const messagePrefix, Layout& layout) {
+    /* Convert to an indexed triangle mesh if it's a strip/fan */
+    MeshData& triangles = layout.triangles;
     if(mesh.primitive() == MeshPrimitive::TriangleStrip || mesh.primitive() == MeshPrimitive::TriangleFan) {
         if(mesh.isIndexed())
             triangles = MeshTools::generateIndices(MeshTools::duplicate(mesh));
-        else triangles = MeshTools::generateIndices(std::move(mesh));
+        else triangles = MeshTools::generateIndices(mesh);
 
     /* If it's triangles already, make a non-owning reference to the original */
     } else if(mesh.primitive() == MeshPrimitive::Triangles) {
@@ -68,30 +103,44 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
 
     /* Otherwise we're sorry */
     } else {
-        Error{} << "Trade::StanfordSceneConverter::convertToData(): expected a triangle mesh, got" << mesh.primitive();
-        return {};
+        Error{} << messagePrefix << "expected a triangle mesh, got" << mesh.primitive();
+        return false;
     }
 
-    /* Decide on endian swapping, write file signature */
-    bool endianSwapNeeded;
-    std::string header = "ply\n";
+    /* Decide on the format and endian swapping, write file signature */
+    layout.header = "ply\n";
     {
-        const auto endianness = configuration().value<Containers::StringView>("endianness");
+        const auto format = configuration.value<Containers::StringView>("format");
+        if(format == "ascii"_s) {
+            layout.ascii = true;
+        } else if(format == "binary"_s) {
+            layout.ascii = false;
+        } else {
+            Error{} << messagePrefix << "invalid option format=" << Debug::nospace << format;
+            return false;
+        }
+
+        const auto endianness = configuration.value<Containers::StringView>("endianness");
         bool isBigEndian;
         if(endianness == "native"_s) {
             isBigEndian = Utility::Endianness::isBigEndian();
-            endianSwapNeeded = false;
+            layout.endianSwapNeeded = false;
         } else if(endianness == "little"_s) {
             isBigEndian = false;
-            endianSwapNeeded = Utility::Endianness::isBigEndian();
+            layout.endianSwapNeeded = Utility::Endianness::isBigEndian();
         } else if(endianness == "big"_s) {
             isBigEndian = true;
-            endianSwapNeeded = !Utility::Endianness::isBigEndian();
+            layout.endianSwapNeeded = !Utility::Endianness::isBigEndian();
         } else {
-            Error{} << "Trade::StanfordSceneConverter::convertToData(): invalid option endianness=" << Debug::nospace << endianness;
-            return {};
+            Error{} << messagePrefix << "invalid option endianness=" << Debug::nospace << endianness;
+            return false;
         }
-        header += isBigEndian ?
+
+        /* Endianness doesn't matter for text output */
+        if(layout.ascii) {
+            layout.endianSwapNeeded = false;
+            layout.header += "format ascii 1.0\n";
+        } else layout.header += isBigEndian ?
             "format binary_big_endian 1.0\n" :
             "format binary_little_endian 1.0\n";
     }
@@ -101,21 +150,19 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
        restriction could eventually be lifted, but so far I don't have a use
        case, so better be strict. */
     if(!triangles.hasAttribute(MeshAttribute::Position)) {
-        Error{} << "Trade::StanfordSceneConverter::convertToData(): the mesh has no positions";
-        return {};
+        Error{} << messagePrefix << "the mesh has no positions";
+        return false;
     }
 
-    /* Write attribute header and calculate offsets for copying later.
-       Attributes that can't be written because the type is not supported by
-       PLY or the name is unknown will have offset kept at ~std::size_t{}. */
-    Containers::Array<std::size_t> offsets{DirectInit, triangles.attributeCount(), ~std::size_t{}};
-    std::size_t vertexSize = 0;
-    header += Utility::formatString("element vertex {}\n", triangles.vertexCount());
+    /* Write attribute header and calculate offsets for copying later */
+    layout.offsets = Containers::Array<std::size_t>{DirectInit, triangles.attributeCount(), ~std::size_t{}};
+    layout.vertexSize = 0;
+    layout.header += Utility::formatString("element vertex {}\n", triangles.vertexCount());
     for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
         const MeshAttribute name = triangles.attributeName(i);
         const VertexFormat format = triangles.attributeFormat(i);
         if(isVertexFormatImplementationSpecific(format)) {
-            Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with" << format;
+            Warning{} << messagePrefix << "skipping attribute" << name << "with" << format;
             continue;
         }
 
@@ -152,38 +199,38 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
                 formatString = "int";
                 break;
             default:
-                Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with unsupported format" << format;
+                Warning{} << messagePrefix << "skipping attribute" << name << "with unsupported format" << format;
                 continue;
         }
 
         /* Positions */
         if(name == MeshAttribute::Position) {
             if(vertexFormatComponentCount(format) != 3) {
-                Error{} << "Trade::StanfordSceneConverter::convertToData(): two-component positions are not supported";
-                return {};
+                Error{} << messagePrefix << "two-component positions are not supported";
+                return false;
             }
 
-            header += Utility::formatString(
+            layout.header += Utility::formatString(
                 "property {0} x\n"
                 "property {0} y\n"
                 "property {0} z\n", formatString);
 
         /* Normals */
         } else if(name == MeshAttribute::Normal) {
-            header += Utility::formatString(
+            layout.header += Utility::formatString(
                 "property {0} nx\n"
                 "property {0} ny\n"
                 "property {0} nz\n", formatString);
 
         /* Texture coordinates */
         } else if(name == MeshAttribute::TextureCoordinates) {
-            header += Utility::formatString(
+            layout.header += Utility::formatString(
                 "property {0} u\n"
                 "property {0} v\n", formatString);
 
         /* Colors */
         } else if(name == MeshAttribute::Color) {
-            header += Utility::formatString(
+            layout.header += Utility::formatString(
                 vertexFormatComponentCount(format) == 3 ?
                     "property {0} red\n"
                     "property {0} green\n"
@@ -195,92 +242,84 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
 
         /* Object ID */
         } else if(name == MeshAttribute::ObjectId) {
-            header += Utility::formatString("property {} {}\n", formatString,
-                configuration().value("objectIdAttribute"));
+            layout.header += Utility::formatString("property {} {}\n", formatString,
+                configuration.value("objectIdAttribute"));
 
         /* Something else, skip */
         /** @todo add setMeshAttributeName() and enable this for custom attribs */
         } else {
-            Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping unsupported attribute" << name;
+            Warning{} << messagePrefix << "skipping unsupported attribute" << name;
             continue;
         }
 
-        offsets[i] = vertexSize;
-        vertexSize += vertexFormatSize(format);
+        layout.offsets[i] = layout.vertexSize;
+        layout.vertexSize += vertexFormatSize(format);
     }
 
-    /* Index type */
+    /* Index type. For a non-indexed mesh we'll use 32-bit indices for
+       simplicity, face size is always 3 so a 1-byte type is enough. */
     const char* indexTypeString = nullptr;
-    if(!triangles.isIndexed())
+    if(!triangles.isIndexed()) {
         indexTypeString = "uint";
-    else switch(triangles.indexType()) {
-        case MeshIndexType::UnsignedInt:
-            indexTypeString = "uint";
-            break;
-        case MeshIndexType::UnsignedShort:
-            indexTypeString = "ushort";
-            break;
-        case MeshIndexType::UnsignedByte:
-            indexTypeString = "uchar";
-            break;
+        layout.indexTypeSize = 4;
+        layout.faceCount = triangles.vertexCount()/3;
+    } else {
+        switch(triangles.indexType()) {
+            case MeshIndexType::UnsignedInt:
+                indexTypeString = "uint";
+                break;
+            case MeshIndexType::UnsignedShort:
+                indexTypeString = "ushort";
+                break;
+            case MeshIndexType::UnsignedByte:
+                indexTypeString = "uchar";
+                break;
+        }
+        layout.indexTypeSize = meshIndexTypeSize(triangles.indexType());
+        layout.faceCount = triangles.indexCount()/3;
     }
     CORRADE_INTERNAL_ASSERT(indexTypeString);
 
     /* Wrap up the header -- for face attributes we have just the index list */
     /** @todo once multi-mesh conversion is supported, this could accept a
         MeshAttribute::Face with per-face attribs */
-    header += Utility::formatString(
+    layout.header += Utility::formatString(
         "element face {}\n"
         "property list uchar {} vertex_indices\n"
         "end_header\n",
-        triangles.isIndexed() ? triangles.indexCount()/3 : triangles.vertexCount()/3,
-        indexTypeString);
+        layout.faceCount, indexTypeString);
 
-    /* Vertex and index data size. For a non-indexed mesh we'll use 32-bit
-       indices for simplicity, face size is always 3 so a 1-byte type is
-       enough. */
-    const std::size_t vertexDataSize = vertexSize*triangles.vertexCount();
-    std::size_t indexTypeSize;
-    std::size_t indexDataSize;
-    if(!triangles.isIndexed()) {
-        indexTypeSize = 4;
-        indexDataSize = (1 + 3*4)*triangles.vertexCount()/3;
-    } else {
-        indexTypeSize = meshIndexTypeSize(triangles.indexType());
-        indexDataSize = (1 + 3*indexTypeSize)*triangles.indexCount()/3;
-    }
-
-    /* Allocate the data, copy header */
-    Containers::Array<char> out{NoInit, header.size() + vertexDataSize + indexDataSize};
-    /* Needs an explicit ArrayView constructor, otherwise MSVC 2015, 17 and 19
-       creates ArrayView<const void> here (wtf!) */
-    Utility::copy(Containers::ArrayView<const char>{header.data(), header.size()}, out.prefix(header.size()));
+    return true;
+}
 
-    /* Copy the vertices */
-    Containers::ArrayView<char> vertexData = out.slice(header.size(), header.size() + vertexDataSize);
+/* Copies vertices in the [begin, end) range into a tightly packed output,
+   endian-swapping them if needed. Operates on a contiguous range so it can
+   be called from multiple threads on disjoint parts of the output. */
+void copyVertices(const Layout& layout, const Containers::ArrayView<char> out, const std::size_t begin, const std::size_t end) {
+    const MeshData& triangles = layout.triangles;
+    const std::size_t count = end - begin;
     for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
-        if(offsets[i] == ~std::size_t{}) continue;
+        if(layout.offsets[i] == ~std::size_t{}) continue;
 
-        const Containers::StridedArrayView2D<const char> src = triangles.attribute(i);
-        const Containers::StridedArrayView2D<char> dst{vertexData,
-            vertexData.begin() + offsets[i],
-            src.size(), {std::ptrdiff_t(vertexSize), 1}};
+        const Containers::StridedArrayView2D<const char> src = triangles.attribute(i).slice(begin, end);
+        const Containers::StridedArrayView2D<char> dst{out,
+            out.begin() + layout.offsets[i],
+            src.size(), {std::ptrdiff_t(layout.vertexSize), 1}};
         Utility::copy(src, dst);
 
         /* Endian swap, if needed */
-        if(endianSwapNeeded) {
+        if(layout.endianSwapNeeded) {
             const VertexFormat format = triangles.attributeFormat(i);
             const UnsignedInt componentSize = vertexFormatSize(vertexFormatComponentFormat(format));
             if(componentSize == 1) continue;
 
             /* Can't reuse the dst array as it has no information about the
                component layout. Build a sparse view from scratch instead. */
-            const Containers::StridedArrayView2D<char> components{vertexData,
-                vertexData.begin() + offsets[i],
-                {vertexFormatComponentCount(format),
-                 triangles.vertexCount()},
+            const Containers::StridedArrayView2D<char> components{out,
+                out.begin() + layout.offsets[i],
+                {vertexFormatComponentCount(format), count},
                 {std::ptrdiff_t(componentSize),
-                 std::ptrdiff_t(vertexSize)}};
+                 std::ptrdiff_t(layout.vertexSize)}};
             for(Containers::StridedArrayView1D<char> component: components) {
                 if(componentSize == 8)
                     Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedLong>(component));
@@ -292,18 +331,25 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
             }
         }
     }
+}
+
+/* Copies faces in the [begin, end) range into the output, interleaving them
+   with face sizes and endian-swapping if needed */
+void copyFaces(const Layout& layout, const Containers::ArrayView<char> out, const std::size_t begin, const std::size_t end) {
+    const MeshData& triangles = layout.triangles;
+    const std::size_t count = end - begin;
+    const std::size_t indexTypeSize = layout.indexTypeSize;
 
-    /* Copy the indices. For a non-indexed mesh make a trivial index array. */
-    Containers::ArrayView<char> indexData = out.exceptPrefix(header.size() + vertexDataSize);
+    /* For a non-indexed mesh make a trivial index array */
     Containers::StridedArrayView3D<char> indices;
     if(!triangles.isIndexed()) {
-        const Containers::StridedArrayView2D<UnsignedInt> indices32{indexData,
-            reinterpret_cast<UnsignedInt*>(indexData.begin() + 1),
-            {triangles.vertexCount()/3, 3}, {1 + 3*4, 4}};
-        for(std::size_t i = 0; i != indices32.size()[0]; ++i) {
+        const Containers::StridedArrayView2D<UnsignedInt> indices32{out,
+            reinterpret_cast<UnsignedInt*>(out.begin() + 1),
+            {count, 3}, {1 + 3*4, 4}};
+        for(std::size_t i = 0; i != count; ++i) {
             Containers::StridedArrayView1D<UnsignedInt> face = indices32[i];
             for(std::size_t j = 0; j != 3; ++j)
-                face[j] = i*3 + j;
+                face[j] = (begin + i)*3 + j;
         }
 
         indices = Containers::arrayCast<3, char>(indices32);
@@ -311,18 +357,18 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
     /* For an indexed mesh simply copy the data */
     } else {
         const Containers::StridedArrayView3D<const char> src{
-            triangles.indices().asContiguous(),
-            {triangles.indexCount()/3, 3, indexTypeSize},
+            triangles.indices().slice(3*begin, 3*end).asContiguous(),
+            {count, 3, indexTypeSize},
             {std::ptrdiff_t(3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
-        indices = Containers::StridedArrayView3D<char>{indexData,
-            indexData.begin() + 1,
-            {triangles.indexCount()/3, 3, indexTypeSize},
+        indices = Containers::StridedArrayView3D<char>{out,
+            out.begin() + 1,
+            {count, 3, indexTypeSize},
             {std::ptrdiff_t(1 + 3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
         Utility::copy(src, indices);
     }
 
     /* Endian-swap the indices, if needed */
-    if(endianSwapNeeded) {
+    if(layout.endianSwapNeeded) {
         if(indexTypeSize == 4) {
             for(Containers::StridedArrayView1D<UnsignedInt> i: Containers::arrayCast<2, UnsignedInt>(indices).transposed<0, 1>())
                 Utility::Endianness::swapInPlace(i);
@@ -333,26 +379,434 @@ Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertT
     }
 
     /* Fill in face sizes. That's just 3 repeated many times over */
-    {
-        constexpr UnsignedByte three[]{3};
-        Containers::StridedArrayView1D<const UnsignedByte> src = three;
-        Containers::StridedArrayView1D<UnsignedByte> dst;
+    constexpr UnsignedByte three[]{3};
+    Utility::copy(Containers::StridedArrayView1D<const UnsignedByte>{three}.broadcasted<0>(count),
+        Containers::StridedArrayView1D<UnsignedByte>{out,
+            reinterpret_cast<UnsignedByte*>(out.begin()),
+            count, std::ptrdiff_t(1 + 3*indexTypeSize)});
+}
+
+/* std::snprintf() prints the decimal point of the current LC_NUMERIC locale,
+   which would produce an invalid file for example under de_DE. As %g never
+   groups digits of the integer part, whatever is between the integer and the
+   fractional digits is the decimal point, so it gets replaced with a '.'.
+   Returns the new size. */
+std::size_t useDotAsDecimalPoint(char* const buffer, const std::size_t size) {
+    std::size_t i = buffer[0] == '-' ? 1 : 0;
+    const std::size_t integerBegin = i;
+    while(i != size && buffer[i] >= '0' && buffer[i] <= '9') ++i;
+
+    /* No integer digits (inf, nan), no fractional part or just an exponent,
+       or the decimal point already is a '.' */
+    if(i == integerBegin || i == size || buffer[i] == 'e' || buffer[i] == '.')
+        return size;
+
+    /* The locale decimal point can be more than one char in theory */
+    std::size_t fractionBegin = i + 1;
+    while(fractionBegin != size && (buffer[fractionBegin] < '0' || buffer[fractionBegin] > '9'))
+        ++fractionBegin;
+    buffer[i] = '.';
+    std::memmove(buffer + i + 1, buffer + fractionBegin, size - fractionBegin);
+    return size - (fractionBegin - i - 1);
+}
+
+/* The output is meant to be read back exactly, so floats are printed with
+   enough digits for a lossless roundtrip */
+void appendAsciiComponent(Containers::Array<char>& out, const VertexFormat format, const char* const data) {
+    char buffer[32];
+    int size;
+    switch(format) {
+        case VertexFormat::Float: {
+            Float value;
+            std::memcpy(&value, data, sizeof(Float));
+            size = std::snprintf(buffer, sizeof(buffer), "%.9g", Double(value));
+            size = useDotAsDecimalPoint(buffer, size);
+        } break;
+        case VertexFormat::Double: {
+            Double value;
+            std::memcpy(&value, data, sizeof(Double));
+            size = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            size = useDotAsDecimalPoint(buffer, size);
+        } break;
+        case VertexFormat::UnsignedByte:
+        case VertexFormat::UnsignedByteNormalized:
+            size = std::snprintf(buffer, sizeof(buffer), "%u", UnsignedInt(*reinterpret_cast<const UnsignedByte*>(data)));
+            break;
+        case VertexFormat::Byte:
+        case VertexFormat::ByteNormalized:
+            size = std::snprintf(buffer, sizeof(buffer), "%d", Int(*reinterpret_cast<const Byte*>(data)));
+            break;
+        case VertexFormat::UnsignedShort:
+        case VertexFormat::UnsignedShortNormalized: {
+            UnsignedShort value;
+            std::memcpy(&value, data, sizeof(UnsignedShort));
+            size = std::snprintf(buffer, sizeof(buffer), "%u", UnsignedInt(value));
+        } break;
+        case VertexFormat::Short:
+        case VertexFormat::ShortNormalized: {
+            Short value;
+            std::memcpy(&value, data, sizeof(Short));
+            size = std::snprintf(buffer, sizeof(buffer), "%d", Int(value));
+        } break;
+        case VertexFormat::UnsignedInt: {
+            UnsignedInt value;
+            std::memcpy(&value, data, sizeof(UnsignedInt));
+            size = std::snprintf(buffer, sizeof(buffer), "%u", value);
+        } break;
+        case VertexFormat::Int: {
+            Int value;
+            std::memcpy(&value, data, sizeof(Int));
+            size = std::snprintf(buffer, sizeof(buffer), "%d", value);
+        } break;
+        /* Other formats are filtered out in prepareLayout() already */
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    Utility::copy(Containers::ArrayView<const char>{buffer, std::size_t(size)}, arrayAppend(out, NoInit, size));
+}
+
+/* Formats vertices in the [begin, end) range as text lines */
+void formatVertices(const Layout& layout, Containers::Array<char>& out, const std::size_t begin, const std::size_t end) {
+    const MeshData& triangles = layout.triangles;
+
+    /* Fetch the attribute views upfront, not for every vertex again */
+    Containers::Array<Containers::StridedArrayView2D<const char>> attributes{ValueInit, triangles.attributeCount()};
+    for(UnsignedInt j = 0; j != triangles.attributeCount(); ++j)
+        if(layout.offsets[j] != ~std::size_t{})
+            attributes[j] = triangles.attribute(j);
+
+    for(std::size_t i = begin; i != end; ++i) {
+        bool first = true;
+        for(UnsignedInt j = 0; j != triangles.attributeCount(); ++j) {
+            if(layout.offsets[j] == ~std::size_t{}) continue;
+
+            const VertexFormat format = triangles.attributeFormat(j);
+            const VertexFormat componentFormat = vertexFormatComponentFormat(format);
+            const UnsignedInt componentSize = vertexFormatSize(componentFormat);
+            const char* const data = static_cast<const char*>(attributes[j][i].data());
+            for(UnsignedInt k = 0, kMax = vertexFormatComponentCount(format); k != kMax; ++k) {
+                if(!first) arrayAppend(out, ' ');
+                first = false;
+                appendAsciiComponent(out, componentFormat, data + k*componentSize);
+            }
+        }
+        arrayAppend(out, '\n');
+    }
+}
+
+/* Formats faces in the [begin, end) range as text lines */
+void formatFaces(const Layout& layout, Containers::Array<char>& out, const std::size_t begin, const std::size_t end) {
+    const MeshData& triangles = layout.triangles;
+    const Containers::StridedArrayView2D<const char> indices = triangles.isIndexed() ? triangles.indices() : Containers::StridedArrayView2D<const char>{};
+    for(std::size_t i = begin; i != end; ++i) {
+        char buffer[48];
+        int size;
         if(!triangles.isIndexed()) {
-            src = src.broadcasted<0>(triangles.vertexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.vertexCount()/3, 1 + 3*4};
+            size = std::snprintf(buffer, sizeof(buffer), "3 %u %u %u\n",
+                UnsignedInt(i*3 + 0), UnsignedInt(i*3 + 1), UnsignedInt(i*3 + 2));
         } else {
-            src = src.broadcasted<0>(triangles.indexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.indexCount()/3, std::ptrdiff_t(1 + 3*indexTypeSize)};
+            UnsignedInt face[3];
+            for(std::size_t j = 0; j != 3; ++j) {
+                const char* const data = static_cast<const char*>(indices[i*3 + j].data());
+                if(layout.indexTypeSize == 4) {
+                    std::memcpy(face + j, data, 4);
+                } else if(layout.indexTypeSize == 2) {
+                    UnsignedShort index;
+                    std::memcpy(&index, data, 2);
+                    face[j] = index;
+                } else face[j] = *reinterpret_cast<const UnsignedByte*>(data);
+            }
+            size = std::snprintf(buffer, sizeof(buffer), "3 %u %u %u\n",
+                face[0], face[1], face[2]);
         }
-        Utility::copy(src, dst);
+
+        Utility::copy(Containers::ArrayView<const char>{buffer, std::size_t(size)}, arrayAppend(out, NoInit, size));
     }
+}
+
+/* Worker threads kept for the whole conversion, so they don't need to be
+   spawned and joined again for every chunk. run() calls
+   `kernel(begin, end, thread)` on `count` items split into contiguous
+   ranges, one for each thread, with the calling thread processing the first
+   range itself, and returns once all ranges are done. */
+class WorkerPool {
+    public:
+        explicit WorkerPool(const UnsignedInt threadCount): _threadCount{threadCount}, _threads{ValueInit, threadCount - 1} {
+            for(UnsignedInt i = 0; i != _threads.size(); ++i)
+                _threads[i] = std::thread{&WorkerPool::work, this, i + 1};
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _stopped = true;
+            }
+            _condition.notify_all();
+            for(std::thread& thread: _threads)
+                thread.join();
+        }
+
+        UnsignedInt threadCount() const { return _threadCount; }
+
+        template<class Kernel> void run(const std::size_t count, const Kernel& kernel) {
+            if(_threadCount <= 1 || count < _threadCount) {
+                kernel(0, count, 0);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{_mutex};
+                _count = count;
+                _kernel = &kernel;
+                _call = [](const void* data, std::size_t begin, std::size_t end, UnsignedInt thread) {
+                    (*static_cast<const Kernel*>(data))(begin, end, thread);
+                };
+                _pendingCount = _threads.size();
+                ++_generation;
+            }
+            _condition.notify_all();
+
+            runRange(0);
+
+            std::unique_lock<std::mutex> lock{_mutex};
+            _doneCondition.wait(lock, [&]() { return !_pendingCount; });
+        }
+
+    private:
+        void runRange(const UnsignedInt thread) {
+            const std::size_t countPerThread = (_count + _threadCount - 1)/_threadCount;
+            const std::size_t begin = Math::min(thread*countPerThread, _count);
+            const std::size_t end = Math::min(begin + countPerThread, _count);
+            if(begin != end) _call(_kernel, begin, end, thread);
+        }
+
+        void work(const UnsignedInt thread) {
+            std::size_t generation = 0;
+            for(;;) {
+                {
+                    std::unique_lock<std::mutex> lock{_mutex};
+                    _condition.wait(lock, [&]() { return _stopped || _generation != generation; });
+                    if(_stopped) return;
+                    generation = _generation;
+                }
+
+                runRange(thread);
+
+                std::lock_guard<std::mutex> lock{_mutex};
+                if(!--_pendingCount) _doneCondition.notify_one();
+            }
+        }
+
+        UnsignedInt _threadCount;
+        Containers::Array<std::thread> _threads;
+        /* Guards everything below */
+        std::mutex _mutex;
+        std::condition_variable _condition, _doneCondition;
+        std::size_t _count{}, _pendingCount{}, _generation{};
+        const void* _kernel{};
+        void(*_call)(const void*, std::size_t, std::size_t, UnsignedInt){};
+        bool _stopped{};
+};
+
+/* Output either to a file, in which case the data are written through a
+   scratch buffer one chunk at a time, or to a memory. If the total size is
+   known upfront, the memory output is allocated just once and chunks are
+   written directly into it, otherwise it's grown as needed. */
+class Writer {
+    public:
+        explicit Writer(std::FILE* const file): _file{file}, _fixedSize{} {}
+
+        explicit Writer(const std::size_t size): _file{}, _fixedSize{size != ~std::size_t{}} {
+            if(_fixedSize) _data = Containers::Array<char>{NoInit, size};
+        }
+
+        /* Returns a view of the given size that should be filled and then
+           committed via flush() */
+        Containers::ArrayView<char> next(const std::size_t size) {
+            if(_file) {
+                if(_data.size() < size)
+                    _data = Containers::Array<char>{NoInit, size};
+                _pending = size;
+                return _data.prefix(size);
+            }
+
+            if(_fixedSize) {
+                const Containers::ArrayView<char> out = _data.slice(_offset, _offset + size);
+                _offset += size;
+                return out;
+            }
+
+            return arrayAppend(_data, NoInit, size);
+        }
+
+        bool flush() {
+            if(!_file || !_pending) return true;
+            const bool written = std::fwrite(_data.data(), 1, _pending, _file) == _pending;
+            _pending = 0;
+            return written;
+        }
+
+        Containers::Array<char> release() {
+            CORRADE_INTERNAL_ASSERT(!_file);
+            /* Convert a growable array back to a non-growable with the default
+               deleter so we can return it */
+            if(!_fixedSize) arrayShrink(_data);
+            return std::move(_data);
+        }
+
+    private:
+        std::FILE* _file;
+        bool _fixedSize;
+        Containers::Array<char> _data;
+        std::size_t _offset{}, _pending{};
+};
+
+/* Writes the header, vertex and face data from given layout, processing at
+   most `chunkSize` vertices or faces at a time. Returns false if writing to
+   the output fails. */
+bool writeLayout(const Layout& layout, Writer& writer, const std::size_t chunkSize, WorkerPool& pool) {
+    /* Needs an explicit ArrayView constructor, otherwise MSVC 2015, 17 and 19
+       creates ArrayView<const void> here (wtf!) */
+    Utility::copy(Containers::ArrayView<const char>{layout.header.data(), layout.header.size()}, writer.next(layout.header.size()));
+    if(!writer.flush()) return false;
+
+    const std::size_t vertexCount = layout.triangles.vertexCount();
+    const std::size_t faceCount = layout.faceCount;
+
+    /* Text output is formatted into a separate buffer for each thread and
+       the buffers then written in order */
+    if(layout.ascii) {
+        Containers::Array<Containers::Array<char>> texts{ValueInit, pool.threadCount()};
+        const auto writeTexts = [&]() {
+            for(Containers::Array<char>& text: texts) {
+                if(text.isEmpty()) continue;
+                Utility::copy(Containers::ArrayView<const char>{text}, writer.next(text.size()));
+                if(!writer.flush()) return false;
+                arrayResize(text, 0);
+            }
+            return true;
+        };
+
+        for(std::size_t chunk = 0; chunk < vertexCount; chunk += chunkSize) {
+            const std::size_t chunkEnd = Math::min(chunk + chunkSize, vertexCount);
+            pool.run(chunkEnd - chunk, [&](std::size_t begin, std::size_t end, UnsignedInt thread) {
+                formatVertices(layout, texts[thread], chunk + begin, chunk + end);
+            });
+            if(!writeTexts()) return false;
+        }
+
+        for(std::size_t chunk = 0; chunk < faceCount; chunk += chunkSize) {
+            const std::size_t chunkEnd = Math::min(chunk + chunkSize, faceCount);
+            pool.run(chunkEnd - chunk, [&](std::size_t begin, std::size_t end, UnsignedInt thread) {
+                formatFaces(layout, texts[thread], chunk + begin, chunk + end);
+            });
+            if(!writeTexts()) return false;
+        }
+
+    /* Binary output is written directly into the output, each thread
+       filling a disjoint part of it */
+    } else {
+        const std::size_t vertexSize = layout.vertexSize;
+        for(std::size_t chunk = 0; chunk < vertexCount; chunk += chunkSize) {
+            const std::size_t chunkEnd = Math::min(chunk + chunkSize, vertexCount);
+            const Containers::ArrayView<char> out = writer.next((chunkEnd - chunk)*vertexSize);
+            pool.run(chunkEnd - chunk, [&](std::size_t begin, std::size_t end, UnsignedInt) {
+                copyVertices(layout, out.slice(begin*vertexSize, end*vertexSize), chunk + begin, chunk + end);
+            });
+            if(!writer.flush()) return false;
+        }
+
+        const std::size_t faceSize = 1 + 3*layout.indexTypeSize;
+        for(std::size_t chunk = 0; chunk < faceCount; chunk += chunkSize) {
+            const std::size_t chunkEnd = Math::min(chunk + chunkSize, faceCount);
+            const Containers::ArrayView<char> out = writer.next((chunkEnd - chunk)*faceSize);
+            pool.run(chunkEnd - chunk, [&](std::size_t begin, std::size_t end, UnsignedInt) {
+                copyFaces(layout, out.slice(begin*faceSize, end*faceSize), chunk + begin, chunk + end);
+            });
+            if(!writer.flush()) return false;
+        }
+    }
+
+    return true;
+}
+
+bool chunkSizeThreadCount(const Utility::ConfigurationGroup& configuration, const char* const messagePrefix, std::size_t& chunkSize, UnsignedInt& threadCount) {
+    chunkSize = configuration.value<UnsignedInt>("chunkSize");
+    if(!chunkSize) {
+        Error{} << messagePrefix << "expected a non-zero chunkSize";
+        return false;
+    }
+
+    #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    /* Without pthreads there's no way to spawn threads */
+    threadCount = 1;
+    #else
+    threadCount = configuration.value<UnsignedInt>("threads");
+    if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    /* hardware_concurrency() is allowed to return 0 if it can't tell */
+    if(threadCount == 0) threadCount = 1;
+    #endif
+    return true;
+}
+
+}
+
+Containers::Optional<Containers::Array<char>> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
+    constexpr const char* messagePrefix = "Trade::StanfordSceneConverter::convertToData():";
+
+    Layout layout;
+    std::size_t chunkSize;
+    UnsignedInt threadCount;
+    if(!prepareLayout(mesh, configuration(), messagePrefix, layout) ||
+       !chunkSizeThreadCount(configuration(), messagePrefix, chunkSize, threadCount))
+        return {};
+
+    /* Binary output size is known upfront so it can be allocated at once */
+    Writer writer{layout.ascii ? ~std::size_t{} :
+        layout.header.size() +
+        layout.vertexSize*layout.triangles.vertexCount() +
+        (1 + 3*layout.indexTypeSize)*layout.faceCount};
+    WorkerPool pool{threadCount};
+    /* Writing to memory can't fail */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(writeLayout(layout, writer, chunkSize, pool));
 
     /* GCC 4.8 needs extra help here */
-    return Containers::optional(std::move(out));
+    return Containers::optional(writer.release());
+}
+
+bool StanfordSceneConverter::doConvertToFile(const MeshData& mesh, const Containers::StringView filename) {
+    constexpr const char* messagePrefix = "Trade::StanfordSceneConverter::convertToFile():";
+
+    Layout layout;
+    std::size_t chunkSize;
+    UnsignedInt threadCount;
+    if(!prepareLayout(mesh, configuration(), messagePrefix, layout) ||
+       !chunkSizeThreadCount(configuration(), messagePrefix, chunkSize, threadCount))
+        return false;
+
+    std::FILE* const file =
+        #ifndef CORRADE_TARGET_WINDOWS
+        std::fopen(Containers::String::nullTerminatedView(filename).data(), "wb")
+        #else
+        _wfopen(Utility::Unicode::widen(filename), L"wb")
+        #endif
+        ;
+    if(!file) {
+        Error{} << messagePrefix << "can't open" << filename << "for writing";
+        return false;
+    }
+
+    /* The data are written chunk by chunk, so the whole output never needs
+       to be in memory at once */
+    Writer writer{file};
+    WorkerPool pool{threadCount};
+    const bool written = writeLayout(layout, writer, chunkSize, pool);
+    if(std::fclose(file) != 0 || !written) {
+        Error{} << messagePrefix << "can't write to" << filename;
+        return false;
+    }
+
+    return true;
 }
 
 }}
@@ -58,9 +58,9 @@ namespace Magnum { namespace Trade {
 
 @m_keywords{PLY}
 
-Exports meshes to either Little- or Big-Endian binary `*.ply` files with
-triangle faces. You can use @ref StanfordImporter to import files in this
-format.
+Exports meshes to either Little- or Big-Endian binary or ASCII `*.ply` files
+with triangle faces. You can use @ref StanfordImporter to import binary files
+in this format.
 
 @section Trade-StanfordSceneConverter-usage Usage
 
@@ -99,10 +99,24 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 @section Trade-StanfordSceneConverter-behavior Behavior and limitations
 
-Produces binary files, ASCII export is not implemented. The data are by default
+Produces binary files by default, use the @cb{.ini} format @ce
+@ref Trade-StanfordSceneConverter-configuration "configuration option" to
+produce ASCII files instead. Floating-point values in ASCII files are written
+with enough precision for a lossless roundtrip and always with a `.` as a
+decimal point, independently of the current C locale. The binary data are by default
 exported in machine endian, use the @cb{.ini} endianness @ce
-@ref Trade-StanfordImporter-configuration "configuration option" to perform an
-endian swap on the output data.
+@ref Trade-StanfordSceneConverter-configuration "configuration option" to
+perform an endian swap on the output data.
+
+When converting to a file, the vertex and face data are written in chunks of
+@cb{.ini} chunkSize @ce vertices or faces, so the whole output never needs to
+be in memory at once. Copying, endian swapping and face size interleaving of
+each chunk can be additionally spread across multiple threads using the
+@cb{.ini} threads @ce option, with the threads created once for each
+conversion and reused for all chunks. Converting to a file is thus
+preferable to @ref convertToData() for large meshes. On Emscripten builds
+without pthreads the @cb{.ini} threads @ce option is ignored and everything
+is processed on the calling thread.
 
 Exports the following attributes, custom attributes and attributes not listed
 below are skipped with a warning:
@@ -159,6 +173,7 @@ class MAGNUM_STANFORDSCENECONVERTER_EXPORT StanfordSceneConverter: public Abstra
     private:
         MAGNUM_STANFORDSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
         MAGNUM_STANFORDSCENECONVERTER_LOCAL Containers::Optional<Containers::Array<char>> doConvertToData(const MeshData& mesh) override;
+        MAGNUM_STANFORDSCENECONVERTER_LOCAL bool doConvertToFile(const MeshData& mesh, Containers::StringView filename) override;
 };
 
 }}
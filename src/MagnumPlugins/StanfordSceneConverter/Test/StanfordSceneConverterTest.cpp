@@ -23,10 +23,12 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <clocale>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/File.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h> /** @todo remove once Debug is stream-free */
@@ -52,10 +54,18 @@ struct StanfordSceneConverterTest: TestSuite::Tester {
     void indexedTriangleStrip();
     void empty();
 
+    void ascii();
+    void asciiLocale();
+    void chunked();
+    void toFile();
+
     void lines();
     void positionsMissing();
     void twoComponentPositions();
     void invalidEndianness();
+    void invalidFormat();
+    void zeroChunkSize();
+    void toFileCannotOpen();
 
     void ignoredAttributes();
 
@@ -92,6 +102,19 @@ struct {
     {"big endian", "big", "be"}
 };
 
+const struct {
+    const char* name;
+    UnsignedInt chunkSize;
+    UnsignedInt threads;
+} ChunkedData[] {
+    {"", 0, 0},
+    {"small chunks", 5, 1},
+    {"small chunks, multithreaded", 5, 3},
+    {"single-item chunks, multithreaded", 1, 2},
+    {"multithreaded", 0, 4},
+    {"more threads than items", 0, 16}
+};
+
 struct {
     const char* name;
     MeshAttribute attribute;
@@ -119,12 +142,21 @@ StanfordSceneConverterTest::StanfordSceneConverterTest() {
     addTests({&StanfordSceneConverterTest::threeComponentColors,
               &StanfordSceneConverterTest::triangleFan,
               &StanfordSceneConverterTest::indexedTriangleStrip,
-              &StanfordSceneConverterTest::empty,
+              &StanfordSceneConverterTest::empty});
+
+    addInstancedTests({&StanfordSceneConverterTest::ascii,
+                       &StanfordSceneConverterTest::chunked,
+                       &StanfordSceneConverterTest::toFile},
+        Containers::arraySize(ChunkedData));
 
+    addTests({&StanfordSceneConverterTest::asciiLocale,
               &StanfordSceneConverterTest::lines,
               &StanfordSceneConverterTest::positionsMissing,
               &StanfordSceneConverterTest::twoComponentPositions,
-              &StanfordSceneConverterTest::invalidEndianness});
+              &StanfordSceneConverterTest::invalidEndianness,
+              &StanfordSceneConverterTest::invalidFormat,
+              &StanfordSceneConverterTest::zeroChunkSize,
+              &StanfordSceneConverterTest::toFileCannotOpen});
 
     addInstancedTests({&StanfordSceneConverterTest::ignoredAttributes},
         Containers::arraySize(IgnoredAttributesData));
@@ -137,6 +169,9 @@ StanfordSceneConverterTest::StanfordSceneConverterTest() {
     #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(STANFORDIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+
+    /* Create the output directory if it doesn't exist yet */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Path::make(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR));
 }
 
 /* Has to be defined out of class as MSVC 2015 doesn't understand the bitfields
@@ -151,29 +186,27 @@ struct Vertex {
     Vector3b normal;
 };
 
-void StanfordSceneConverterTest::nonIndexedAllAttributes() {
-    auto&& data = NonIndexedAllAttributesData[testCaseInstanceId()];
-    setTestCaseDescription(data.name);
+using namespace Math::Literals;
+
+/* Type includes paddings to verify that those are gone when saving the file.
+   Four triangles in total. */
+const Vertex NonIndexedAllAttributesVertices[] {
+    {{15, 33}, {1.5f, 0.4f, 9.2f}, 0xdeadbeef_rgba, 163247, {15, -100, 0}},
+    {{2762, 90}, {0.3f, -1.1f, 0.1f}, 0xbadcafe_rgba, 13543154, {12, 52, -44}},
+    {{}, {}, {}, 0, {}},
+    {{}, {}, {}, 0, {}},
+    {{}, {}, {}, 0, {}},
+    {{15, 34}, {0.4f, 2.2f, 0.1f}, 0x33005577_rgba, 10, {14, 42, 34}},
+    {{}, {}, {}, 0, {}},
+    {{18, 98}, {1.0f, 2.0f, 3.0f}, 0x77777777_rgba, 168, {0, 78, 24}},
+    {{}, {}, {}, 0, {}},
+    {{}, {}, {}, 0, {}},
+    {{}, {}, {}, 0, {}},
+    {{}, {}, {}, 0, {}}
+};
 
-    using namespace Math::Literals;
-
-    /* Type includes paddings to verify that those are gone when saving the
-       file. Four triangles in total. */
-    const Vertex vertices[] {
-        {{15, 33}, {1.5f, 0.4f, 9.2f}, 0xdeadbeef_rgba, 163247, {15, -100, 0}},
-        {{2762, 90}, {0.3f, -1.1f, 0.1f}, 0xbadcafe_rgba, 13543154, {12, 52, -44}},
-        {{}, {}, {}, 0, {}},
-        {{}, {}, {}, 0, {}},
-        {{}, {}, {}, 0, {}},
-        {{15, 34}, {0.4f, 2.2f, 0.1f}, 0x33005577_rgba, 10, {14, 42, 34}},
-        {{}, {}, {}, 0, {}},
-        {{18, 98}, {1.0f, 2.0f, 3.0f}, 0x77777777_rgba, 168, {0, 78, 24}},
-        {{}, {}, {}, 0, {}},
-        {{}, {}, {}, 0, {}},
-        {{}, {}, {}, 0, {}},
-        {{}, {}, {}, 0, {}}
-    };
-    MeshData mesh{MeshPrimitive::Triangles, {}, vertices, {
+MeshData nonIndexedAllAttributesMesh() {
+    return MeshData{MeshPrimitive::Triangles, {}, NonIndexedAllAttributesVertices, {
         MeshAttributeData{MeshAttribute::TextureCoordinates,
             VertexFormat::Vector2usNormalized,
             offsetof(Vertex, textureCoordinates), 12, sizeof(Vertex)},
@@ -190,6 +223,13 @@ void StanfordSceneConverterTest::nonIndexedAllAttributes() {
             VertexFormat::Vector3bNormalized,
             offsetof(Vertex, normal), 12, sizeof(Vertex)}
     }};
+}
+
+void StanfordSceneConverterTest::nonIndexedAllAttributes() {
+    auto&& data = NonIndexedAllAttributesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    MeshData mesh = nonIndexedAllAttributesMesh();
 
     Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
     if(data.endianness)
@@ -509,6 +549,115 @@ void StanfordSceneConverterTest::empty() {
         TestSuite::Compare::StringToFile);
 }
 
+/* Mesh corresponding to ascii.ply, shared by ascii() and asciiLocale() */
+const struct AsciiVertex {
+    Vector3 position;
+    Vector3b normal;
+} AsciiVertices[] {
+    {{1.5f, 0.4f, -9.25f}, {15, -100, 0}},
+    {{0.3f, -1.1f, 0.1f}, {12, 52, -44}},
+    {{0.0f, 2.0f, 1.0e-5f}, {0, 127, -128}},
+    {{-1.0f, 1.0f, 0.0f}, {1, 2, 3}}
+};
+const UnsignedShort AsciiIndices[] { 0, 1, 2, 0, 2, 3 };
+
+MeshData asciiMesh() {
+    return MeshData{MeshPrimitive::Triangles,
+        {}, AsciiIndices, MeshIndexData{AsciiIndices},
+        {}, AsciiVertices, {
+            MeshAttributeData{MeshAttribute::Position,
+                VertexFormat::Vector3,
+                offsetof(AsciiVertex, position), 4, sizeof(AsciiVertex)},
+            MeshAttributeData{MeshAttribute::Normal,
+                VertexFormat::Vector3bNormalized,
+                offsetof(AsciiVertex, normal), 4, sizeof(AsciiVertex)}
+    }};
+}
+
+void StanfordSceneConverterTest::ascii() {
+    auto&& data = ChunkedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("format", "ascii");
+    /* Endianness should have no effect on the output */
+    converter->configuration().setValue("endianness", "big");
+    if(data.chunkSize)
+        converter->configuration().setValue("chunkSize", data.chunkSize);
+    if(data.threads)
+        converter->configuration().setValue("threads", data.threads);
+
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(asciiMesh());
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, "ascii.ply"),
+        TestSuite::Compare::StringToFile);
+}
+
+void StanfordSceneConverterTest::asciiLocale() {
+    /* Switch to a locale that uses a comma as a decimal separator, if there's
+       any, to verify the output doesn't depend on it */
+    const std::string previousLocale = std::setlocale(LC_NUMERIC, nullptr);
+    const char* locale = nullptr;
+    for(const char* name: {"de_DE.UTF-8", "de_DE.utf8", "cs_CZ.UTF-8", "German_Germany.1252"})
+        if((locale = std::setlocale(LC_NUMERIC, name))) break;
+    if(!locale)
+        CORRADE_INFO("No locale with a comma as a decimal separator available, testing with the default one");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("format", "ascii");
+    converter->configuration().setValue("threads", 2);
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(asciiMesh());
+
+    std::setlocale(LC_NUMERIC, previousLocale.data());
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, "ascii.ply"),
+        TestSuite::Compare::StringToFile);
+}
+
+void StanfordSceneConverterTest::chunked() {
+    auto&& data = ChunkedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("endianness", "big");
+    converter->configuration().setValue("objectIdAttribute", "SEMANTIC");
+    if(data.chunkSize)
+        converter->configuration().setValue("chunkSize", data.chunkSize);
+    if(data.threads)
+        converter->configuration().setValue("threads", data.threads);
+
+    /* Big endian to verify the endian swap is done correctly on all chunks */
+    Containers::Optional<Containers::Array<char>> out = converter->convertToData(nonIndexedAllAttributesMesh());
+    CORRADE_VERIFY(out);
+    /** @todo Compare::DataToFile */
+    CORRADE_COMPARE_AS(Containers::StringView{*out},
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, "nonindexed-all-attributes-be.ply"),
+        TestSuite::Compare::StringToFile);
+}
+
+void StanfordSceneConverterTest::toFile() {
+    auto&& data = ChunkedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("endianness", "little");
+    if(data.chunkSize)
+        converter->configuration().setValue("chunkSize", data.chunkSize);
+    if(data.threads)
+        converter->configuration().setValue("threads", data.threads);
+
+    Containers::String filename = Utility::Path::join(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR, "nonindexed-all-attributes-le.ply");
+    if(Utility::Path::exists(filename))
+        CORRADE_VERIFY(Utility::Path::remove(filename));
+
+    CORRADE_VERIFY(converter->convertToFile(nonIndexedAllAttributesMesh(), filename));
+    CORRADE_COMPARE_AS(filename,
+        Utility::Path::join(STANFORDSCENECONVERTER_TEST_DIR, "nonindexed-all-attributes-le.ply"),
+        TestSuite::Compare::File);
+}
+
 void StanfordSceneConverterTest::lines() {
     Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
 
@@ -557,6 +706,54 @@ void StanfordSceneConverterTest::invalidEndianness() {
         "Trade::StanfordSceneConverter::convertToData(): invalid option endianness=wrong\n");
 }
 
+void StanfordSceneConverterTest::invalidFormat() {
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("format", "text");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(MeshData{MeshPrimitive::Triangles, 0}));
+    CORRADE_COMPARE(out.str(),
+        "Trade::StanfordSceneConverter::convertToData(): invalid option format=text\n");
+}
+
+void StanfordSceneConverterTest::zeroChunkSize() {
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("chunkSize", 0);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::StanfordSceneConverter::convertToData(): expected a non-zero chunkSize\n");
+}
+
+void StanfordSceneConverterTest::toFileCannotOpen() {
+    const Vector3 positions[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterManager.instantiate("StanfordSceneConverter");
+
+    Containers::String filename = Utility::Path::join(STANFORDSCENECONVERTER_TEST_OUTPUT_DIR, "nonexistent/file.ply");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToFile(mesh, filename));
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "Trade::StanfordSceneConverter::convertToFile(): can't open {} for writing\n", filename));
+}
+
 void StanfordSceneConverterTest::ignoredAttributes() {
     auto&& data = IgnoredAttributesData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -25,8 +25,15 @@
 
 #include "StlImporter.h"
 
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StringView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
@@ -38,6 +45,8 @@
 
 namespace Magnum { namespace Trade {
 
+using namespace Containers::Literals;
+
 StlImporter::StlImporter() = default;
 
 StlImporter::StlImporter(PluginManager::AbstractManager& manager, const Containers::StringView& plugin): AbstractImporter{manager, plugin} {}
@@ -56,6 +65,190 @@ namespace {
     constexpr std::ptrdiff_t InputTriangleStride = 12*4 + 2;
 }
 
+namespace {
+
+inline bool isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* Returns the next whitespace-delimited token and advances the input past
+   it. At the end of the input returns an empty view. */
+Containers::StringView nextToken(Containers::StringView& in) {
+    const char* i = in.begin();
+    const char* const end = in.end();
+    while(i != end && isWhitespace(*i)) ++i;
+    const char* const tokenBegin = i;
+    while(i != end && !isWhitespace(*i)) ++i;
+
+    in = Containers::StringView{i, std::size_t(end - i)};
+    return Containers::StringView{tokenBegin, std::size_t(i - tokenBegin)};
+}
+
+/* Skips the rest of the current line, used for solid names */
+void skipLine(Containers::StringView& in) {
+    const char* i = in.begin();
+    const char* const end = in.end();
+    while(i != end && *i != '\n') ++i;
+    in = Containers::StringView{i, std::size_t(end - i)};
+}
+
+bool expectToken(Containers::StringView& in, const Containers::StringView expected) {
+    const Containers::StringView token = nextToken(in);
+    if(token == expected) return true;
+
+    if(token.isEmpty())
+        Error{} << "Trade::StlImporter::openData(): unexpected end of file, expected" << expected;
+    else
+        Error{} << "Trade::StlImporter::openData(): expected" << expected << "but got" << token;
+    return false;
+}
+
+/* Parses a decimal floating-point number with an optional sign, fractional
+   part and exponent, consuming the whole token. Unlike std::strtof() it
+   doesn't depend on the current C locale, which could expect a comma as a
+   decimal separator, and doesn't need a null-terminated input. Up to 18
+   significant digits are taken into account, which is more than enough for
+   a float. */
+bool parseFloat(const Containers::StringView token, Float& out) {
+    const char* i = token.begin();
+    const char* const end = token.end();
+
+    bool negative = false;
+    if(i != end && (*i == '+' || *i == '-'))
+        negative = *i++ == '-';
+
+    UnsignedLong mantissa = 0;
+    Int exponent = 0;
+    bool hasDigits = false;
+    for(; i != end && *i >= '0' && *i <= '9'; ++i) {
+        hasDigits = true;
+        if(mantissa < 100000000000000000ull)
+            mantissa = mantissa*10 + (*i - '0');
+        else ++exponent;
+    }
+    if(i != end && *i == '.') {
+        for(++i; i != end && *i >= '0' && *i <= '9'; ++i) {
+            hasDigits = true;
+            if(mantissa < 100000000000000000ull) {
+                mantissa = mantissa*10 + (*i - '0');
+                --exponent;
+            }
+        }
+    }
+    if(!hasDigits) return false;
+
+    if(i != end && (*i == 'e' || *i == 'E')) {
+        ++i;
+        bool exponentNegative = false;
+        if(i != end && (*i == '+' || *i == '-'))
+            exponentNegative = *i++ == '-';
+        if(i == end || *i < '0' || *i > '9') return false;
+        /* Clamp the exponent so it doesn't overflow, anything this large
+           ends up as zero or infinity anyway */
+        Int value = 0;
+        for(; i != end && *i >= '0' && *i <= '9'; ++i)
+            if(value < 10000) value = value*10 + (*i - '0');
+        exponent += exponentNegative ? -value : value;
+    }
+    if(i != end) return false;
+
+    /* Zero stays zero with any exponent, std::pow() would otherwise give an
+       infinity for large exponents and multiplying it by zero a NaN */
+    if(!mantissa) {
+        out = negative ? -0.0f : 0.0f;
+        return true;
+    }
+
+    /* Calculating in doubles, so there's just a single rounding step when
+       converting to a float for all practical inputs */
+    double value = double(mantissa);
+    if(exponent < 0) value /= std::pow(10.0, -exponent);
+    else if(exponent > 0) value *= std::pow(10.0, exponent);
+    out = Float(negative ? -value : value);
+    return true;
+}
+
+bool expectFloats(Containers::StringView& in, Float* const out, const std::size_t count) {
+    for(std::size_t i = 0; i != count; ++i) {
+        const Containers::StringView token = nextToken(in);
+        if(token.isEmpty()) {
+            Error{} << "Trade::StlImporter::openData(): unexpected end of file, expected a number";
+            return false;
+        }
+
+        if(!parseFloat(token, out[i])) {
+            Error{} << "Trade::StlImporter::openData(): expected a number but got" << token;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Parses an ASCII file into the same layout as a binary file has, so the
+   rest of the importer can treat both the same */
+Containers::Optional<Containers::Array<char>> parseAscii(Containers::StringView in) {
+    Containers::Array<char> out;
+    /* Zero-filled 80-byte header, the triangle count is patched at the end */
+    arrayResize(out, ValueInit, 84);
+
+    UnsignedInt triangleCount = 0;
+    bool inSolid = false;
+    for(;;) {
+        const Containers::StringView token = nextToken(in);
+        if(token.isEmpty()) {
+            if(inSolid) {
+                Error{} << "Trade::StlImporter::openData(): unexpected end of file, expected endsolid";
+                return {};
+            }
+            break;
+        }
+
+        /* The name after solid / endsolid can have spaces, skip it whole */
+        if(token == "solid"_s && !inSolid) {
+            inSolid = true;
+            skipLine(in);
+            continue;
+        }
+        if(token == "endsolid"_s && inSolid) {
+            inSolid = false;
+            skipLine(in);
+            continue;
+        }
+        if(token != "facet"_s || !inSolid) {
+            Error{} << "Trade::StlImporter::openData(): expected" << (inSolid ? "facet or endsolid" : "solid") << "but got" << token;
+            return {};
+        }
+
+        /* Normal followed by three positions, same as in the binary file */
+        Float triangle[12];
+        if(!expectToken(in, "normal"_s) ||
+           !expectFloats(in, triangle, 3) ||
+           !expectToken(in, "outer"_s) ||
+           !expectToken(in, "loop"_s)) return {};
+        for(std::size_t i = 0; i != 3; ++i) {
+            if(!expectToken(in, "vertex"_s) ||
+               !expectFloats(in, triangle + 3 + 3*i, 3)) return {};
+        }
+        if(!expectToken(in, "endloop"_s) ||
+           !expectToken(in, "endfacet"_s)) return {};
+
+        Utility::Endianness::littleEndianInPlace(Containers::arrayView(triangle));
+        arrayAppend(out, Containers::arrayCast<const char>(Containers::arrayView(triangle)));
+        /* Attribute byte count, unused */
+        arrayResize(out, ValueInit, out.size() + 2);
+        ++triangleCount;
+    }
+
+    Utility::Endianness::littleEndianInPlace(triangleCount);
+    std::memcpy(out.data() + 80, &triangleCount, 4);
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(std::move(out));
+}
+
+}
+
 void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dataFlags) {
     /* At this point we can't even check if it's an ASCII or binary file, bail
        out */
@@ -64,8 +257,13 @@ void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
         return;
     }
 
-    if(std::memcmp(data, "solid", 5) == 0) {
-        Error{} << "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry";
+    /* ASCII files start with `solid`. Unfortunately some binary files start
+       with that as well, so if the size matches the triangle count, treat
+       it as binary. */
+    if(std::memcmp(data, "solid", 5) == 0 && (data.size() < 84 ||
+        data.size() != 84 + InputTriangleStride*Utility::Endianness::littleEndian(*reinterpret_cast<const UnsignedInt*>(data + 80))))
+    {
+        _in = parseAscii(Containers::StringView{data, data.size()});
         return;
     }
 
@@ -90,6 +288,171 @@ void StlImporter::doOpenData(Containers::Array<char>&& data, const DataFlags dat
     }
 }
 
+namespace {
+
+/* Blocks until all participating threads reach it. There's no std::barrier
+   in C++11. */
+struct Barrier {
+    explicit Barrier(std::size_t count): count{count} {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock{mutex};
+        const std::size_t currentGeneration = generation;
+        if(++arrived == count) {
+            arrived = 0;
+            ++generation;
+            condition.notify_all();
+        } else condition.wait(lock, [&]{ return generation != currentGeneration; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t count, arrived{}, generation{};
+};
+
+/* Murmur3 finalizer over 32-bit words of the vertex, the stride is always a
+   multiple of four */
+UnsignedInt hashVertex(const char* const data, const std::size_t size) {
+    UnsignedInt hash = 0;
+    for(std::size_t i = 0; i != size; i += 4) {
+        UnsignedInt word;
+        std::memcpy(&word, data + i, 4);
+        hash = (hash ^ word)*0x9e3779b1u;
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+    }
+    return hash;
+}
+
+/* Merges vertices with bitwise identical data, giving the same result as
+   MeshTools::removeDuplicates() --- unique vertices stay in the order of
+   their first occurrence. The vertices are split into one contiguous range
+   per thread and processed in four phases separated by a barrier:
+
+    1.  Each vertex is inserted into an open-addressing hash table shared by
+        all threads. If a bitwise equal vertex is already there, the slot is
+        atomically updated to the lower of the two indices, so after this
+        phase each slot contains the first occurrence independently of the
+        thread scheduling.
+    2.  Each vertex is looked up again to get the index of its first
+        occurrence, and unique vertices in each range are counted.
+    3.  Ranges get assigned output offsets from a prefix sum of the counts,
+        unique vertices are copied to the output and get their new index.
+    4.  Index of the first occurrence of each vertex is replaced with the
+        new index. */
+MeshData weldVertices(const MeshData& mesh, const UnsignedInt threadCount) {
+    const Containers::ArrayView<const char> vertexData = mesh.vertexData();
+    const std::size_t vertexCount = mesh.vertexCount();
+    const std::size_t stride = vertexCount ? vertexData.size()/vertexCount : 0;
+
+    /* Table with at most 50% load, storing index + 1 so zero-initialized
+       slots are empty */
+    std::size_t tableSize = 1;
+    while(tableSize < 2*vertexCount) tableSize <<= 1;
+    const std::size_t tableMask = tableSize - 1;
+    Containers::Array<std::atomic<UnsignedInt>> table{ValueInit, tableSize};
+
+    Containers::Array<char> indexData{NoInit, vertexCount*sizeof(UnsignedInt)};
+    const Containers::ArrayView<UnsignedInt> indices = Containers::arrayCast<UnsignedInt>(indexData);
+    Containers::Array<UnsignedInt> newIndices{NoInit, vertexCount};
+    Containers::Array<std::size_t> uniqueCounts{ValueInit, threadCount};
+    Containers::Array<char> outputVertexData;
+
+    Barrier barrier{threadCount};
+    auto weld = [&](const std::size_t thread) {
+        const std::size_t begin = vertexCount*thread/threadCount;
+        const std::size_t end = vertexCount*(thread + 1)/threadCount;
+
+        /* Phase 1 */
+        for(std::size_t i = begin; i != end; ++i) {
+            const char* const vertex = vertexData.data() + i*stride;
+            for(std::size_t slot = hashVertex(vertex, stride) & tableMask; ; slot = (slot + 1) & tableMask) {
+                UnsignedInt existing = table[slot].load(std::memory_order_acquire);
+                /* If the compare-exchange fails, existing contains what
+                   another thread put there */
+                if(!existing && table[slot].compare_exchange_strong(existing, UnsignedInt(i + 1), std::memory_order_acq_rel))
+                    break;
+                if(std::memcmp(vertexData.data() + (existing - 1)*stride, vertex, stride) != 0)
+                    continue;
+                /* A slot only ever gets replaced with an index of an equal
+                   vertex, so it's enough to retry until it has the lower
+                   index */
+                while(i + 1 < existing && !table[slot].compare_exchange_weak(existing, UnsignedInt(i + 1), std::memory_order_acq_rel)) {}
+                break;
+            }
+        }
+        barrier.wait();
+
+        /* Phase 2 */
+        std::size_t uniqueCount = 0;
+        for(std::size_t i = begin; i != end; ++i) {
+            const char* const vertex = vertexData.data() + i*stride;
+            for(std::size_t slot = hashVertex(vertex, stride) & tableMask; ; slot = (slot + 1) & tableMask) {
+                const UnsignedInt existing = table[slot].load(std::memory_order_relaxed);
+                if(std::memcmp(vertexData.data() + (existing - 1)*stride, vertex, stride) != 0)
+                    continue;
+                indices[i] = existing - 1;
+                if(indices[i] == i) ++uniqueCount;
+                break;
+            }
+        }
+        uniqueCounts[thread] = uniqueCount;
+        barrier.wait();
+
+        /* Phase 3. The first thread allocates the output, others wait for
+           it. */
+        if(thread == 0) {
+            std::size_t totalUniqueCount = 0;
+            for(const std::size_t count: uniqueCounts)
+                totalUniqueCount += count;
+            outputVertexData = Containers::Array<char>{NoInit, totalUniqueCount*stride};
+        }
+        barrier.wait();
+        std::size_t offset = 0;
+        for(std::size_t j = 0; j != thread; ++j)
+            offset += uniqueCounts[j];
+        for(std::size_t i = begin; i != end; ++i) {
+            if(indices[i] != i) continue;
+            std::memcpy(outputVertexData.data() + offset*stride, vertexData.data() + i*stride, stride);
+            newIndices[i] = UnsignedInt(offset++);
+        }
+        barrier.wait();
+
+        /* Phase 4 */
+        for(std::size_t i = begin; i != end; ++i)
+            indices[i] = newIndices[indices[i]];
+    };
+
+    /* The calling thread does the first range */
+    Containers::Array<std::thread> threads{ValueInit, threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{weld, i + 1};
+    weld(0);
+    for(std::thread& thread: threads)
+        thread.join();
+
+    /* Attributes keep their layout, just point to the new data */
+    const std::size_t outputVertexCount = stride ? outputVertexData.size()/stride : 0;
+    Containers::Array<MeshAttributeData> attributeData{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        attributeData[i] = MeshAttributeData{mesh.attributeName(i),
+            mesh.attributeFormat(i),
+            Containers::StridedArrayView1D<const void>{outputVertexData,
+                outputVertexData.data() + mesh.attributeOffset(i),
+                outputVertexCount, mesh.attributeStride(i)}};
+
+    const MeshIndexData indexDataView{indices};
+    return MeshData{mesh.primitive(),
+        std::move(indexData), indexDataView,
+        std::move(outputVertexData), std::move(attributeData),
+        UnsignedInt(outputVertexCount)};
+}
+
+}
+
 UnsignedInt StlImporter::doMeshCount() const { return 1; }
 
 UnsignedInt StlImporter::doMeshLevelCount(UnsignedInt) {
@@ -103,9 +466,43 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
     CORRADE_INTERNAL_ASSERT(!(level == 1 && perFaceToPerVertex));
 
     Containers::ArrayView<const char> in = _in->exceptPrefix(84);
+    const std::size_t triangleCount = in.size()/InputTriangleStride;
+
+    /* Per-face level referencing the triangle records directly, with the
+       normal and three corner positions as separate attributes */
+    if(level == 1 && configuration().value<bool>("zeroCopyFaces")) {
+        /* On Big-Endian the floats need to be swapped, so it's a copy of the
+           records instead, with the same layout */
+        #ifdef CORRADE_TARGET_BIG_ENDIAN
+        Containers::Array<char> vertexData{NoInit, in.size()};
+        Utility::copy(in, vertexData);
+        for(Containers::StridedArrayView1D<Float> component: Containers::StridedArrayView2D<Float>{vertexData,
+            reinterpret_cast<Float*>(vertexData.data()),
+            {triangleCount, 12}, {InputTriangleStride, 4}}.transposed<0, 1>())
+                Utility::Endianness::littleEndianInPlace(component);
+        #else
+        const Containers::ArrayView<const char> vertexData = in;
+        #endif
+
+        Containers::Array<MeshAttributeData> attributeData{4};
+        attributeData[0] = MeshAttributeData{MeshAttribute::Normal,
+            Containers::StridedArrayView1D<const Vector3>{vertexData,
+                reinterpret_cast<const Vector3*>(vertexData.data()),
+                triangleCount, InputTriangleStride}};
+        for(std::size_t i = 0; i != 3; ++i)
+            attributeData[1 + i] = MeshAttributeData{MeshAttribute::Position,
+                Containers::StridedArrayView1D<const Vector3>{vertexData,
+                    reinterpret_cast<const Vector3*>(vertexData.data() + sizeof(Vector3)*(1 + i)),
+                    triangleCount, InputTriangleStride}};
+
+        #ifdef CORRADE_TARGET_BIG_ENDIAN
+        return MeshData{MeshPrimitive::Faces, std::move(vertexData), std::move(attributeData), UnsignedInt(triangleCount)};
+        #else
+        return MeshData{MeshPrimitive::Faces, DataFlags{}, vertexData, std::move(attributeData), UnsignedInt(triangleCount)};
+        #endif
+    }
 
     /* Make 2D views on input normals and positions */
-    const std::size_t triangleCount = in.size()/InputTriangleStride;
     Containers::StridedArrayView2D<const Vector3> inputNormals{in,
         reinterpret_cast<const Vector3*>(in.data() + 0),
         {triangleCount, 1}, {InputTriangleStride, 0}};
@@ -179,8 +576,25 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
     CORRADE_INTERNAL_ASSERT(offset == std::size_t(outputVertexStride));
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
 
-    return MeshData{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
+    MeshData mesh{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
         std::move(vertexData), std::move(attributeData)};
+
+    /* Merge identical vertices, if desired. Per-face normals are unique
+       for every face, so there's nothing to merge. */
+    if(level == 0 && configuration().value<bool>("weldVertices")) {
+        UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+        #if defined(CORRADE_TARGET_EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+        /* Without pthreads there's no way to spawn threads */
+        threadCount = 1;
+        #else
+        if(!threadCount) threadCount = std::thread::hardware_concurrency();
+        if(!threadCount) threadCount = 1;
+        #endif
+        return weldVertices(mesh, threadCount);
+    }
+
+    /* GCC 4.8 needs extra help here */
+    return Containers::optional(std::move(mesh));
 }
 
 }}
@@ -58,7 +58,7 @@ namespace Magnum { namespace Trade {
 @brief STL importer plugin
 @m_since_{plugins,2020,06}
 
-Imports normal and vertex information from binary
+Imports normal and vertex information from binary and ASCII
 [Stereolitography STL](https://en.wikipedia.org/wiki/STL_(file_format))
 (`*.stl`) files.
 
@@ -99,17 +99,47 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 @section Trade-StlImporter-behavior Behavior and limitations
 
-The file is always imported as a non-indexed triangle mesh with per-face
+The file is by default imported as a non-indexed triangle mesh with per-face
 normals (i.e., same normal for all vertices in the triangle). Both positions
 and normals are imported as @ref VertexFormat::Vector3. Using the
-@cb{.ini} perFaceToPerVertex @ce @ref Trade-StanfordImporter-configuration "configuration option"
+@cb{.ini} perFaceToPerVertex @ce @ref Trade-StlImporter-configuration "configuration option"
 it's possible to import per-face normals separately without duplicating them
 for each vertex --- useful for example when you want to deduplicate the
 positions and generate smooth normals from these.
 
-Similarly to @ref StanfordImporter, ASCII files are not supported, only binary.
-The [non-standard extensions for vertex colors](https://en.wikipedia.org/wiki/STL_(file_format)#Color_in_binary_STL)
-are also not supported due to a lack of generally available files for testing.
+If @cb{.ini} perFaceToPerVertex @ce is disabled and the
+@cb{.ini} zeroCopyFaces @ce @ref Trade-StlImporter-configuration "configuration option"
+is enabled, the second level is a @ref MeshPrimitive::Faces mesh containing
+the @ref MeshAttribute::Normal and three @ref MeshAttribute::Position
+attributes, one for each triangle corner. All of them are views directly on
+the 50-byte binary triangle records of the opened file, so importing it
+doesn't allocate or copy any vertex data. The returned @ref MeshData has
+empty @ref MeshData::vertexDataFlags() and references memory owned by the
+importer, so it's valid only until the importer is closed. On Big-Endian
+platforms the records are copied and endian-swapped instead, with the layout
+being the same. Note that the attributes are not aligned to four bytes.
+
+Enabling the @cb{.ini} weldVertices @ce
+@ref Trade-StlImporter-configuration "configuration option" merges vertices
+with bitwise identical data, making the mesh indexed with
+@ref MeshIndexType::UnsignedInt indices. Combined with
+@cb{.ini} perFaceToPerVertex @ce disabled, which leaves just the positions in
+the first level, this gives a mesh with shared positions. The vertices are
+merged through a hash table shared by all threads, with their count
+controlled by the @cb{.ini} threads @ce option. The output is the same as
+from @ref MeshTools::removeDuplicates() regardless of the thread count,
+i.e. unique vertices are kept in the order of their first occurrence. On
+Emscripten builds without pthreads the option is ignored and a single thread
+is used.
+
+Both binary and ASCII files are supported. Since some binary files start with
+`solid` as well, a file is treated as ASCII only if it starts with `solid` and
+its size doesn't match the triangle count stored in the binary header. ASCII
+files are converted to the binary layout on opening. Numbers in ASCII files
+are parsed independently of the current C locale. Solid names are ignored
+and multiple solids in a single file are merged together. The
+[non-standard extensions for vertex colors](https://en.wikipedia.org/wiki/STL_(file_format)#Color_in_binary_STL)
+are not supported due to a lack of generally available files for testing.
 
 @section Trade-StlImporter-configuration Plugin-specific configuration
 
@@ -0,0 +1,139 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020, 2021, 2022 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/String.h>
+#include <Corrade/Containers/StringView.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/Format.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "MagnumPlugins/Implementation/Test/MeshImporterBenchmark.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct StlImporterBenchmark: MeshImporterBenchmark {
+    explicit StlImporterBenchmark();
+
+    Containers::StringView instanceName(std::size_t id) const override;
+    void configure(AbstractImporter& importer, std::size_t id) const override;
+};
+
+const struct {
+    const char* name;
+    bool ascii;
+    bool weldVertices;
+} FileData[]{
+    {"binary", false, false},
+    {"binary, welded vertices", false, true},
+    {"ASCII", true, false}
+};
+
+template<class T> void append(Containers::Array<char>& out, T value) {
+    value = Utility::Endianness::littleEndian(value);
+    arrayAppend(out, Containers::ArrayView<const char>{reinterpret_cast<const char*>(&value), sizeof(T)});
+}
+
+/* A triangle strip expressed as a triangle soup, so every vertex except the
+   first and last two gets shared by three triangles */
+Vector3 stripVertex(UnsignedInt i) {
+    return {Float(i), Float(i%7), Float(i%13)};
+}
+
+Containers::Array<char> generateFile(const UnsignedInt faceCount, const bool ascii) {
+    Containers::Array<char> out;
+
+    if(ascii) {
+        const Containers::StringView begin = "solid benchmark\n";
+        arrayAppend(out, Containers::ArrayView<const char>{begin.data(), begin.size()});
+        for(UnsignedInt i = 0; i != faceCount; ++i) {
+            const Vector3 a = stripVertex(i);
+            const Vector3 b = stripVertex(i + 1);
+            const Vector3 c = stripVertex(i + 2);
+            const Containers::String facet = Utility::format(
+                "facet normal 0 {} {}\n"
+                "  outer loop\n"
+                "    vertex {} {} {}\n"
+                "    vertex {} {} {}\n"
+                "    vertex {} {} {}\n"
+                "  endloop\n"
+                "endfacet\n",
+                i%2, (i + 1)%2,
+                a.x(), a.y(), a.z(),
+                b.x(), b.y(), b.z(),
+                c.x(), c.y(), c.z());
+            arrayAppend(out, Containers::ArrayView<const char>{facet.data(), facet.size()});
+        }
+        const Containers::StringView end = "endsolid benchmark\n";
+        arrayAppend(out, Containers::ArrayView<const char>{end.data(), end.size()});
+
+    } else {
+        /* 80-byte header followed by the triangle count */
+        arrayResize(out, ValueInit, 80);
+        append(out, faceCount);
+        for(UnsignedInt i = 0; i != faceCount; ++i) {
+            append(out, 0.0f);
+            append(out, Float(i%2));
+            append(out, Float((i + 1)%2));
+            for(UnsignedInt j = 0; j != 3; ++j) {
+                const Vector3 position = stripVertex(i + j);
+                append(out, position.x());
+                append(out, position.y());
+                append(out, position.z());
+            }
+            /* Attribute byte count */
+            append(out, UnsignedShort{});
+        }
+    }
+
+    return out;
+}
+
+StlImporterBenchmark::StlImporterBenchmark(): MeshImporterBenchmark{"StlImporter", Containers::arraySize(FileData)} {
+    for(std::size_t i = 0; i != Containers::arraySize(FileData); ++i)
+        _files[i] = generateFile(_faceCount, FileData[i].ascii);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef STLIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STLIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+Containers::StringView StlImporterBenchmark::instanceName(const std::size_t id) const {
+    return FileData[id].name;
+}
+
+void StlImporterBenchmark::configure(AbstractImporter& importer, const std::size_t id) const {
+    importer.configuration().setValue("weldVertices", FileData[id].weldVertices);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::StlImporterBenchmark)
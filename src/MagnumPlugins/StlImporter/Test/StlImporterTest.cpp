@@ -23,6 +23,8 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <clocale>
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/ArrayView.h>
@@ -46,9 +48,14 @@ struct StlImporterTest: TestSuite::Tester {
 
     void invalid();
     void ascii();
+    void asciiNumbers();
+    void asciiInvalid();
     void almostAsciiButNotActually();
+    void binaryStartingWithSolid();
     void emptyBinary();
     void binary();
+    void weldVertices();
+    void zeroCopyFaces();
 
     void openMemory();
     void openTwice();
@@ -99,6 +106,61 @@ const struct {
         "file size doesn't match triangle count, expected 234 but got 235 for 3 triangles"}
 };
 
+const struct {
+    const char* name;
+    const char* data;
+    const char* message;
+} AsciiInvalidData[] {
+    {"no endsolid",
+        "solid a\n",
+        "unexpected end of file, expected endsolid"},
+    {"facet outside of a solid",
+        "solid a\nendsolid a\nfacet",
+        "expected solid but got facet"},
+    {"nested solid",
+        "solid a\nsolid b\n",
+        "expected facet or endsolid but got solid"},
+    {"missing normal",
+        "solid a\nfacet 0 0 1",
+        "expected normal but got 0"},
+    {"invalid number",
+        "solid a\nfacet normal 0 0 1.0f",
+        "expected a number but got 1.0f"},
+    {"comma as a decimal separator",
+        "solid a\nfacet normal 0 0 1,0",
+        "expected a number but got 1,0"},
+    {"exponent without digits",
+        "solid a\nfacet normal 0 0 1e+",
+        "expected a number but got 1e+"},
+    {"too few numbers",
+        "solid a\nfacet normal 0 0",
+        "unexpected end of file, expected a number"},
+    {"too few vertices",
+        "solid a\nfacet normal 0 0 1 outer loop vertex 1 2 3 vertex 4 5 6 endloop",
+        "expected vertex but got endloop"},
+    {"missing endfacet",
+        "solid a\nfacet normal 0 0 1 outer loop vertex 1 2 3 vertex 4 5 6 vertex 7 8 9 endloop",
+        "unexpected end of file, expected endfacet"},
+};
+
+const struct {
+    const char* name;
+    bool perFaceToPerVertex;
+    UnsignedInt threads;
+    UnsignedInt vertexCount;
+    UnsignedInt indices[6];
+} WeldVerticesData[] {
+    /* Normals are different for each triangle, so nothing gets merged */
+    {"", true, 1, 6, {0, 1, 2, 3, 4, 5}},
+    {"per-face normals", false, 1, 4, {0, 1, 2, 0, 2, 3}},
+    /* The output should be the same regardless of how the vertices get
+       split among the threads, including the case of some threads getting
+       no vertices at all */
+    {"3 threads", true, 3, 6, {0, 1, 2, 3, 4, 5}},
+    {"per-face normals, 4 threads", false, 4, 4, {0, 1, 2, 0, 2, 3}},
+    {"per-face normals, 8 threads", false, 8, 4, {0, 1, 2, 0, 2, 3}},
+};
+
 const struct {
     const char* name;
     bool perFaceToPerVertex;
@@ -137,12 +199,23 @@ StlImporterTest::StlImporterTest() {
         Containers::arraySize(InvalidData));
 
     addTests({&StlImporterTest::ascii,
-              &StlImporterTest::almostAsciiButNotActually,
+              &StlImporterTest::asciiNumbers});
+
+    addInstancedTests({&StlImporterTest::asciiInvalid},
+        Containers::arraySize(AsciiInvalidData));
+
+    addTests({&StlImporterTest::almostAsciiButNotActually,
+              &StlImporterTest::binaryStartingWithSolid,
               &StlImporterTest::emptyBinary});
 
     addInstancedTests({&StlImporterTest::binary},
         Containers::arraySize(BinaryData));
 
+    addInstancedTests({&StlImporterTest::weldVertices},
+        Containers::arraySize(WeldVerticesData));
+
+    addTests({&StlImporterTest::zeroCopyFaces});
+
     addInstancedTests({&StlImporterTest::openMemory},
         Containers::arraySize(OpenMemoryData));
 
@@ -170,12 +243,84 @@ void StlImporterTest::invalid() {
 }
 
 void StlImporterTest::ascii() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "ascii.stl")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            { 1.0f, 0.0f, 0.0f},
+            {-1.0f, 0.0f, 0.0f},
+            { 0.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void StlImporterTest::asciiNumbers() {
+    /* Switch to a locale that uses a comma as a decimal separator, if there's
+       any, to verify the parsing doesn't depend on it */
+    const std::string previousLocale = std::setlocale(LC_NUMERIC, nullptr);
+    const char* locale = nullptr;
+    for(const char* name: {"de_DE.UTF-8", "de_DE.utf8", "cs_CZ.UTF-8", "German_Germany.1252"})
+        if((locale = std::setlocale(LC_NUMERIC, name))) break;
+    if(!locale)
+        CORRADE_INFO("No locale with a comma as a decimal separator available, testing with the default one");
+
+    const char data[] =
+        "solid numbers\n"
+        /* Zero with a huge exponent is still zero, not a NaN */
+        "facet normal -0e400 0.0E+999 +1.\n"
+        "outer loop\n"
+        "vertex 1.5 -2.25e1 .125\n"
+        "vertex 1E-2 +3.5e+2 -7.\n"
+        "vertex 0.000001 1234567.875 1e-50\n"
+        "endloop\n"
+        "endfacet\n"
+        "endsolid numbers";
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    const bool opened = importer->openData(Containers::arrayView(data, sizeof(data) - 1));
+    std::setlocale(LC_NUMERIC, previousLocale.data());
+    CORRADE_VERIFY(opened);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -22.5f, 0.125f},
+            {0.01f, 350.0f, -7.0f},
+            {0.000001f, 1234567.875f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void StlImporterTest::asciiInvalid() {
+    auto&& data = AsciiInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
     std::ostringstream out;
     Error redirectError{&out};
-    CORRADE_VERIFY(!importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "ascii.stl")));
-    CORRADE_COMPARE(out.str(), "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry\n");
+    CORRADE_VERIFY(!importer->openData(Containers::arrayView(data.data, std::strlen(data.data))));
+    CORRADE_COMPARE(out.str(),
+        Utility::formatString("Trade::StlImporter::openData(): {}\n", data.message));
 }
 
 void StlImporterTest::almostAsciiButNotActually() {
@@ -202,6 +347,28 @@ void StlImporterTest::almostAsciiButNotActually() {
     CORRADE_COMPARE(mesh->attributeCount(), 2);
 }
 
+void StlImporterTest::binaryStartingWithSolid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    constexpr const char data[]{
+        /* 80-byte header, starting like an ascii file. The size matches the
+           triangle count so it should be treated as binary. */
+        's', 'o', 'l', 'i', 'd', ' ', 'a', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+
+        0, 0, 0, 0, /* No triangles */
+    };
+
+    CORRADE_VERIFY(importer->openData(data));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 0);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+}
+
 void StlImporterTest::emptyBinary() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
@@ -283,6 +450,103 @@ void StlImporterTest::binary() {
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
 }
 
+void StlImporterTest::weldVertices() {
+    auto&& data = WeldVerticesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("weldVertices", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+    importer->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(importer->openFile(Utility::Path::join(STLIMPORTER_TEST_DIR, "weld.stl")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->vertexCount(), data.vertexCount);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(data.indices),
+        TestSuite::Compare::Container);
+
+    /* The welded positions, looked up through the index buffer, should
+       match the original triangle soup */
+    Containers::Array<Vector3> positions = mesh->positions3DAsArray();
+    const Vector3 expected[] {
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f}
+    };
+    for(std::size_t i = 0; i != Containers::arraySize(expected); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(positions[data.indices[i]], expected[i]);
+    }
+
+    /* Per-face normals are not affected */
+    if(!data.perFaceToPerVertex) {
+        Containers::Optional<MeshData> faces = importer->mesh(0, 1);
+        CORRADE_VERIFY(faces);
+        CORRADE_VERIFY(!faces->isIndexed());
+        CORRADE_COMPARE(faces->vertexCount(), 2);
+    }
+}
+
+void StlImporterTest::zeroCopyFaces() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    importer->configuration().setValue("zeroCopyFaces", true);
+
+    /* Open as memory so we can check the data are referenced directly */
+    Containers::Optional<Containers::Array<char>> memory = Utility::Path::read(Utility::Path::join(STLIMPORTER_TEST_DIR, "binary.stl"));
+    CORRADE_VERIFY(memory);
+    CORRADE_VERIFY(importer->openMemory(*memory));
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0, 1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Faces);
+    CORRADE_COMPARE(mesh->vertexCount(), 2);
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Position), 3);
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexData().data(), memory->data() + 84);
+    #endif
+
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Normal), 50);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.1f, 0.2f, 0.3f},
+            {0.4f, 0.5f, 0.6f}
+        }), TestSuite::Compare::Container);
+
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Position, i), 50);
+        CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position, i), VertexFormat::Vector3);
+    }
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f},
+            {1.1f, 2.1f, 3.1f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 1),
+        Containers::arrayView<Vector3>({
+            {4.0f, 5.0f, 6.0f},
+            {4.1f, 5.1f, 6.1f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 2),
+        Containers::arrayView<Vector3>({
+            {7.0f, 8.0f, 9.0f},
+            {7.1f, 8.1f, 9.1f}
+        }), TestSuite::Compare::Container);
+}
+
 void StlImporterTest::openMemory() {
     /* Same as (a subset of) binary() except that it uses openData() &
        openMemory() instead of openFile() to test data copying on import */